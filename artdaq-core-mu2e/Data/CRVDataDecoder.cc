@@ -6,7 +6,7 @@ std::unique_ptr<mu2e::CRVDataDecoder::CRVROCStatusPacket> mu2e::CRVDataDecoder::
 	if (dataPtr == nullptr) return nullptr;
 
 	std::unique_ptr<CRVROCStatusPacket> output(nullptr);
-	output.reset(new CRVROCStatusPacket(*reinterpret_cast<CRVROCStatusPacket const*>(dataPtr->GetData())));
+	output.reset(new CRVROCStatusPacket(DTCLib::LoadAs<CRVROCStatusPacket>(dataPtr->GetData())));
 	return output;
 }
 
@@ -15,8 +15,8 @@ std::vector<mu2e::CRVDataDecoder::CRVHit> mu2e::CRVDataDecoder::GetCRVHits(size_
 	auto dataPtr = dataAtBlockIndex(blockIndex);
 	if (dataPtr == nullptr) return std::vector<CRVHit>();
 
-	auto crvRocHdr = reinterpret_cast<CRVROCStatusPacket const*>(dataPtr->GetData());
-        size_t eventSize = 2*crvRocHdr->ControllerEventWordCount;
+	auto crvRocHdr = DTCLib::LoadAs<CRVROCStatusPacket>(dataPtr->GetData());
+        size_t eventSize = 2*crvRocHdr.ControllerEventWordCount;
         size_t pos = sizeof(CRVROCStatusPacket);
 
         std::vector<mu2e::CRVDataDecoder::CRVHit> output;
@@ -36,9 +36,9 @@ std::vector<mu2e::CRVDataDecoder::CRVHit> mu2e::CRVDataDecoder::GetCRVHits(size_
           {
             std::cerr << "************************************************" << std::endl;
             std::cerr << "Corrupted data in blockIndex " << blockIndex << std::endl;
-            std::cerr << "ROCID " << (uint16_t)crvRocHdr->ControllerID << std::endl;
-            std::cerr << "TriggerCount " << crvRocHdr->TriggerCount << std::endl;
-            std::cerr << "EventWindowTag " << crvRocHdr->GetEventWindowTag() << std::endl;
+            std::cerr << "ROCID " << (uint16_t)crvRocHdr.ControllerID << std::endl;
+            std::cerr << "TriggerCount " << crvRocHdr.TriggerCount << std::endl;
+            std::cerr << "EventWindowTag " << crvRocHdr.GetEventWindowTag() << std::endl;
             std::cerr << "************************************************" << std::endl;
           }
         }
@@ -47,20 +47,20 @@ std::vector<std::pair<mu2e::CalorimeterDataDecoder::CalorimeterHitDataPacket, st
 	// check size of hit data packet
 	static_assert(sizeof(mu2e::CalorimeterDataDecoder::CalorimeterHitDataPacket) % 2 == 0);
 	
-	auto dataPacket = reinterpret_cast<CalorimeterHitDataPacket const*>(dataPtr->GetData());
+	auto dataPacket = DTCLib::LoadAs<CalorimeterHitDataPacket>(dataPtr->GetData());
 	
-	// pos is a uint16_t pointer after the BoardID in the data stream
-	uint16_t const* pos = 0;//assumes this is the first piece of information
+	// pos is a byte pointer to the first hit readout, at the start of the data stream
+	auto pos = reinterpret_cast<uint8_t const*>(dataPtr->GetData());
 
 	// loop over samples:
 	unsigned int count = 0;
-	while(count < dataPacket->NumberOfSamples){
+	while(count < dataPacket.NumberOfSamples){
 	  
-	  // Reinterpret pos as a pointer to a hit readout header
-	  	output->emplace_back(mu2e::CalorimeterDataDecoder::CalorimeterHitDataPacket(*reinterpret_cast<mu2e::CalorimeterDataDecoder::CalorimeterHitDataPacket const*>(pos)), std::vector<uint16_t>()); //Construct and insert element at the end, Converts between types by reinterpreting the underlying bit pattern. 
+	  // Copy the hit readout header at pos (which may not be aligned for CalorimeterHitDataPacket)
+	  	output->emplace_back(DTCLib::LoadAs<mu2e::CalorimeterDataDecoder::CalorimeterHitDataPacket>(pos), std::vector<uint16_t>()); //Construct and insert element at the end
 		
 		// Step pos past the hit readout
-		pos += sizeof(mu2e::CalorimeterDataDecoder::CalorimeterHitDataPacket) / sizeof(uint16_t);
+		pos += sizeof(mu2e::CalorimeterDataDecoder::CalorimeterHitDataPacket);
 
 		// Setup waveform storage
 		// find number of samples from output
@@ -72,7 +72,7 @@ std::vector<std::pair<mu2e::CalorimeterDataDecoder::CalorimeterHitDataPacket, st
 		memcpy(output->back().second.data(), pos, sizeof(uint16_t) * nSamples);
 
 		// Step pos past waveform
-		pos += nSamples;
+		pos += sizeof(uint16_t) * nSamples;
 		count++;
 	}
 	return output;
@@ -87,23 +87,24 @@ std::vector<std::pair<mu2e::CalorimeterDataDecoder::CalorimeterHitDataPacket, ui
 
 	static_assert(sizeof(CalorimeterHitDataPacket) % 2 == 0);
 
-	auto dataPacket = reinterpret_cast<mu2e::CalorimeterDataDecoder::CalorimeterHitDataPacket const*>(dataPtr->GetData());
+	auto dataPacket = DTCLib::LoadAs<mu2e::CalorimeterDataDecoder::CalorimeterHitDataPacket>(dataPtr->GetData());
 	
-	uint16_t const* pos = 0;
+	auto pos = reinterpret_cast<uint8_t const*>(dataPtr->GetData());
 
 	// loop over samples:
 	unsigned int count = 0;
-	while(count < dataPacket->NumberOfSamples){
-		// Reinterpret pos as a pointer to a hit readout header
-		output.emplace_back(mu2e::CalorimeterDataDecoder::CalorimeterHitDataPacket(*reinterpret_cast<CalorimeterHitDataPacket const*>(pos)), 0);
+	while(count < dataPacket.NumberOfSamples){
+		// Copy the hit readout header at pos
+		output.emplace_back(DTCLib::LoadAs<CalorimeterHitDataPacket>(pos), 0);
 		// Step pos past the hit readout
-		pos += sizeof(mu2e::CalorimeterDataDecoder::CalorimeterHitDataPacket) / sizeof(uint16_t);
+		pos += sizeof(mu2e::CalorimeterDataDecoder::CalorimeterHitDataPacket);
 
-		output.back().second = *(pos + output.back().first.IndexOfMaxDigitizerSample);
+		output.back().second = DTCLib::LoadLE<uint16_t>(pos + sizeof(uint16_t) * output.back().first.IndexOfMaxDigitizerSample);
 
 		// Step pos past waveform
 		auto nSamples = output.back().first.NumberOfSamples;
-		pos += nSamples;
+		pos += sizeof(uint16_t) * nSamples;
+		count++;
 	}
 	return output;
 }
@@ -0,0 +1,166 @@
+#include "artdaq-core-mu2e/Data/DRPLatencyMonitor.hh"
+
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_LinkStatus.h"
+
+#include "TRACE/tracemf.h"
+#define TRACE_NAME "DRPLatencyMonitor"
+
+#include <algorithm>
+#include <cmath>
+
+mu2e::DRPLatencyMonitor::DRPLatencyMonitor(Config const& config, std::function<void(StepChange const&)> onStep)
+	: config_(config), onStep_(std::move(onStep)), dtcs_(NUM_DTCS)
+{
+	config_.linkMask &= 0x3F;
+	config_.baselineWeight = std::clamp(config_.baselineWeight, 1e-6, 1.0);
+	config_.warmupSamples = std::max(config_.warmupSamples, uint64_t(1));
+}
+
+mu2e::DRPLatencyMonitor::~DRPLatencyMonitor() = default;
+
+bool mu2e::DRPLatencyMonitor::detect(StepDetector& detector, double value, StepChange& step) const
+{
+	if (detector.samples < config_.warmupSamples)
+	{
+		// Learn the baseline from a running mean and variance
+		++detector.samples;
+		auto delta = value - detector.mean;
+		detector.mean += delta / detector.samples;
+		detector.variance += (delta * (value - detector.mean) - detector.variance) / detector.samples;
+		return false;
+	}
+
+	auto rms = std::max(std::sqrt(detector.variance), config_.minRMS);
+	auto z = (value - detector.mean) / rms;
+
+	if (detector.sumHigh == 0)
+	{
+		detector.levelHigh = 0;
+		detector.countHigh = 0;
+	}
+	if (detector.sumLow == 0)
+	{
+		detector.levelLow = 0;
+		detector.countLow = 0;
+	}
+	detector.sumHigh = std::max(0.0, detector.sumHigh + z - config_.slack);
+	detector.sumLow = std::max(0.0, detector.sumLow - z - config_.slack);
+	detector.levelHigh += value;
+	++detector.countHigh;
+	detector.levelLow += value;
+	++detector.countLow;
+
+	if (detector.sumHigh > config_.threshold || detector.sumLow > config_.threshold)
+	{
+		step.before = detector.mean;
+		step.after = detector.sumHigh > config_.threshold ? detector.levelHigh / detector.countHigh : detector.levelLow / detector.countLow;
+		detector = StepDetector();
+		return true;
+	}
+
+	auto delta = value - detector.mean;
+	detector.mean += config_.baselineWeight * delta;
+	detector.variance = (1 - config_.baselineWeight) * (detector.variance + config_.baselineWeight * delta * delta);
+	return false;
+}
+
+void mu2e::DRPLatencyMonitor::add(DTCLib::DTC_SubEventHeader const& header)
+{
+	auto subsystem = static_cast<uint8_t>(header.source_subsystem & 0x7);
+	auto dtcID = static_cast<uint8_t>(header.source_dtc_id);
+	auto& dtc = dtcs_[(static_cast<size_t>(subsystem) << 8) | dtcID];
+	if (!dtc)
+	{
+		TLOG(TLVL_DEBUG) << "First sub-event from subsystem " << static_cast<int>(subsystem) << " DTC " << static_cast<int>(dtcID);
+		dtc.reset(new DTCLatencies());
+	}
+
+	const uint16_t latency[NUM_LINKS] = {static_cast<uint16_t>(header.link0_drp_rx_latency), static_cast<uint16_t>(header.link1_drp_rx_latency), static_cast<uint16_t>(header.link2_drp_rx_latency),
+										 static_cast<uint16_t>(header.link3_drp_rx_latency), static_cast<uint16_t>(header.link4_drp_rx_latency), static_cast<uint16_t>(header.link5_drp_rx_latency)};
+	const uint8_t status[NUM_LINKS] = {static_cast<uint8_t>(header.link0_status), static_cast<uint8_t>(header.link1_status), static_cast<uint8_t>(header.link2_status),
+									   static_cast<uint8_t>(header.link3_status), static_cast<uint8_t>(header.link4_status), static_cast<uint8_t>(header.link5_status)};
+	for (size_t ii = 0; ii < NUM_LINKS; ++ii)
+	{
+		if ((config_.linkMask & (1 << ii)) == 0) continue;
+		if (DTCLib::DTC_LinkStatus(status[ii]).flags[static_cast<size_t>(DTCLib::DTC_LinkStatus::Flags::kROCTimeoutError)]) continue;
+
+		auto& link = dtc->links[ii];
+		link.histogram.record(latency[ii]);
+
+		StepChange step;
+		if (detect(link.detector, latency[ii], step))
+		{
+			++link.steps;
+			step.subsystem = static_cast<DTCLib::DTC_Subsystem>(subsystem);
+			step.dtcID = dtcID;
+			step.link = static_cast<uint8_t>(ii);
+			step.eventWindowTag = header.event_tag_low + (static_cast<uint64_t>(header.event_tag_high) << 32);
+			TLOG(TLVL_WARNING) << "DRP RX latency step on subsystem " << static_cast<int>(subsystem) << " DTC " << static_cast<int>(dtcID) << " link " << ii
+							   << " at EWT " << step.eventWindowTag << ": " << step.before << " -> " << step.after;
+			if (onStep_) onStep_(step);
+		}
+	}
+}
+
+void mu2e::DRPLatencyMonitor::add(DTCLib::DTC_Event const& event)
+{
+	for (auto& subEvent : event.GetSubEvents())
+	{
+		add(*subEvent.GetHeader());
+	}
+}
+
+void mu2e::DRPLatencyMonitor::merge(DRPLatencyMonitor const& other)
+{
+	for (size_t ii = 0; ii < NUM_DTCS; ++ii)
+	{
+		if (!other.dtcs_[ii]) continue;
+		if (!dtcs_[ii]) dtcs_[ii].reset(new DTCLatencies());
+		for (size_t jj = 0; jj < NUM_LINKS; ++jj)
+		{
+			dtcs_[ii]->links[jj].histogram.merge(other.dtcs_[ii]->links[jj].histogram);
+			dtcs_[ii]->links[jj].steps += other.dtcs_[ii]->links[jj].steps;
+		}
+	}
+}
+
+mu2e::DRPLatencyHistogram const* mu2e::DRPLatencyMonitor::histogram(DTCLib::DTC_Subsystem subsystem, uint8_t dtcID, uint8_t link) const
+{
+	auto& dtc = dtcs_[(static_cast<size_t>(subsystem & 0x7) << 8) | dtcID];
+	if (!dtc || link >= NUM_LINKS) return nullptr;
+	return &dtc->links[link].histogram;
+}
+
+std::vector<mu2e::DRPLatencyMonitor::LinkSummary> mu2e::DRPLatencyMonitor::summary() const
+{
+	std::vector<LinkSummary> output;
+	for (size_t ii = 0; ii < NUM_DTCS; ++ii)
+	{
+		if (!dtcs_[ii]) continue;
+		for (size_t jj = 0; jj < NUM_LINKS; ++jj)
+		{
+			if ((config_.linkMask & (1 << jj)) == 0) continue;
+			auto& link = dtcs_[ii]->links[jj];
+			LinkSummary entry;
+			entry.subsystem = static_cast<DTCLib::DTC_Subsystem>(ii >> 8);
+			entry.dtcID = static_cast<uint8_t>(ii & 0xFF);
+			entry.link = static_cast<uint8_t>(jj);
+			entry.count = link.histogram.count();
+			entry.mean = link.histogram.mean();
+			entry.p50 = static_cast<uint16_t>(link.histogram.quantile(0.5));
+			entry.p99 = static_cast<uint16_t>(link.histogram.quantile(0.99));
+			entry.max = static_cast<uint16_t>(link.histogram.max());
+			entry.steps = link.steps;
+			output.push_back(entry);
+		}
+	}
+	return output;
+}
+
+void mu2e::DRPLatencyMonitor::reset()
+{
+	for (auto& dtc : dtcs_)
+	{
+		if (dtc) *dtc = DTCLatencies();
+	}
+}
@@ -0,0 +1,132 @@
+#ifndef ARTDAQ_CORE_MU2E_DATA_DRPLATENCYMONITOR_HH
+#define ARTDAQ_CORE_MU2E_DATA_DRPLATENCYMONITOR_HH
+
+#include "artdaq-core-mu2e/Data/LogLinearHistogram.hh"
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_Event.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Streaming quantiles and step detection of the per-link DRP RX latencies of the DTC sub-event headers.
+//
+// Notes:
+//  1) Latencies are recorded in a LogLinearHistogram, so quantiles are within 1/32 of the true value, recording
+//     does not allocate, and two histograms merge by adding their buckets.
+//  2) DRPLatencyMonitor keeps one histogram and one step detector per DTC and link. It is not thread safe:
+//     each thread fills its own monitor, and monitors are combined with merge() for reporting. The only
+//     allocation is the histograms of a DTC, on its first sub-event.
+//  3) Step changes are detected with a two-sided CUSUM of the latency, normalized to an exponentially weighted
+//     baseline mean and RMS. When either sum exceeds the threshold, the step is reported with the baseline
+//     mean and the mean of the samples since the sum last left zero (the new level), and the baseline is
+//     learned again from the following samples. Detectors are not merged, only their step counts.
+//  4) Links reporting a ROC timeout in their linkN_status have no latency and are not recorded.
+
+namespace mu2e {
+
+// 384 buckets cover the 16-bit latency range
+typedef LogLinearHistogram<16> DRPLatencyHistogram;
+
+class DRPLatencyMonitor
+{
+public:
+	static constexpr size_t NUM_LINKS = 6;
+
+	struct Config
+	{
+		uint8_t linkMask = 0x3F;               // Links to monitor, bit N for link N
+		double baselineWeight = 1.0 / 256;     // Weight of a new sample in the baseline mean and RMS
+		uint64_t warmupSamples = 256;          // Samples averaged into the baseline before detection starts
+		double slack = 0.5;                    // CUSUM allowance, in baseline RMS
+		double threshold = 12;                 // CUSUM alarm level, in baseline RMS (about 10^6 samples between false alarms)
+		double minRMS = 1;                     // Floor of the baseline RMS, as latencies are integers
+	};
+
+	struct StepChange
+	{
+		DTCLib::DTC_Subsystem subsystem;
+		uint8_t dtcID;
+		uint8_t link;
+		uint64_t eventWindowTag;  // EWT of the sub-event which raised the alarm
+		double before;            // Baseline mean latency
+		double after;             // Mean latency since the change started
+	};
+
+	struct LinkSummary
+	{
+		DTCLib::DTC_Subsystem subsystem;
+		uint8_t dtcID;
+		uint8_t link;
+		uint64_t count;
+		double mean;
+		uint16_t p50;
+		uint16_t p99;
+		uint16_t max;
+		uint64_t steps;
+	};
+
+	// onStep is called, from the thread calling add(), with each step change detected
+	explicit DRPLatencyMonitor(Config const& config, std::function<void(StepChange const&)> onStep = nullptr);
+	DRPLatencyMonitor()
+		: DRPLatencyMonitor(Config()) {}
+	~DRPLatencyMonitor();
+
+	DRPLatencyMonitor(DRPLatencyMonitor const&) = delete;
+	DRPLatencyMonitor& operator=(DRPLatencyMonitor const&) = delete;
+
+	void add(DTCLib::DTC_SubEventHeader const& header);
+	void add(DTCLib::DTC_SubEvent const& subEvent) { add(*subEvent.GetHeader()); }
+	void add(DTCLib::DTC_Event const& event);
+
+	// Add the histograms and step counts of another monitor to this one
+	void merge(DRPLatencyMonitor const& other);
+
+	// Histogram of a link, nullptr if the DTC has not been seen
+	DRPLatencyHistogram const* histogram(DTCLib::DTC_Subsystem subsystem, uint8_t dtcID, uint8_t link) const;
+	// Quantiles of every monitored link of the DTCs seen so far, ordered by subsystem, DTC ID and link
+	std::vector<LinkSummary> summary() const;
+
+	// Clear histograms, detectors and step counts
+	void reset();
+
+private:
+	static constexpr size_t NUM_DTCS = 8 << 8;  // Indexed by (subsystem << 8) | DTC ID
+
+	struct StepDetector
+	{
+		uint64_t samples = 0;
+		double mean = 0;
+		double variance = 0;
+		double sumHigh = 0;
+		double sumLow = 0;
+		double levelHigh = 0;  // Sum and count of the samples since sumHigh (sumLow) left zero
+		double levelLow = 0;
+		uint64_t countHigh = 0;
+		uint64_t countLow = 0;
+	};
+
+	struct LinkLatency
+	{
+		DRPLatencyHistogram histogram;
+		StepDetector detector;
+		uint64_t steps = 0;
+	};
+
+	struct DTCLatencies
+	{
+		std::array<LinkLatency, NUM_LINKS> links;
+	};
+
+	// Returns true and fills step if the sample completes a step change
+	bool detect(StepDetector& detector, double value, StepChange& step) const;
+
+	Config config_;
+	std::function<void(StepChange const&)> onStep_;
+	std::vector<std::unique_ptr<DTCLatencies>> dtcs_;
+};
+
+}  // namespace mu2e
+
+#endif  // ARTDAQ_CORE_MU2E_DATA_DRPLATENCYMONITOR_HH
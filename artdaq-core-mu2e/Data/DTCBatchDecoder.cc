@@ -0,0 +1,311 @@
+#include "artdaq-core-mu2e/Data/DTCBatchDecoder.hh"
+
+#include "artdaq-core-mu2e/Data/DTCHitStream.hh"
+#include "artdaq-core-mu2e/Overlays/DTCEventFragment.hh"
+#include "artdaq-core-mu2e/Overlays/FragmentType.hh"
+
+#include "TRACE/tracemf.h"
+#define TRACE_NAME "DTCBatchDecoder"
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+namespace {
+
+void append(mu2e::TrackerHitView const& hit, mu2e::DTCBatchDecoder::BlockTag const& tag, bool readWaveforms, mu2e::DTCBatchDecoder::Batch& out)
+{
+	auto& batch = out.tracker;
+	batch.hits.push_back({tag, hit.packet, static_cast<uint32_t>(batch.waveforms.size()), 0});
+	if (readWaveforms)
+	{
+		auto size = hit.waveformSize();
+		batch.waveforms.resize(batch.waveforms.size() + size);
+		hit.decodeWaveform(batch.waveforms.data() + batch.hits.back().waveformOffset);
+		batch.hits.back().waveformSize = size;
+	}
+}
+
+void append(mu2e::CalorimeterHitView const& hit, mu2e::DTCBatchDecoder::BlockTag const& tag, bool readWaveforms, mu2e::DTCBatchDecoder::Batch& out)
+{
+	auto& batch = out.calorimeter;
+	batch.hits.push_back({tag, hit.packet, static_cast<uint32_t>(batch.waveforms.size()), 0});
+	if (readWaveforms)
+	{
+		auto size = hit.waveformSize();
+		batch.waveforms.resize(batch.waveforms.size() + size);
+		hit.decodeWaveform(batch.waveforms.data() + batch.hits.back().waveformOffset);
+		batch.hits.back().waveformSize = size;
+	}
+}
+
+void append(mu2e::CRVHitView const& hit, mu2e::DTCBatchDecoder::BlockTag const& tag, bool readWaveforms, mu2e::DTCBatchDecoder::Batch& out)
+{
+	auto& batch = out.crv;
+	batch.hits.push_back({tag, hit.info, static_cast<uint32_t>(batch.waveforms.size()), 0});
+	if (readWaveforms)
+	{
+		auto size = hit.waveformSize();
+		batch.waveforms.resize(batch.waveforms.size() + size);
+		hit.decodeWaveform(batch.waveforms.data() + batch.hits.back().waveformOffset);
+		batch.hits.back().waveformSize = size;
+	}
+}
+
+// Decode one DataBlock, or for a split tracker DataBlock the packets [firstPacket, endPacket) (0: to the end)
+template <typename Parser>
+void decodeBlock(DTCLib::DTC_DataBlock const& block, DTCLib::DTC_DataHeaderPacket const& hdr, mu2e::DTCHitSource const& source, size_t firstPacket, size_t endPacket,
+				 mu2e::DTCBatchDecoder::BlockTag const& tag, bool readWaveforms, mu2e::DTCBatchDecoder::Batch& out)
+{
+	Parser parser;
+	parser.begin(block, hdr, source);
+	if constexpr (std::is_same_v<Parser, mu2e::TrackerHitParser>)
+	{
+		if (firstPacket > 0 || endPacket > 0) parser.seek(firstPacket, endPacket > 0 ? endPacket : hdr.GetPacketCount());
+	}
+	if constexpr (std::is_same_v<Parser, mu2e::CRVHitParser>)
+	{
+		if (parser.hasStatus()) out.crv.rocStatus.push_back({tag, parser.status()});
+	}
+	typename Parser::value_type hit;
+	while (parser.next(hit)) append(hit, tag, readWaveforms, out);
+	if (parser.corrupt()) ++out.corruptBlocks;
+}
+
+template <typename Hit, typename Sample, typename Range>
+void appendHits(std::vector<Hit>& hits, std::vector<Sample>& waveforms, std::vector<Hit> const& inHits, std::vector<Sample> const& inWaveforms, Range const& range)
+{
+	auto offset = static_cast<int64_t>(waveforms.size()) - static_cast<int64_t>(range.waveformsBegin);
+	auto first = hits.size();
+	hits.insert(hits.end(), inHits.begin() + range.hitsBegin, inHits.begin() + range.hitsEnd);
+	for (auto ii = first; ii < hits.size(); ++ii) hits[ii].waveformOffset = static_cast<uint32_t>(hits[ii].waveformOffset + offset);
+	waveforms.insert(waveforms.end(), inWaveforms.begin() + range.waveformsBegin, inWaveforms.begin() + range.waveformsEnd);
+}
+
+}  // namespace
+
+mu2e::DTCBatchDecoder::Batch mu2e::DTCBatchDecoder::decode(artdaq::Fragments const& frags, Options const& options)
+{
+	std::vector<artdaq::Fragment const*> ptrs;
+	ptrs.reserve(frags.size());
+	for (auto& frag : frags) ptrs.push_back(&frag);
+	return decode(ptrs, options);
+}
+
+mu2e::DTCBatchDecoder::Batch mu2e::DTCBatchDecoder::decode(std::vector<artdaq::Fragment const*> const& frags, Options const& options)
+{
+	// Plan: set up the DTC_Events and cut their DataBlocks into pieces, costed by their byte count
+	std::vector<std::unique_ptr<DTCEventFragment>> overlays(frags.size());
+	std::vector<BlockPiece> pieces;
+	for (size_t ii = 0; ii < frags.size(); ++ii)
+	{
+		if (frags[ii]->type() != FragmentType::DTCEVT)
+		{
+			TLOG(TLVL_DEBUG + 5) << "Skipping Fragment " << ii << " of type " << static_cast<int>(frags[ii]->type());
+			continue;
+		}
+		overlays[ii].reset(new DTCEventFragment(*frags[ii]));
+		for (size_t jj = 0; jj < overlays[ii]->eventCount(); ++jj)
+		{
+			auto& event = overlays[ii]->getEvent(jj);
+			for (size_t kk = 0; kk < event.GetSubEventCount(); ++kk)
+			{
+				auto subEvent = event.GetSubEvent(kk);
+				for (size_t bb = 0; bb < subEvent->GetDataBlockCount(); ++bb)
+				{
+					BlockPiece piece{static_cast<uint32_t>(ii), static_cast<uint32_t>(jj), static_cast<uint32_t>(kk), static_cast<uint32_t>(bb), 0, 0, subEvent, subEvent->GetDataBlock(bb)->byteSize + PIECE_OVERHEAD_BYTES};
+					splitBlock(piece, options.taskBytes, pieces);
+				}
+			}
+		}
+	}
+
+	// Group consecutive pieces into tasks of about taskBytes
+	std::vector<Task> tasks;
+	size_t totalBytes = 0;
+	for (size_t ii = 0; ii < pieces.size(); ++ii)
+	{
+		if (tasks.empty() || tasks.back().bytes >= options.taskBytes) tasks.push_back(Task{ii, ii, 0, {}});
+		tasks.back().endPiece = ii + 1;
+		tasks.back().bytes += pieces[ii].bytes;
+		totalBytes += pieces[ii].bytes;
+	}
+
+	size_t threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+	threads = std::min({threads, totalBytes / std::max<size_t>(1, options.minBytesPerThread), tasks.size()});
+	threads = std::max<size_t>(1, threads);
+
+	// Deal contiguous runs of tasks of about equal bytes to the threads
+	std::unique_ptr<TaskQueue[]> queues(new TaskQueue[threads]);
+	size_t bytes = 0;
+	size_t queue = 0;
+	for (size_t ii = 0; ii < tasks.size(); ++ii)
+	{
+		while (queue + 1 < threads && bytes >= totalBytes * (queue + 1) / threads)
+		{
+			queues[queue].end = ii;
+			queues[++queue].begin = ii;
+		}
+		bytes += tasks[ii].bytes;
+	}
+	queues[queue].end = tasks.size();
+	for (size_t ii = queue + 1; ii < threads; ++ii) queues[ii].begin = queues[ii].end = tasks.size();
+
+	// Decode: each thread works through its own queue from the front, then steals single tasks from the back of
+	// the others
+	std::vector<Batch> batches(threads);
+	std::vector<std::exception_ptr> errors(threads);
+	auto work = [&](size_t self) {
+		try
+		{
+			size_t task;
+			while (takeTask(queues.get(), threads, self, task))
+			{
+				runTask(pieces, tasks[task], self, options.readWaveforms, batches[self]);
+			}
+		}
+		catch (...)
+		{
+			errors[self] = std::current_exception();
+			// Stop handing out the remaining tasks of this thread; the exception is rethrown after the join
+			std::lock_guard<std::mutex> lk(queues[self].mutex);
+			queues[self].begin = queues[self].end;
+		}
+	};
+	std::vector<std::thread> workers;
+	for (size_t ii = 1; ii < threads; ++ii) workers.emplace_back(work, ii);
+	work(0);
+	for (auto& worker : workers) worker.join();
+	for (auto& error : errors)
+	{
+		if (error) std::rethrow_exception(error);
+	}
+
+	// Merge: copy the output of each task in task order, so that the result does not depend on which thread ran it
+	if (threads == 1) return std::move(batches[0]);
+	Batch output;
+	for (auto& task : tasks) appendTask(output, batches[task.output.thread], task.output);
+	return output;
+}
+
+void mu2e::DTCBatchDecoder::splitBlock(BlockPiece const& block, size_t taskBytes, std::vector<BlockPiece>& pieces)
+{
+	auto& dataBlock = *block.subEvent->GetDataBlock(block.blockIndex);
+	if (block.bytes <= taskBytes || dataBlock.byteSize <= 16)
+	{
+		pieces.push_back(block);
+		return;
+	}
+	DTCLib::DTC_DataHeaderPacket hdr{DTCLib::DTC_DataPacket(dataBlock.blockPointer)};
+	if (!TrackerHitParser::accepts(hdr) || hdr.GetVersion() == 0)
+	{
+		pieces.push_back(block);
+		return;
+	}
+
+	// Split a large tracker DataBlock at hit boundaries, into pieces of about taskBytes
+	TrackerHitParser parser;
+	parser.begin(dataBlock, hdr, DTCHitSource());
+	TrackerHitView hit;
+	size_t pieceBytes = std::max<size_t>(16, taskBytes);
+	size_t start = 0;
+	while (parser.next(hit))
+	{
+		if ((parser.position() - start) * 16 >= pieceBytes)
+		{
+			pieces.push_back(block);
+			pieces.back().firstPacket = start;
+			pieces.back().endPacket = parser.position();
+			pieces.back().bytes = (parser.position() - start) * 16 + PIECE_OVERHEAD_BYTES;
+			start = parser.position();
+		}
+	}
+	pieces.push_back(block);
+	pieces.back().firstPacket = start;
+	pieces.back().endPacket = 0;  // To the end of the DataBlock
+	pieces.back().bytes = dataBlock.byteSize > 16 + start * 16 ? dataBlock.byteSize - 16 - start * 16 + PIECE_OVERHEAD_BYTES : PIECE_OVERHEAD_BYTES;
+}
+
+bool mu2e::DTCBatchDecoder::takeTask(TaskQueue* queues, size_t threads, size_t self, size_t& task)
+{
+	{
+		std::lock_guard<std::mutex> lk(queues[self].mutex);
+		if (queues[self].begin < queues[self].end)
+		{
+			task = queues[self].begin++;
+			return true;
+		}
+	}
+	for (size_t ii = 1; ii < threads; ++ii)
+	{
+		auto& victim = queues[(self + ii) % threads];
+		std::lock_guard<std::mutex> lk(victim.mutex);
+		if (victim.begin < victim.end)
+		{
+			task = --victim.end;
+			return true;
+		}
+	}
+	return false;
+}
+
+void mu2e::DTCBatchDecoder::runTask(std::vector<BlockPiece> const& pieces, Task& task, size_t thread, bool readWaveforms, Batch& out)
+{
+	auto& range = task.output;
+	range.thread = thread;
+	range.tracker = {out.tracker.hits.size(), out.tracker.waveforms.size(), 0, 0};
+	range.calorimeter = {out.calorimeter.hits.size(), out.calorimeter.waveforms.size(), 0, 0};
+	range.crv = {out.crv.hits.size(), out.crv.waveforms.size(), 0, 0};
+	range.crvStatusBegin = out.crv.rocStatus.size();
+	auto skipped = out.skippedBlocks;
+	auto corrupt = out.corruptBlocks;
+
+	for (size_t ii = task.firstPiece; ii < task.endPiece; ++ii)
+	{
+		auto& piece = pieces[ii];
+		auto& block = *piece.subEvent->GetDataBlock(piece.blockIndex);
+		if (block.byteSize <= 16) continue;
+		DTCLib::DTC_DataHeaderPacket hdr{DTCLib::DTC_DataPacket(block.blockPointer)};
+		BlockTag tag{piece.fragmentIndex, piece.eventIndex, piece.subEvent->GetDTCID(), static_cast<uint8_t>(hdr.GetLinkID())};
+		DTCHitSource source{tag.dtcID, tag.link, static_cast<uint16_t>(piece.blockIndex), piece.subEventIndex};
+
+		if (TrackerHitParser::accepts(hdr))
+		{
+			decodeBlock<TrackerHitParser>(block, hdr, source, piece.firstPacket, piece.endPacket, tag, readWaveforms, out);
+		}
+		else if (CalorimeterHitParser::accepts(hdr))
+		{
+			decodeBlock<CalorimeterHitParser>(block, hdr, source, 0, 0, tag, readWaveforms, out);
+		}
+		else if (CRVHitParser::accepts(hdr))
+		{
+			decodeBlock<CRVHitParser>(block, hdr, source, 0, 0, tag, readWaveforms, out);
+		}
+		else
+		{
+			++out.skippedBlocks;
+		}
+	}
+
+	range.tracker.hitsEnd = out.tracker.hits.size();
+	range.tracker.waveformsEnd = out.tracker.waveforms.size();
+	range.calorimeter.hitsEnd = out.calorimeter.hits.size();
+	range.calorimeter.waveformsEnd = out.calorimeter.waveforms.size();
+	range.crv.hitsEnd = out.crv.hits.size();
+	range.crv.waveformsEnd = out.crv.waveforms.size();
+	range.crvStatusEnd = out.crv.rocStatus.size();
+	range.skippedBlocks = out.skippedBlocks - skipped;
+	range.corruptBlocks = out.corruptBlocks - corrupt;
+}
+
+void mu2e::DTCBatchDecoder::appendTask(Batch& out, Batch const& in, TaskOutput const& range)
+{
+	appendHits(out.tracker.hits, out.tracker.waveforms, in.tracker.hits, in.tracker.waveforms, range.tracker);
+	appendHits(out.calorimeter.hits, out.calorimeter.waveforms, in.calorimeter.hits, in.calorimeter.waveforms, range.calorimeter);
+	appendHits(out.crv.hits, out.crv.waveforms, in.crv.hits, in.crv.waveforms, range.crv);
+	out.crv.rocStatus.insert(out.crv.rocStatus.end(), in.crv.rocStatus.begin() + range.crvStatusBegin, in.crv.rocStatus.begin() + range.crvStatusEnd);
+	out.skippedBlocks += range.skippedBlocks;
+	out.corruptBlocks += range.corruptBlocks;
+}
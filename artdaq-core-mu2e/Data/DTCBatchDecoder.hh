@@ -0,0 +1,183 @@
+#ifndef ARTDAQ_CORE_MU2E_DATA_DTCBATCHDECODER_HH
+#define ARTDAQ_CORE_MU2E_DATA_DTCBATCHDECODER_HH
+
+#include "artdaq-core-mu2e/Data/CRVDataDecoder.hh"
+#include "artdaq-core-mu2e/Data/CalorimeterDataDecoder.hh"
+#include "artdaq-core-mu2e/Data/TrackerDataDecoder.hh"
+
+#include "artdaq-core/Data/Fragment.hh"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Decodes the tracker, calorimeter and CRV DataBlocks of many DTCEVT Fragments in one call, into one batch per
+// subsystem.
+//
+// Notes:
+//  1) Each hit is tagged with the index of its Fragment in the input, the index of the DTC_Event within the
+//     Fragment (non-zero only for batched Fragments, see DTCEventFragment::packEvents), and the DTC and link it
+//     came from. Hits are in input order: by Fragment, event, sub-event, DataBlock.
+//  2) Waveforms are not stored per hit, but appended to one sample vector per batch; each hit holds the offset
+//     and length of its samples. Decoding does not allocate per hit.
+//  3) The work is split over threads by byte volume. The DTC_Events are set up first, and their DataBlocks are
+//     costed by byte count (from the DataBlock header) and grouped into tasks of about taskBytes; tracker
+//     DataBlocks larger than that are split at hit boundaries. Each thread starts on a contiguous run of tasks
+//     of about equal bytes and, once done, steals tasks from the back of the other threads' runs. Threads decode
+//     into their own batches, which are merged in task order at the end, so the result does not depend on the
+//     number of threads or on which thread ran which task.
+//  4) Fragments which are not of type DTCEVT are skipped. DataBlocks of other subsystems, and of formats the
+//     single-sub-event decoders do not handle, are counted in skippedBlocks. Hits which do not fit in their
+//     DataBlock are dropped and the DataBlock is counted in corruptBlocks.
+//  5) Calorimeter DataBlocks are read as a sequence of CalorimeterHitDataPacket, each followed by its
+//     NumberOfSamples ADC samples, up to the end of the DataBlock or the first hit with no samples.
+
+namespace mu2e {
+
+class DTCBatchDecoder
+{
+public:
+	struct Options
+	{
+		size_t threads = 0;                 // Maximum number of threads, 0 for std::thread::hardware_concurrency
+		size_t minBytesPerThread = 1 << 20;  // Do not start threads for less data than this
+		size_t taskBytes = 64 << 10;         // Target size of a decode task
+		bool readWaveforms = true;          // Decode the ADC samples of each hit
+	};
+
+	// Origin of a hit
+	struct BlockTag
+	{
+		uint32_t fragmentIndex;  // Index of the Fragment in the input
+		uint32_t eventIndex;     // Index of the DTC_Event in the Fragment
+		uint8_t dtcID;           // Source DTC of the sub-event
+		uint8_t link;            // Link (ROC) of the DataBlock
+	};
+
+	struct TrackerHit
+	{
+		BlockTag tag;
+		TrackerDataDecoder::TrackerDataPacket packet;  // Format version 0 packets are upgraded
+		uint32_t waveformOffset;                       // Index of the first sample in TrackerBatch::waveforms
+		uint32_t waveformSize;                         // Number of samples
+	};
+
+	struct CalorimeterHit
+	{
+		BlockTag tag;
+		CalorimeterDataDecoder::CalorimeterHitDataPacket packet;
+		uint32_t waveformOffset;  // Index of the first sample in CalorimeterBatch::waveforms
+		uint32_t waveformSize;    // Number of samples
+	};
+
+	struct CRVROCStatus
+	{
+		BlockTag tag;
+		CRVDataDecoder::CRVROCStatusPacket packet;
+	};
+
+	struct CRVHit
+	{
+		BlockTag tag;
+		CRVDataDecoder::CRVHitInfo info;
+		uint32_t waveformOffset;  // Index of the first sample in CRVBatch::waveforms
+		uint32_t waveformSize;    // Number of samples
+	};
+
+	struct TrackerBatch
+	{
+		std::vector<TrackerHit> hits;
+		std::vector<uint16_t> waveforms;
+	};
+
+	struct CalorimeterBatch
+	{
+		std::vector<CalorimeterHit> hits;
+		std::vector<uint16_t> waveforms;
+	};
+
+	struct CRVBatch
+	{
+		std::vector<CRVROCStatus> rocStatus;  // One per DataBlock
+		std::vector<CRVHit> hits;
+		std::vector<CRVDataDecoder::CRVHitWaveformSample> waveforms;
+	};
+
+	struct Batch
+	{
+		TrackerBatch tracker;
+		CalorimeterBatch calorimeter;
+		CRVBatch crv;
+		uint64_t skippedBlocks = 0;  // DataBlocks of other subsystems or unknown formats
+		uint64_t corruptBlocks = 0;  // DataBlocks whose hits overran the DataBlock
+	};
+
+	// Decode all DataBlocks of the DTCEVT Fragments in frags. Exceptions thrown while setting up a DTC_Event
+	// (e.g. DTC_WrongPacketSizeException for a corrupt Fragment) are rethrown to the caller.
+	static Batch decode(artdaq::Fragments const& frags, Options const& options);
+	static Batch decode(std::vector<artdaq::Fragment const*> const& frags, Options const& options);
+	static Batch decode(artdaq::Fragments const& frags) { return decode(frags, Options()); }
+	static Batch decode(std::vector<artdaq::Fragment const*> const& frags) { return decode(frags, Options()); }
+
+private:
+	static constexpr size_t PIECE_OVERHEAD_BYTES = 64;  // Fixed cost of decoding a DataBlock, in bytes
+
+	// A DataBlock, or the packets [firstPacket, endPacket) of a split tracker DataBlock (endPacket 0: to the end)
+	struct BlockPiece
+	{
+		uint32_t fragmentIndex;
+		uint32_t eventIndex;
+		uint32_t subEventIndex;
+		uint32_t blockIndex;
+		uint32_t firstPacket;
+		uint32_t endPacket;
+		DTCLib::DTC_SubEvent const* subEvent;
+		size_t bytes;
+	};
+
+	// Hits and samples written by one task into the batch of its thread
+	struct HitRange
+	{
+		size_t hitsBegin;
+		size_t waveformsBegin;
+		size_t hitsEnd;
+		size_t waveformsEnd;
+	};
+
+	struct TaskOutput
+	{
+		size_t thread;
+		HitRange tracker;
+		HitRange calorimeter;
+		HitRange crv;
+		size_t crvStatusBegin;
+		size_t crvStatusEnd;
+		uint64_t skippedBlocks;
+		uint64_t corruptBlocks;
+	};
+
+	struct Task
+	{
+		size_t firstPiece;
+		size_t endPiece;
+		size_t bytes;
+		TaskOutput output;
+	};
+
+	// Tasks [begin, end) not yet taken. The owner takes from the front, other threads steal from the back.
+	struct TaskQueue
+	{
+		std::mutex mutex;
+		size_t begin = 0;
+		size_t end = 0;
+	};
+
+	static void splitBlock(BlockPiece const& block, size_t taskBytes, std::vector<BlockPiece>& pieces);
+	static bool takeTask(TaskQueue* queues, size_t threads, size_t self, size_t& task);
+	static void runTask(std::vector<BlockPiece> const& pieces, Task& task, size_t thread, bool readWaveforms, Batch& out);
+	static void appendTask(Batch& out, Batch const& in, TaskOutput const& range);
+};
+
+}  // namespace mu2e
+
+#endif  // ARTDAQ_CORE_MU2E_DATA_DTCBATCHDECODER_HH
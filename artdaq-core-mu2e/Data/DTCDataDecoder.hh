@@ -5,12 +5,16 @@
 #include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_SubEventHeader.h"
 #include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_SubEvent.h"
 #include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_DataBlock.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_BitExtract.h"
 
+#include <atomic>
 #include <iostream>
+#include <mutex>
 #include <vector>
 
 // Implementation of "DTCDataDecoder", an artdaq::Fragment overlay class
 // May contain multiple DataBlocks from the same ROC
+// The DTC_SubEvent is set up on first use; const access from several threads is safe
 
 namespace mu2e {
 struct DTCDataDecoder;
@@ -28,6 +32,24 @@ struct mu2e::DTCDataDecoder
 		: data_(data) {
 	}
 
+	// Copies share no state with the original: the DTC_SubEvent is set up again over the copied data
+	DTCDataDecoder(DTCDataDecoder const& other)
+		: data_(other.data_) {}
+	DTCDataDecoder(DTCDataDecoder&& other)
+		: data_(std::move(other.data_)) {}
+	DTCDataDecoder& operator=(DTCDataDecoder const& other)
+	{
+		data_ = other.data_;
+		setup_.store(false, std::memory_order_relaxed);
+		return *this;
+	}
+	DTCDataDecoder& operator=(DTCDataDecoder&& other)
+	{
+		data_ = std::move(other.data_);
+		setup_.store(false, std::memory_order_relaxed);
+		return *this;
+	}
+
 	explicit DTCDataDecoder(DTCLib::DTC_SubEvent const &se)
 	{
 		data_ = std::vector<uint8_t>(se.GetSubEventByteCount());
@@ -39,28 +61,28 @@ struct mu2e::DTCDataDecoder
 			offset += bl.byteSize;
 		}
 		
-		auto ptr = data_.data();
-		event_ = DTCLib::DTC_SubEvent(ptr);	
-                event_.SetupSubEvent();
-		setup_ = true;
+		setup_event();
 	}
 
 	void setup_event() const {
+		if (setup_.load(std::memory_order_acquire)) return;
+		std::lock_guard<std::mutex> lk(setup_mutex_);
+		if (setup_.load(std::memory_order_relaxed)) return;
 		auto ptr = data_.data();
 		event_ = DTCLib::DTC_SubEvent(ptr);	
                 event_.SetupSubEvent();
-		setup_ = true;
+		setup_.store(true, std::memory_order_release);
 		}
 
 	// const getter functions for the data in the header
 	size_t block_count() const {
-	  if (!setup_) {setup_event();}
+	  setup_event();
 	  return event_.GetDataBlockCount(); }
 
 	// Return size of block at given DataBlock index
 	size_t blockSizeBytes(size_t blockIndex) const
 	{
-		if (!setup_) setup_event();
+		setup_event();
 		if (blockIndex > block_count())
 		{
 			return 0;
@@ -72,23 +94,24 @@ struct mu2e::DTCDataDecoder
 	// Return pointer to beginning of DataBlock at given DataBlock index
 	DTCLib::DTC_DataBlock const *dataAtBlockIndex(size_t blockIndex) const
 	{
-		if (!setup_) setup_event();
+		setup_event();
 		if (blockIndex > block_count()) return nullptr;
 		return event_.GetDataBlock(blockIndex);
 	}
 
 	void printPacketAtByte(size_t blockIndex, size_t byteIdx) const
 	{
-		if (!setup_) setup_event();
-		auto dataPtr = reinterpret_cast<uint16_t const *>(reinterpret_cast<uint8_t const *>(dataAtBlockIndex(blockIndex)->GetData()) + byteIdx);
+		setup_event();
+		auto dataPtr = reinterpret_cast<uint8_t const *>(dataAtBlockIndex(blockIndex)->GetData()) + byteIdx;
 		std::cout << "\t\t"
 				  << "Packet Bits (128): " << std::endl;
 		for (int adcIdx = 0; adcIdx < 8; adcIdx++)
 		{
 			std::cout << "\t";
+			auto word = DTCLib::LoadLE<uint16_t>(dataPtr + 2 * adcIdx);
 			for (int offset = 15; offset >= 0; offset--)
 			{
-				if (((*(dataPtr + adcIdx)) & (1 << offset)) != 0)
+				if ((word & (1 << offset)) != 0)
 				{
 					std::cout << "1";
 				}
@@ -110,7 +133,8 @@ struct mu2e::DTCDataDecoder
 		return;
 	}
 	
-	mutable bool setup_{false};
+	mutable std::atomic<bool> setup_{false};  // event_ is set up; published with release ordering
+	mutable std::mutex setup_mutex_;
 	std::vector<uint8_t> data_;
 
 	mutable DTCLib::DTC_SubEvent event_;  //! presume transient
@@ -0,0 +1,131 @@
+#include "artdaq-core-mu2e/Data/DTCHitStream.hh"
+
+#include "TRACE/tracemf.h"
+#define TRACE_NAME "DTCHitStream"
+
+#include <algorithm>
+
+void mu2e::TrackerHitParser::begin(DTCLib::DTC_DataBlock const& block, DTCLib::DTC_DataHeaderPacket const& hdr, DTCHitSource const& source)
+{
+	data_ = reinterpret_cast<const uint8_t*>(block.GetData());
+	packets_ = std::min<size_t>(hdr.GetPacketCount(), (block.byteSize - 16) / 16);
+	processed_ = 0;
+	version_ = hdr.GetVersion();
+	corrupt_ = false;
+	source_ = source;
+
+	// One TrackerDataPacketV0 per DataBlock, as in TrackerDataDecoder::GetTrackerData
+	if (version_ == 0 && packets_ * 16 < sizeof(TrackerDataDecoder::TrackerDataPacketV0))
+	{
+		corrupt_ = true;
+		packets_ = 0;
+	}
+}
+
+bool mu2e::TrackerHitParser::next(value_type& hit)
+{
+	if (processed_ >= packets_) return false;
+	auto raw = data_ + processed_ * 16;
+	hit.source = source_;
+	hit.version = version_;
+	hit.raw = raw;
+
+	if (version_ == 0)
+	{
+		hit.packet = TrackerDataDecoder::UpgradePacket(reinterpret_cast<TrackerDataDecoder::TrackerDataPacketV0 const*>(raw));
+		processed_ = packets_;
+		return true;
+	}
+
+	// TrackerDataPacket and TrackerADCPacket are both 16 bytes
+	memcpy(&hit.packet, raw, sizeof(hit.packet));
+	size_t nPackets = 1 + hit.packet.NumADCPackets;
+	if (processed_ + nPackets > packets_)
+	{
+		corrupt_ = true;
+		processed_ = packets_;
+		return false;
+	}
+	processed_ += nPackets;
+	return true;
+}
+
+void mu2e::CalorimeterHitParser::begin(DTCLib::DTC_DataBlock const& block, DTCLib::DTC_DataHeaderPacket const&, DTCHitSource const& source)
+{
+	data_ = reinterpret_cast<const uint8_t*>(block.GetData());
+	size_ = block.byteSize - 16;
+	pos_ = 0;
+	corrupt_ = false;
+	source_ = source;
+}
+
+bool mu2e::CalorimeterHitParser::next(value_type& hit)
+{
+	// Hits are a CalorimeterHitDataPacket followed by NumberOfSamples ADC samples; a hit with no samples ends the block
+	if (pos_ + sizeof(hit.packet) > size_) return false;
+	memcpy(&hit.packet, data_ + pos_, sizeof(hit.packet));
+	size_t samplesBytes = hit.packet.NumberOfSamples * sizeof(uint16_t);
+	if (hit.packet.NumberOfSamples == 0)
+	{
+		pos_ = size_;
+		return false;
+	}
+	if (pos_ + sizeof(hit.packet) + samplesBytes > size_)
+	{
+		corrupt_ = true;
+		pos_ = size_;
+		return false;
+	}
+	hit.source = source_;
+	hit.samples = data_ + pos_ + sizeof(hit.packet);
+	pos_ += sizeof(hit.packet) + samplesBytes;
+	return true;
+}
+
+void mu2e::CRVHitParser::begin(DTCLib::DTC_DataBlock const& block, DTCLib::DTC_DataHeaderPacket const&, DTCHitSource const& source)
+{
+	data_ = reinterpret_cast<const uint8_t*>(block.GetData());
+	size_ = block.byteSize - 16;
+	pos_ = sizeof(CRVDataDecoder::CRVROCStatusPacket);
+	corrupt_ = false;
+	source_ = source;
+
+	hasStatus_ = size_ >= sizeof(status_);
+	if (!hasStatus_)
+	{
+		corrupt_ = true;
+		size_ = 0;
+		return;
+	}
+	memcpy(&status_, data_, sizeof(status_));
+	size_t eventSize = 2 * status_.ControllerEventWordCount;
+	if (eventSize > size_)
+	{
+		corrupt_ = true;
+	}
+	else
+	{
+		size_ = eventSize;
+	}
+}
+
+bool mu2e::CRVHitParser::next(value_type& hit)
+{
+	// Same layout as CRVDataDecoder::GetCRVHits
+	if (pos_ + sizeof(hit.info) > size_) return false;
+	memcpy(&hit.info, data_ + pos_, sizeof(hit.info));
+	size_t samplesBytes = hit.info.NumSamples * sizeof(CRVDataDecoder::CRVHitWaveformSample);
+	if (pos_ + sizeof(hit.info) + samplesBytes > size_)
+	{
+		TLOG(TLVL_ERROR) << "Corrupted CRV DataBlock from DTC " << static_cast<int>(source_.dtcID) << " link " << static_cast<int>(source_.link)
+						 << ", ROC " << static_cast<int>(status_.ControllerID) << ", EventWindowTag " << status_.GetEventWindowTag();
+		corrupt_ = true;
+		pos_ = size_;
+		return false;
+	}
+	hit.source = source_;
+	hit.status = status_;
+	hit.samples = data_ + pos_ + sizeof(hit.info);
+	pos_ += sizeof(hit.info) + samplesBytes;
+	return true;
+}
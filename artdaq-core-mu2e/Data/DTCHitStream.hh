@@ -0,0 +1,290 @@
+#ifndef ARTDAQ_CORE_MU2E_DATA_DTCHITSTREAM_HH
+#define ARTDAQ_CORE_MU2E_DATA_DTCHITSTREAM_HH
+
+#include "artdaq-core-mu2e/Data/CRVDataDecoder.hh"
+#include "artdaq-core-mu2e/Data/CalorimeterDataDecoder.hh"
+#include "artdaq-core-mu2e/Data/TrackerDataDecoder.hh"
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_Event.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+// Lazy streams of the tracker, calorimeter and CRV hits of a DTC_Event.
+//
+// Notes:
+//  1) TrackerHitStream, CalorimeterHitStream and CRVHitStream are input ranges over a DTC_Event: each increment
+//     decodes the next hit in place, walking the sub-events of the subsystem, their DataBlocks and the packets
+//     of each DataBlock. Nothing is materialized, so a loop which breaks early only decodes the hits it saw.
+//     Waveforms are decoded only on request, from the hit view.
+//  2) Hit views refer to the memory of the DTC_Event, which must outlive them. Packet headers are copied into the
+//     view (they are at most 24 bytes), so views stay valid after the iterator moves on.
+//  3) The per-DataBlock parsers (TrackerHitParser etc.) follow the layouts of the single-sub-event decoders and
+//     are shared with DTCBatchDecoder. A DataBlock whose hits overrun it is cut short and flagged as corrupt.
+//  4) This is the C++17 equivalent of a generator; the package does not build with C++20 coroutines.
+
+namespace mu2e {
+
+// Origin of a hit within the DTC_Event
+struct DTCHitSource
+{
+	uint8_t dtcID;         // Source DTC of the sub-event
+	uint8_t link;          // Link (ROC) of the DataBlock
+	uint16_t blockIndex;   // Index of the DataBlock in the sub-event
+	size_t subEventIndex;  // Index of the sub-event in the DTC_Event
+};
+
+struct TrackerHitView
+{
+	DTCHitSource source;
+	TrackerDataDecoder::TrackerDataPacket packet;  // Format version 0 packets are upgraded
+	uint8_t version;                               // Format version of the DataBlock
+	const void* raw;                               // Packet in the DataBlock
+
+	size_t waveformSize() const { return version == 0 ? TrackerDataDecoder::WaveformSizeV0 : TrackerDataDecoder::WaveformSize(&packet); }
+	void decodeWaveform(uint16_t* output) const  // waveformSize() samples
+	{
+		if (version == 0)
+			TrackerDataDecoder::DecodeWaveformV0(static_cast<TrackerDataDecoder::TrackerDataPacketV0 const*>(raw), output);
+		else
+			TrackerDataDecoder::DecodeWaveform(static_cast<TrackerDataDecoder::TrackerDataPacket const*>(raw), output);
+	}
+	std::vector<uint16_t> waveform() const
+	{
+		std::vector<uint16_t> output(waveformSize());
+		decodeWaveform(output.data());
+		return output;
+	}
+};
+
+struct CalorimeterHitView
+{
+	DTCHitSource source;
+	CalorimeterDataDecoder::CalorimeterHitDataPacket packet;
+	const uint8_t* samples;  // NumberOfSamples ADC samples, not necessarily aligned
+
+	size_t waveformSize() const { return packet.NumberOfSamples; }
+	uint16_t sample(size_t index) const
+	{
+		uint16_t output;
+		memcpy(&output, samples + index * sizeof(uint16_t), sizeof(output));
+		return output;
+	}
+	void decodeWaveform(uint16_t* output) const { memcpy(output, samples, waveformSize() * sizeof(uint16_t)); }
+	std::vector<uint16_t> waveform() const
+	{
+		std::vector<uint16_t> output(waveformSize());
+		decodeWaveform(output.data());
+		return output;
+	}
+};
+
+struct CRVHitView
+{
+	DTCHitSource source;
+	CRVDataDecoder::CRVROCStatusPacket status;  // ROC status packet of the DataBlock
+	CRVDataDecoder::CRVHitInfo info;
+	const uint8_t* samples;  // NumSamples waveform samples, not necessarily aligned
+
+	size_t waveformSize() const { return info.NumSamples; }
+	CRVDataDecoder::CRVHitWaveformSample sample(size_t index) const
+	{
+		CRVDataDecoder::CRVHitWaveformSample output;
+		memcpy(&output, samples + index * sizeof(output), sizeof(output));
+		return output;
+	}
+	void decodeWaveform(CRVDataDecoder::CRVHitWaveformSample* output) const { memcpy(static_cast<void*>(output), samples, waveformSize() * sizeof(*output)); }
+	CRVDataDecoder::CRVHitWaveform waveform() const
+	{
+		CRVDataDecoder::CRVHitWaveform output(waveformSize());
+		decodeWaveform(output.data());
+		return output;
+	}
+};
+
+// Walks the hits of one DataBlock. Usage: accepts(header), then begin(block, header, source), then next(hit)
+// until it returns false.
+class TrackerHitParser
+{
+public:
+	using value_type = TrackerHitView;
+	static constexpr DTCLib::DTC_Subsystem subsystem = DTCLib::DTC_Subsystem_Tracker;
+
+	static bool accepts(DTCLib::DTC_DataHeaderPacket const& hdr) { return hdr.GetSubsystem() == subsystem && hdr.GetVersion() <= 1; }
+	void begin(DTCLib::DTC_DataBlock const& block, DTCLib::DTC_DataHeaderPacket const& hdr, DTCHitSource const& source);
+	bool next(value_type& hit);
+	bool corrupt() const { return corrupt_; }
+
+	// Packets of the DataBlock consumed so far; after next() returns true, this is the start of the next hit
+	size_t position() const { return processed_; }
+	// After begin, restrict the parser to the packets [firstPacket, endPacket), where firstPacket is the start of
+	// a hit (as returned by position()). Used to split large DataBlocks.
+	void seek(size_t firstPacket, size_t endPacket)
+	{
+		processed_ = firstPacket;
+		if (endPacket < packets_) packets_ = endPacket;
+	}
+
+private:
+	const uint8_t* data_{nullptr};
+	size_t packets_{0};
+	size_t processed_{0};
+	uint8_t version_{0};
+	bool corrupt_{false};
+	DTCHitSource source_{};
+};
+
+class CalorimeterHitParser
+{
+public:
+	using value_type = CalorimeterHitView;
+	static constexpr DTCLib::DTC_Subsystem subsystem = DTCLib::DTC_Subsystem_Calorimeter;
+
+	static bool accepts(DTCLib::DTC_DataHeaderPacket const& hdr) { return hdr.GetSubsystem() == subsystem && hdr.GetVersion() <= 1; }
+	void begin(DTCLib::DTC_DataBlock const& block, DTCLib::DTC_DataHeaderPacket const& hdr, DTCHitSource const& source);
+	bool next(value_type& hit);
+	bool corrupt() const { return corrupt_; }
+
+private:
+	const uint8_t* data_{nullptr};
+	size_t size_{0};
+	size_t pos_{0};
+	bool corrupt_{false};
+	DTCHitSource source_{};
+};
+
+class CRVHitParser
+{
+public:
+	using value_type = CRVHitView;
+	static constexpr DTCLib::DTC_Subsystem subsystem = DTCLib::DTC_Subsystem_CRV;
+
+	static bool accepts(DTCLib::DTC_DataHeaderPacket const& hdr) { return hdr.GetSubsystem() == subsystem; }
+	// After begin, hasStatus() is false if the DataBlock is too short to hold a ROC status packet
+	void begin(DTCLib::DTC_DataBlock const& block, DTCLib::DTC_DataHeaderPacket const& hdr, DTCHitSource const& source);
+	bool next(value_type& hit);
+	bool corrupt() const { return corrupt_; }
+	bool hasStatus() const { return hasStatus_; }
+	CRVDataDecoder::CRVROCStatusPacket const& status() const { return status_; }
+
+private:
+	const uint8_t* data_{nullptr};
+	size_t size_{0};
+	size_t pos_{0};
+	bool corrupt_{false};
+	bool hasStatus_{false};
+	CRVDataDecoder::CRVROCStatusPacket status_;
+	DTCHitSource source_{};
+};
+
+// Input range over the hits of one subsystem in a DTC_Event
+template <typename Parser>
+class DTCHitStream
+{
+public:
+	using value_type = typename Parser::value_type;
+
+	class iterator
+	{
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = typename Parser::value_type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = value_type const*;
+		using reference = value_type const&;
+
+		iterator() = default;  // End of stream
+		explicit iterator(DTCLib::DTC_Event const* event)
+			: event_(event)
+		{
+			advance();
+		}
+
+		reference operator*() const { return hit_; }
+		pointer operator->() const { return &hit_; }
+		iterator& operator++()
+		{
+			advance();
+			return *this;
+		}
+		void operator++(int) { advance(); }
+
+		// Iterators only compare equal when both are at the end
+		bool operator==(iterator const& other) const { return event_ == nullptr && other.event_ == nullptr; }
+		bool operator!=(iterator const& other) const { return !(*this == other); }
+
+		// Number of DataBlocks cut short so far because their hits overran them
+		size_t corruptBlocks() const { return corruptBlocks_; }
+
+	private:
+		void advance()
+		{
+			while (event_ != nullptr)
+			{
+				if (inBlock_)
+				{
+					if (parser_.next(hit_)) return;
+					if (parser_.corrupt()) ++corruptBlocks_;
+					inBlock_ = false;
+					++block_;
+				}
+
+				auto& subEvents = event_->GetSubEvents();
+				while (subEvent_ < subEvents.size() &&
+					   (subEvents[subEvent_].GetSubsystem() != Parser::subsystem || block_ >= subEvents[subEvent_].GetDataBlockCount()))
+				{
+					++subEvent_;
+					block_ = 0;
+				}
+				if (subEvent_ == subEvents.size())
+				{
+					event_ = nullptr;
+					return;
+				}
+
+				auto& subEvent = subEvents[subEvent_];
+				auto& block = subEvent.GetDataBlocks()[block_];
+				if (block.byteSize <= 16)
+				{
+					++block_;
+					continue;
+				}
+				DTCLib::DTC_DataHeaderPacket hdr{DTCLib::DTC_DataPacket(block.blockPointer)};
+				if (!Parser::accepts(hdr))
+				{
+					++block_;
+					continue;
+				}
+				parser_.begin(block, hdr, DTCHitSource{subEvent.GetDTCID(), static_cast<uint8_t>(hdr.GetLinkID()), static_cast<uint16_t>(block_), subEvent_});
+				inBlock_ = true;
+			}
+		}
+
+		DTCLib::DTC_Event const* event_{nullptr};
+		size_t subEvent_{0};
+		size_t block_{0};
+		bool inBlock_{false};
+		size_t corruptBlocks_{0};
+		Parser parser_;
+		value_type hit_{};
+	};
+
+	// The DTC_Event must outlive the stream and its iterators
+	explicit DTCHitStream(DTCLib::DTC_Event const& event)
+		: event_(&event) {}
+
+	iterator begin() const { return iterator(event_); }
+	iterator end() const { return iterator(); }
+
+private:
+	DTCLib::DTC_Event const* event_;
+};
+
+using TrackerHitStream = DTCHitStream<TrackerHitParser>;
+using CalorimeterHitStream = DTCHitStream<CalorimeterHitParser>;
+using CRVHitStream = DTCHitStream<CRVHitParser>;
+
+}  // namespace mu2e
+
+#endif  // ARTDAQ_CORE_MU2E_DATA_DTCHITSTREAM_HH
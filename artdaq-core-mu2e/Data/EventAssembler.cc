@@ -0,0 +1,256 @@
+#include "artdaq-core-mu2e/Data/EventAssembler.hh"
+
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_EventHeader.h"
+
+#include "TRACE/tracemf.h"
+#define TRACE_NAME "EventAssembler"
+
+#include <algorithm>
+#include <cstring>
+
+mu2e::EventAssembler::EventAssembler(std::map<uint8_t, size_t> const& expectedDTCs, std::chrono::milliseconds timeout, size_t shards)
+	: expectedDTCs_(expectedDTCs), timeout_(timeout)
+{
+	shards_.resize(std::max(shards, size_t(1)));
+	for (auto& shard : shards_)
+	{
+		shard.reset(new Shard());
+	}
+}
+
+size_t mu2e::EventAssembler::expectedFor(uint8_t partition) const
+{
+	auto it = expectedDTCs_.find(partition);
+	return it != expectedDTCs_.end() ? it->second : 0;
+}
+
+void mu2e::EventAssembler::markFinished(Shard& shard, uint64_t key)
+{
+	if (!shard.finished.insert(key).second) return;
+	shard.finishedOrder.push_back(key);
+	if (shard.finishedOrder.size() > FINISHED_HISTORY)
+	{
+		shard.finished.erase(shard.finishedOrder.front());
+		shard.finishedOrder.pop_front();
+	}
+}
+
+void mu2e::EventAssembler::addSubEvent(DTCLib::DTC_SubEvent const& subEvent, Clock::time_point now)
+{
+	std::vector<std::pair<const void*, size_t>> parts;
+	parts.reserve(subEvent.GetDataBlockCount());
+	for (auto& block : subEvent.GetDataBlocks())
+	{
+		parts.emplace_back(block.blockPointer, block.byteSize);
+	}
+	addParts(*subEvent.GetHeader(), parts, now);
+}
+
+void mu2e::EventAssembler::addSubEvent(const void* subEventData, Clock::time_point now)
+{
+	DTCLib::DTC_SubEventHeader header;
+	memcpy(&header, subEventData, sizeof(header));
+	if (header.inclusive_subevent_byte_count < sizeof(header))
+	{
+		TLOG(TLVL_ERROR) << "Invalid sub event byte count " << header.inclusive_subevent_byte_count << ", dropping sub event";
+		return;
+	}
+	addParts(header, {{static_cast<const uint8_t*>(subEventData) + sizeof(header), header.inclusive_subevent_byte_count - sizeof(header)}}, now);
+}
+
+void mu2e::EventAssembler::addParts(DTCLib::DTC_SubEventHeader header, std::vector<std::pair<const void*, size_t>> const& parts, Clock::time_point now)
+{
+	size_t size = sizeof(header);
+	for (auto& part : parts)
+	{
+		size += part.second;
+	}
+	header.inclusive_subevent_byte_count = size;
+
+	uint8_t partition = header.partition_id;
+	EWT ewt = header.event_tag_low | (static_cast<EWT>(header.event_tag_high) << 32);
+	auto key = makeKey(ewt, partition);
+	auto expected = expectedFor(partition);
+	uint16_t dtc = (header.source_subsystem << 8) | header.source_dtc_id;
+
+	std::vector<AssembledEvent> done;
+	{
+		auto& shard = shardFor(key);
+		std::lock_guard<std::mutex> lk(shard.mutex);
+		if (shard.finished.count(key))
+		{
+			TLOG(TLVL_WARNING) << "Late sub event from DTC " << static_cast<int>(header.source_dtc_id) << " (subsystem " << static_cast<int>(header.source_subsystem)
+							   << ") for EWT " << ewt << ", partition " << static_cast<int>(partition) << ", which was already released; dropping it";
+			late_.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		auto existing = shard.events.find(key);
+		auto eventBytes = existing != shard.events.end() ? existing->second.data.size() : sizeof(DTCLib::DTC_EventHeader);
+		auto subEvents = existing != shard.events.end() ? existing->second.dtcs.size() : 0;
+		if (eventBytes + size > MAX_EVENT_BYTES || subEvents >= MAX_SUBEVENTS)
+		{
+			TLOG(TLVL_ERROR) << "Sub event of " << size << " bytes from DTC " << static_cast<int>(header.source_dtc_id) << " (subsystem " << static_cast<int>(header.source_subsystem)
+							 << ") does not fit in the DTC_EventHeader of EWT " << ewt << ", partition " << static_cast<int>(partition) << " (" << eventBytes << " bytes, "
+							 << subEvents << " sub events); dropping it";
+			oversized_.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		auto& pending = shard.events[key];
+		if (pending.data.empty())
+		{
+			pending.firstHeader = header;
+			pending.firstSeen = now;
+			pending.data.reserve(sizeof(DTCLib::DTC_EventHeader) + size * std::max(expected, size_t(1)));
+			pending.data.resize(sizeof(DTCLib::DTC_EventHeader));
+		}
+		if (std::find(pending.dtcs.begin(), pending.dtcs.end(), dtc) == pending.dtcs.end())
+		{
+			++pending.distinctDTCs;
+		}
+		else
+		{
+			TLOG(TLVL_WARNING) << "Duplicate sub event from DTC " << static_cast<int>(header.source_dtc_id) << " (subsystem " << static_cast<int>(header.source_subsystem)
+							   << ") for EWT " << ewt << ", partition " << static_cast<int>(partition);
+		}
+		pending.dtcs.push_back(dtc);
+
+		auto offset = pending.data.size();
+		pending.data.resize(offset + size);
+		memcpy(pending.data.data() + offset, &header, sizeof(header));
+		offset += sizeof(header);
+		for (auto& part : parts)
+		{
+			memcpy(pending.data.data() + offset, part.first, part.second);
+			offset += part.second;
+		}
+
+		if (expected > 0 && pending.distinctDTCs >= expected)
+		{
+			done.push_back(finish(pending, true));
+			shard.events.erase(key);
+			markFinished(shard, key);
+		}
+	}
+	if (!done.empty())
+	{
+		completed_.fetch_add(1, std::memory_order_relaxed);
+		push(done);
+	}
+}
+
+mu2e::EventAssembler::AssembledEvent mu2e::EventAssembler::finish(PendingEvent& pending, bool complete) const
+{
+	auto& first = pending.firstHeader;
+	auto expected = expectedFor(first.partition_id);
+
+	DTCLib::DTC_EventHeader eventHeader;
+	eventHeader.inclusive_event_byte_count = pending.data.size();
+	eventHeader.event_tag_low = first.event_tag_low;
+	eventHeader.event_tag_high = first.event_tag_high;
+	eventHeader.num_dtcs = pending.dtcs.size();
+	eventHeader.event_mode = first.event_mode;
+	eventHeader.dtc_mac = first.dtc_mac;
+	eventHeader.partition_id = first.partition_id;
+	eventHeader.evb_mode = first.evb_mode;
+	eventHeader.emtdc = first.emtdc;
+	memcpy(pending.data.data(), &eventHeader, sizeof(eventHeader));
+
+	AssembledEvent event;
+	event.header.ewt = first.event_tag_low | (static_cast<EWT>(first.event_tag_high) << 32);
+	event.header.mode = static_cast<uint32_t>(first.event_mode);
+	event.header.rfmTDC_est = first.emtdc;
+	event.header.initErrorChecks();
+	event.header.ndtc_check = pending.dtcs.size() == expected;
+	event.header.dtc_check = pending.distinctDTCs >= expected;
+	event.partition = first.partition_id;
+	event.complete = complete;
+	event.data = std::move(pending.data);
+	return event;
+}
+
+void mu2e::EventAssembler::push(std::vector<AssembledEvent>& events)
+{
+	{
+		std::lock_guard<std::mutex> lk(readyMutex_);
+		for (auto& event : events)
+		{
+			ready_.push_back(std::move(event));
+		}
+	}
+	readyCondition_.notify_all();
+}
+
+bool mu2e::EventAssembler::pop(AssembledEvent& event)
+{
+	std::lock_guard<std::mutex> lk(readyMutex_);
+	if (ready_.empty()) return false;
+	event = std::move(ready_.front());
+	ready_.pop_front();
+	return true;
+}
+
+bool mu2e::EventAssembler::waitPop(AssembledEvent& event, std::chrono::milliseconds wait)
+{
+	std::unique_lock<std::mutex> lk(readyMutex_);
+	if (!readyCondition_.wait_for(lk, wait, [this] { return !ready_.empty(); })) return false;
+	event = std::move(ready_.front());
+	ready_.pop_front();
+	return true;
+}
+
+size_t mu2e::EventAssembler::releaseExpired(Clock::time_point now)
+{
+	return release(now, false);
+}
+
+size_t mu2e::EventAssembler::flush()
+{
+	return release(Clock::now(), true);
+}
+
+size_t mu2e::EventAssembler::release(Clock::time_point now, bool all)
+{
+	std::vector<AssembledEvent> expired;
+	for (auto& shard : shards_)
+	{
+		std::lock_guard<std::mutex> lk(shard->mutex);
+		for (auto it = shard->events.begin(); it != shard->events.end();)
+		{
+			if (all || now - it->second.firstSeen >= timeout_)
+			{
+				TLOG(TLVL_DEBUG + 5) << "Releasing incomplete event for EWT " << (it->first & 0xFFFFFFFFFFFFULL) << " with " << it->second.distinctDTCs << " of "
+									 << expectedFor(it->second.firstHeader.partition_id) << " DTCs";
+				expired.push_back(finish(it->second, false));
+				markFinished(*shard, it->first);
+				it = shard->events.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+	if (!expired.empty())
+	{
+		incomplete_.fetch_add(expired.size(), std::memory_order_relaxed);
+		push(expired);
+	}
+	return expired.size();
+}
+
+size_t mu2e::EventAssembler::pendingCount() const
+{
+	size_t count = 0;
+	for (auto& shard : shards_)
+	{
+		std::lock_guard<std::mutex> lk(shard->mutex);
+		count += shard->events.size();
+	}
+	return count;
+}
+
+size_t mu2e::EventAssembler::readyCount() const
+{
+	std::lock_guard<std::mutex> lk(readyMutex_);
+	return ready_.size();
+}
@@ -0,0 +1,137 @@
+#ifndef ARTDAQ_CORE_MU2E_DATA_EVENTASSEMBLER_HH
+#define ARTDAQ_CORE_MU2E_DATA_EVENTASSEMBLER_HH
+
+#include "artdaq-core-mu2e/Data/EventHeader.hh"
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_SubEvent.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Software event builder: collects DTC_SubEvents from many DTCs, arriving in any order and from any
+// number of producer threads, and assembles them into contiguous DTC_Events keyed by Event Window Tag.
+//
+// Notes:
+//  1) Pending events are spread over independently locked shards (by EWT and partition), so producers
+//     only contend when they deliver sub-events of events in the same shard. Completed events go to one
+//     output queue which consumers pop from.
+//  2) An event is complete when sub-events from the configured number of distinct DTCs of its partition
+//     have arrived. Each sub-event is appended to the event buffer as it arrives, and the DTC_EventHeader
+//     is written in front of them on completion, so the output is ready to be copied into a DTCEVT Fragment.
+//  3) Incomplete events are released by releaseExpired once they have been pending for longer than the
+//     timeout. The EventHeader check bits are 1 if the check passed (see EventHeader::initErrorChecks):
+//     ndtc_check is cleared if the number of sub-events differs from the configured DTC count (missing or
+//     duplicate DTCs), dtc_check is cleared if any configured DTC is missing. rnr_check is not evaluated.
+//  4) Each shard remembers the last FINISHED_HISTORY events it completed or released. A sub-event which arrives
+//     for one of them (late, or a duplicate after completion) is dropped and counted by lateCount, rather than
+//     opening a second, incomplete event with the same EWT.
+//  5) The DTC_EventHeader holds the event size in 24 bits and the sub-event count in 8 bits. A sub-event which
+//     would take its event past MAX_EVENT_BYTES or MAX_SUBEVENTS is dropped and counted by oversizedCount, so
+//     the event is released without it (and with dtc_check cleared if its DTC is then missing).
+
+namespace mu2e {
+
+class EventAssembler
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr size_t FINISHED_HISTORY = 4096;     // Finished events remembered per shard to reject late sub-events
+	static constexpr size_t MAX_EVENT_BYTES = 0xFFFFFF;  // Largest inclusive_event_byte_count of a DTC_EventHeader
+	static constexpr size_t MAX_SUBEVENTS = 0xFF;        // Largest num_dtcs of a DTC_EventHeader
+
+	struct AssembledEvent
+	{
+		EventHeader header;         // EWT, event mode and check bits
+		uint8_t partition = 0;      // Partition ID of the sub-events
+		bool complete = false;      // False if the event was released on timeout or by flush
+		std::vector<uint8_t> data;  // DTC_EventHeader followed by the sub-events
+	};
+
+	// expectedDTCs: number of DTCs contributing to each partition. Events of partitions which are not listed
+	//               are only released by releaseExpired or flush.
+	// timeout:      time after the first sub-event of an event after which releaseExpired releases it
+	// shards:       number of independently locked shards of the pending event table
+	EventAssembler(std::map<uint8_t, size_t> const& expectedDTCs, std::chrono::milliseconds timeout, size_t shards = 16);
+
+	EventAssembler(EventAssembler const&) = delete;
+	EventAssembler& operator=(EventAssembler const&) = delete;
+
+	// Add a sub-event; its header and data blocks are copied. Safe to call from any number of threads.
+	void addSubEvent(DTCLib::DTC_SubEvent const& subEvent, Clock::time_point now = Clock::now());
+	// Add a sub-event from a buffer starting with its DTC_SubEventHeader
+	void addSubEvent(const void* subEventData, Clock::time_point now = Clock::now());
+
+	// Take the next assembled event, without waiting. Returns false if none is available.
+	bool pop(AssembledEvent& event);
+	// Take the next assembled event, waiting up to wait for one. Returns false if none became available.
+	bool waitPop(AssembledEvent& event, std::chrono::milliseconds wait);
+
+	// Release the events which have been pending for longer than the timeout. Returns the number released.
+	size_t releaseExpired(Clock::time_point now = Clock::now());
+	// Release all pending events, e.g. at the end of a run. Returns the number released.
+	size_t flush();
+
+	size_t pendingCount() const;
+	size_t readyCount() const;
+	uint64_t completedCount() const { return completed_.load(std::memory_order_relaxed); }
+	uint64_t incompleteCount() const { return incomplete_.load(std::memory_order_relaxed); }
+	uint64_t lateCount() const { return late_.load(std::memory_order_relaxed); }
+	uint64_t oversizedCount() const { return oversized_.load(std::memory_order_relaxed); }
+
+private:
+	struct PendingEvent
+	{
+		DTCLib::DTC_SubEventHeader firstHeader;
+		std::vector<uint8_t> data;    // Space for the DTC_EventHeader, then the sub-events
+		std::vector<uint16_t> dtcs;   // (subsystem << 8) | DTC ID of each sub-event received
+		size_t distinctDTCs = 0;
+		Clock::time_point firstSeen;
+	};
+
+	struct Shard
+	{
+		mutable std::mutex mutex;
+		std::unordered_map<uint64_t, PendingEvent> events;
+		std::unordered_set<uint64_t> finished;  // Keys of recently completed or released events
+		std::deque<uint64_t> finishedOrder;     // The same keys, oldest first
+	};
+
+	static uint64_t makeKey(uint64_t ewt, uint8_t partition) { return (static_cast<uint64_t>(partition) << 48) | ewt; }
+	Shard& shardFor(uint64_t key) { return *shards_[(key * 0x9E3779B97F4A7C15ULL >> 32) % shards_.size()]; }
+	size_t expectedFor(uint8_t partition) const;
+	// Remember that the event with key is finished; call with the shard locked
+	static void markFinished(Shard& shard, uint64_t key);
+
+	// Append the header and data parts of one sub-event to its pending event
+	void addParts(DTCLib::DTC_SubEventHeader header, std::vector<std::pair<const void*, size_t>> const& parts, Clock::time_point now);
+	AssembledEvent finish(PendingEvent& pending, bool complete) const;
+	size_t release(Clock::time_point now, bool all);
+	void push(std::vector<AssembledEvent>& events);
+
+	std::map<uint8_t, size_t> expectedDTCs_;
+	std::chrono::milliseconds timeout_;
+	std::vector<std::unique_ptr<Shard>> shards_;
+
+	mutable std::mutex readyMutex_;
+	std::condition_variable readyCondition_;
+	std::deque<AssembledEvent> ready_;
+
+	std::atomic<uint64_t> completed_{0};
+	std::atomic<uint64_t> incomplete_{0};
+	std::atomic<uint64_t> late_{0};
+	std::atomic<uint64_t> oversized_{0};
+};
+
+}  // namespace mu2e
+
+#endif  // ARTDAQ_CORE_MU2E_DATA_EVENTASSEMBLER_HH
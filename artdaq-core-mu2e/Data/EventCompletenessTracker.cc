@@ -0,0 +1,122 @@
+#include "artdaq-core-mu2e/Data/EventCompletenessTracker.hh"
+
+#include "TRACE/tracemf.h"
+#define TRACE_NAME "EventCompletenessTracker"
+
+#include <algorithm>
+
+mu2e::EventCompletenessTracker::EventCompletenessTracker(std::vector<std::pair<DTCLib::DTC_Subsystem, uint8_t>> const& expectedDTCs, uint32_t numEVBs, size_t windowSize)
+	: expectedDTCCount_(0), numEVBs_(std::max(numEVBs, uint32_t(1))), window_((std::max(windowSize, size_t(1)) + 63) / 64), windowBits_(window_.size() * 64)
+{
+	for (auto& dtc : expectedDTCs)
+	{
+		expectedDTCs_.set(dtcIndex(dtc.first, dtc.second));
+	}
+	expectedDTCCount_ = expectedDTCs_.count();
+}
+
+void mu2e::EventCompletenessTracker::beginRun()
+{
+	std::fill(window_.begin(), window_.end(), 0);
+	base_ = 0;
+	highest_ = 0;
+	started_ = false;
+	counters_ = Counters();
+}
+
+void mu2e::EventCompletenessTracker::retire(uint64_t count)
+{
+	if (count > windowBits_)
+	{
+		// Slots which never entered the window were not seen either
+		counters_.missingEWTs += count - windowBits_;
+		base_ += count - windowBits_;
+		count = windowBits_;
+	}
+	while (count > 0)
+	{
+		auto pos = base_ % windowBits_;
+		auto bit = pos % 64;
+		auto n = std::min<uint64_t>(count, 64 - bit);
+		auto mask = (n == 64 ? ~0ULL : ((1ULL << n) - 1)) << bit;
+		auto& word = window_[pos / 64];
+		counters_.missingEWTs += n - __builtin_popcountll(word & mask);
+		word &= ~mask;
+		base_ += n;
+		count -= n;
+	}
+}
+
+bool mu2e::EventCompletenessTracker::markEWT(uint64_t index)
+{
+	if (!started_)
+	{
+		base_ = index;
+		highest_ = index;
+		started_ = true;
+	}
+	if (index < base_)
+	{
+		++counters_.lateEWTs;
+		return false;
+	}
+	if (index >= base_ + windowBits_)
+	{
+		retire(index - windowBits_ + 1 - base_);
+	}
+	highest_ = std::max(highest_, index);
+
+	auto pos = index % windowBits_;
+	auto& word = window_[pos / 64];
+	auto mask = 1ULL << (pos % 64);
+	if (word & mask)
+	{
+		++counters_.duplicateEWTs;
+		return false;
+	}
+	word |= mask;
+	return true;
+}
+
+void mu2e::EventCompletenessTracker::flush()
+{
+	if (started_ && highest_ >= base_) retire(highest_ + 1 - base_);
+}
+
+bool mu2e::EventCompletenessTracker::checkEvent(DTCLib::DTC_Event const& event, EventHeader& header)
+{
+	++counters_.events;
+	auto ewt = event.GetEventWindowTag().GetEventWindowTag(true);
+	bool ewtOK = markEWT(ewt / numEVBs_);
+
+	std::bitset<2048> seen;
+	bool ewtMatch = true;
+	bool duplicateDTC = false;
+	for (auto& subEvent : event.GetSubEvents())
+	{
+		auto idx = dtcIndex(subEvent.GetSubsystem(), subEvent.GetDTCID());
+		if (seen.test(idx)) duplicateDTC = true;
+		seen.set(idx);
+		if (subEvent.GetEventWindowTag().GetEventWindowTag(true) != ewt) ewtMatch = false;
+	}
+
+	auto eventHeader = event.GetHeader();
+	header.initErrorChecks();
+	header.rnr_check = numEVBs_ <= 1 || ewt % numEVBs_ == eventHeader->evb_id;
+	header.ndtc_check = eventHeader->num_dtcs == expectedDTCCount_ && event.GetSubEventCount() == expectedDTCCount_;
+	header.dtc_check = !duplicateDTC && seen == expectedDTCs_;
+	header.ewt_check = ewtMatch;
+
+	if (!header.rnr_check) ++counters_.rnrErrors;
+	if (!header.ndtc_check) ++counters_.ndtcErrors;
+	if (!header.dtc_check) ++counters_.dtcErrors;
+	if (!header.ewt_check) ++counters_.ewtErrors;
+
+	bool ok = ewtOK && header.rnr_check && header.ndtc_check && header.dtc_check && header.ewt_check;
+	if (!ok)
+	{
+		TLOG(TLVL_DEBUG + 5) << "Event " << ewt << " failed checks: rnr=" << int(header.rnr_check) << " ndtc=" << int(header.ndtc_check) << " dtc=" << int(header.dtc_check)
+							 << " ewt=" << int(header.ewt_check) << " window=" << ewtOK;
+	}
+	return ok;
+}
@@ -0,0 +1,85 @@
+#ifndef ARTDAQ_CORE_MU2E_DATA_EVENTCOMPLETENESSTRACKER_HH
+#define ARTDAQ_CORE_MU2E_DATA_EVENTCOMPLETENESSTRACKER_HH
+
+#include "artdaq-core-mu2e/Data/EventHeader.hh"
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_Event.h"
+
+#include <bitset>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Streaming consistency checks over the DTC_Events of a run, producing the EventHeader check bits.
+//
+// Notes:
+//  1) EWTs are tracked in a circular bitmap covering the most recent windowSize EWTs seen by this event
+//     builder. With round-robin event building over numEVBs builders, each builder only sees every numEVBs-th
+//     EWT, and the bitmap is indexed by EWT / numEVBs. An EWT which falls out of the window without having been
+//     seen is counted as missing, an EWT seen twice while in the window as a duplicate, and an EWT older than
+//     the window as late (it has already been counted as missing). The cost per event is constant apart from
+//     the sub-event loop; retiring slots from the window is done 64 at a time.
+//  2) Check bits are 1 if the check passed (see EventHeader::initErrorChecks):
+//       rnr_check:  EWT % numEVBs matches the evb_id of the DTC_EventHeader (always passes if numEVBs <= 1)
+//       ndtc_check: num_dtcs and the number of sub-events both equal the number of expected DTCs
+//       dtc_check:  the sub-events come from exactly the expected set of DTCs
+//       ewt_check:  every sub-event has the EWT of the event
+//  3) Not thread-safe; use one tracker per event stream.
+
+namespace mu2e {
+
+class EventCompletenessTracker
+{
+public:
+	struct Counters
+	{
+		uint64_t events = 0;         // Events checked
+		uint64_t missingEWTs = 0;    // EWTs which left the window without being seen
+		uint64_t duplicateEWTs = 0;  // EWTs seen more than once
+		uint64_t lateEWTs = 0;       // EWTs older than the window
+		uint64_t rnrErrors = 0;      // Events with rnr_check cleared
+		uint64_t ndtcErrors = 0;     // Events with ndtc_check cleared
+		uint64_t dtcErrors = 0;      // Events with dtc_check cleared
+		uint64_t ewtErrors = 0;      // Events with ewt_check cleared
+	};
+
+	// expectedDTCs: (subsystem, DTC ID) of each DTC which contributes to every event
+	// numEVBs:      number of event builders sharing the EWTs round-robin (1 if this builder sees all of them)
+	// windowSize:   number of EWTs (of this builder) tracked for gaps and duplicates, rounded up to a multiple of 64
+	EventCompletenessTracker(std::vector<std::pair<DTCLib::DTC_Subsystem, uint8_t>> const& expectedDTCs, uint32_t numEVBs = 1, size_t windowSize = 4096);
+
+	// Check one event, update the counters, and set the check bits of header (other fields are not modified).
+	// Returns true if all checks passed and the EWT was neither a duplicate nor late.
+	bool checkEvent(DTCLib::DTC_Event const& event, EventHeader& header);
+
+	// Count the gaps which are still in the window, e.g. at the end of a run. Gaps after the last EWT seen
+	// cannot be detected.
+	void flush();
+
+	// Reset the window and counters for a new run
+	void beginRun();
+
+	Counters const& counters() const { return counters_; }
+
+private:
+	static size_t dtcIndex(uint8_t subsystem, uint8_t dtcID) { return (static_cast<size_t>(subsystem & 0x7) << 8) | dtcID; }
+	// Record an EWT index in the window. Returns false if it is a duplicate or late.
+	bool markEWT(uint64_t index);
+	// Move the start of the window up by count slots, counting the unset ones as missing
+	void retire(uint64_t count);
+
+	std::bitset<2048> expectedDTCs_;
+	size_t expectedDTCCount_;
+	uint32_t numEVBs_;
+
+	std::vector<uint64_t> window_;
+	uint64_t windowBits_;
+	uint64_t base_ = 0;     // EWT index of the oldest slot of the window
+	uint64_t highest_ = 0;  // Highest EWT index seen
+	bool started_ = false;
+
+	Counters counters_;
+};
+
+}  // namespace mu2e
+
+#endif  // ARTDAQ_CORE_MU2E_DATA_EVENTCOMPLETENESSTRACKER_HH
@@ -0,0 +1,190 @@
+#include "artdaq-core-mu2e/Data/LinkHealthAccumulator.hh"
+
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_BitExtract.h"
+
+#include "TRACE/tracemf.h"
+#define TRACE_NAME "LinkHealthAccumulator"
+
+#include <bitset>
+
+namespace {
+
+void countBits(uint8_t status, std::array<std::atomic<uint64_t>, mu2e::LinkHealthAccumulator::STATUS_BITS>& counters)
+{
+	while (status != 0)
+	{
+		counters[__builtin_ctz(status)].fetch_add(1, std::memory_order_relaxed);
+		status &= status - 1;
+	}
+}
+
+// Count a change of status. Concurrent updates of the same link may count a change twice or miss one.
+void countTransition(uint8_t status, std::atomic<uint8_t>& last, std::atomic<uint64_t>& transitions)
+{
+	if (last.load(std::memory_order_relaxed) != status && last.exchange(status, std::memory_order_relaxed) != status)
+	{
+		transitions.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+}  // namespace
+
+mu2e::LinkHealthAccumulator::LinkHealthAccumulator(uint8_t expectedLinks)
+	: expectedLinks_(expectedLinks & 0x3F), expectedLinkCount_(std::bitset<NUM_LINKS>(expectedLinks_).count()), dtcs_(new std::atomic<DTCCounters*>[NUM_DTCS])
+{
+	for (size_t ii = 0; ii < NUM_DTCS; ++ii)
+	{
+		dtcs_[ii].store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+mu2e::LinkHealthAccumulator::~LinkHealthAccumulator()
+{
+	for (size_t ii = 0; ii < NUM_DTCS; ++ii)
+	{
+		delete dtcs_[ii].load(std::memory_order_acquire);
+	}
+}
+
+void mu2e::LinkHealthAccumulator::clear(DTCCounters& dtc)
+{
+	dtc.subEvents.store(0, std::memory_order_relaxed);
+	dtc.missingROCs.store(0, std::memory_order_relaxed);
+	dtc.lastEmtdc.store(0, std::memory_order_relaxed);
+	for (auto& link : dtc.links)
+	{
+		for (auto& counter : link.linkStatusBits) counter.store(0, std::memory_order_relaxed);
+		for (auto& counter : link.rocStatusBits) counter.store(0, std::memory_order_relaxed);
+		link.linkStatusTransitions.store(0, std::memory_order_relaxed);
+		link.rocStatusTransitions.store(0, std::memory_order_relaxed);
+		link.blocks.store(0, std::memory_order_relaxed);
+		link.missing.store(0, std::memory_order_relaxed);
+		link.lastLinkStatus.store(0, std::memory_order_relaxed);
+		link.lastROCStatus.store(0, std::memory_order_relaxed);
+	}
+}
+
+mu2e::LinkHealthAccumulator::DTCCounters& mu2e::LinkHealthAccumulator::counters(uint8_t subsystem, uint8_t dtcID)
+{
+	auto& slot = dtcs_[(static_cast<size_t>(subsystem & 0x7) << 8) | dtcID];
+	auto dtc = slot.load(std::memory_order_acquire);
+	if (dtc != nullptr) return *dtc;
+
+	auto created = new DTCCounters;
+	clear(*created);
+	if (slot.compare_exchange_strong(dtc, created, std::memory_order_acq_rel, std::memory_order_acquire))
+	{
+		TLOG(TLVL_DEBUG) << "First sub-event from subsystem " << static_cast<int>(subsystem) << " DTC " << static_cast<int>(dtcID);
+		return *created;
+	}
+	// Another thread published the counters of this DTC first
+	delete created;
+	return *dtc;
+}
+
+void mu2e::LinkHealthAccumulator::add(DTCLib::DTC_SubEventHeader const& header)
+{
+	auto& dtc = counters(header.source_subsystem, header.source_dtc_id);
+	dtc.subEvents.fetch_add(1, std::memory_order_relaxed);
+	dtc.lastEmtdc.store(header.emtdc, std::memory_order_relaxed);
+	if (header.num_rocs < expectedLinkCount_)
+	{
+		dtc.missingROCs.fetch_add(expectedLinkCount_ - header.num_rocs, std::memory_order_relaxed);
+	}
+
+	const uint8_t status[NUM_LINKS] = {static_cast<uint8_t>(header.link0_status), static_cast<uint8_t>(header.link1_status), static_cast<uint8_t>(header.link2_status),
+									   static_cast<uint8_t>(header.link3_status), static_cast<uint8_t>(header.link4_status), static_cast<uint8_t>(header.link5_status)};
+	for (size_t ii = 0; ii < NUM_LINKS; ++ii)
+	{
+		auto& link = dtc.links[ii];
+		countBits(status[ii], link.linkStatusBits);
+		countTransition(status[ii], link.lastLinkStatus, link.linkStatusTransitions);
+	}
+}
+
+void mu2e::LinkHealthAccumulator::add(DTCLib::DTC_SubEvent const& subEvent)
+{
+	auto header = subEvent.GetHeader();
+	add(*header);
+	auto& dtc = counters(header->source_subsystem, header->source_dtc_id);
+
+	uint8_t seen = 0;
+	for (auto& block : subEvent.GetDataBlocks())
+	{
+		if (block.byteSize < 16) continue;
+		// Link and status straight from the DataHeader packet (see DTC_DMAPacket and DTC_DataHeaderPacket)
+		auto bytes = static_cast<const uint8_t*>(block.GetRawBufferPointer());
+		size_t linkID = DTCLib::ExtractBits<24, 3>(bytes);
+		if (linkID >= NUM_LINKS)
+		{
+			TLOG(TLVL_DEBUG + 5) << "DataBlock from link " << linkID << " ignored";
+			continue;
+		}
+		seen |= 1 << linkID;
+
+		auto& link = dtc.links[linkID];
+		auto status = static_cast<uint8_t>(DTCLib::ExtractBits<96, 8>(bytes));
+		link.blocks.fetch_add(1, std::memory_order_relaxed);
+		countBits(status, link.rocStatusBits);
+		countTransition(status, link.lastROCStatus, link.rocStatusTransitions);
+	}
+
+	uint8_t missing = expectedLinks_ & ~seen;
+	while (missing != 0)
+	{
+		dtc.links[__builtin_ctz(missing)].missing.fetch_add(1, std::memory_order_relaxed);
+		missing &= missing - 1;
+	}
+}
+
+void mu2e::LinkHealthAccumulator::add(DTCLib::DTC_Event const& event)
+{
+	for (auto& subEvent : event.GetSubEvents())
+	{
+		add(subEvent);
+	}
+}
+
+std::vector<mu2e::LinkHealthAccumulator::DTCHealth> mu2e::LinkHealthAccumulator::snapshot() const
+{
+	std::vector<DTCHealth> output;
+	for (size_t ii = 0; ii < NUM_DTCS; ++ii)
+	{
+		auto dtc = dtcs_[ii].load(std::memory_order_acquire);
+		if (dtc == nullptr) continue;
+
+		DTCHealth health;
+		health.subsystem = static_cast<DTCLib::DTC_Subsystem>(ii >> 8);
+		health.dtcID = static_cast<uint8_t>(ii & 0xFF);
+		health.subEvents = dtc->subEvents.load(std::memory_order_relaxed);
+		health.missingROCs = dtc->missingROCs.load(std::memory_order_relaxed);
+		health.lastEmtdc = dtc->lastEmtdc.load(std::memory_order_relaxed);
+		for (size_t jj = 0; jj < NUM_LINKS; ++jj)
+		{
+			auto& link = dtc->links[jj];
+			auto& out = health.links[jj];
+			for (size_t bit = 0; bit < STATUS_BITS; ++bit)
+			{
+				out.linkStatusBits[bit] = link.linkStatusBits[bit].load(std::memory_order_relaxed);
+				out.rocStatusBits[bit] = link.rocStatusBits[bit].load(std::memory_order_relaxed);
+			}
+			out.linkStatusTransitions = link.linkStatusTransitions.load(std::memory_order_relaxed);
+			out.rocStatusTransitions = link.rocStatusTransitions.load(std::memory_order_relaxed);
+			out.blocks = link.blocks.load(std::memory_order_relaxed);
+			out.missing = link.missing.load(std::memory_order_relaxed);
+			out.lastLinkStatus = link.lastLinkStatus.load(std::memory_order_relaxed);
+			out.lastROCStatus = link.lastROCStatus.load(std::memory_order_relaxed);
+		}
+		output.push_back(health);
+	}
+	return output;
+}
+
+void mu2e::LinkHealthAccumulator::reset()
+{
+	for (size_t ii = 0; ii < NUM_DTCS; ++ii)
+	{
+		auto dtc = dtcs_[ii].load(std::memory_order_acquire);
+		if (dtc != nullptr) clear(*dtc);
+	}
+}
@@ -0,0 +1,113 @@
+#ifndef ARTDAQ_CORE_MU2E_DATA_LINKHEALTHACCUMULATOR_HH
+#define ARTDAQ_CORE_MU2E_DATA_LINKHEALTHACCUMULATOR_HH
+
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_Event.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Per-DTC, per-link counters of the status fields of DTC sub-events, for monitoring link health at full rate.
+//
+// Notes:
+//  1) For each DTC (subsystem and DTC ID) and each of its 6 links, the accumulator counts how often each bit of the
+//     linkN_status byte of the DTC_SubEventHeader and of the status byte of the ROC DTC_DataHeaderPacket was set,
+//     the number of DataBlocks received and missing, and the number of times the status byte changed value.
+//     Per DTC, it counts sub-events and ROCs missing from num_rocs, and keeps the last emtdc.
+//  2) add() may be called from any number of threads without locking: counters are relaxed atomics, and the
+//     counters of a DTC are allocated on its first sub-event and published with a compare-and-swap. Only
+//     counters for set status bits are touched, so a healthy link costs a few increments per sub-event. The link
+//     and status of each DataBlock are read straight from its bytes; no DTC_DataHeaderPacket is constructed.
+//  3) snapshot() reads the counters without stopping the writers. Counters are read one by one, so a snapshot
+//     taken while sub-events are being added may mix counts from slightly different moments. Status transitions
+//     are counted in the order sub-events reach add(), which is only the EWT order within one thread.
+//  4) A ROC is missing from a sub-event if its link is expected but has no DataBlock (add(DTC_SubEvent) only),
+//     and the missing ROC count of the DTC is how far num_rocs falls short of the number of expected links.
+
+namespace mu2e {
+
+class LinkHealthAccumulator
+{
+public:
+	static constexpr size_t NUM_LINKS = 6;
+	static constexpr size_t STATUS_BITS = 8;
+
+	struct LinkHealth
+	{
+		std::array<uint64_t, STATUS_BITS> linkStatusBits{};  // Sub-events with each bit of linkN_status set
+		std::array<uint64_t, STATUS_BITS> rocStatusBits{};   // DataBlocks with each bit of the ROC status set
+		uint64_t linkStatusTransitions = 0;                  // Changes of linkN_status from one sub-event to the next
+		uint64_t rocStatusTransitions = 0;                   // Changes of the ROC status from one DataBlock to the next
+		uint64_t blocks = 0;                                 // DataBlocks received from the link
+		uint64_t missing = 0;                                // Sub-events without a DataBlock from this expected link
+		uint8_t lastLinkStatus = 0;
+		uint8_t lastROCStatus = 0;
+	};
+
+	struct DTCHealth
+	{
+		DTCLib::DTC_Subsystem subsystem;
+		uint8_t dtcID;
+		uint64_t subEvents = 0;
+		uint64_t missingROCs = 0;  // Sum over sub-events of (expected links - num_rocs), when positive
+		uint8_t lastEmtdc = 0;
+		std::array<LinkHealth, NUM_LINKS> links{};
+	};
+
+	// expectedLinks: links (bit N for link N) each DTC is expected to read out
+	explicit LinkHealthAccumulator(uint8_t expectedLinks = 0x3F);
+	~LinkHealthAccumulator();
+
+	LinkHealthAccumulator(LinkHealthAccumulator const&) = delete;
+	LinkHealthAccumulator& operator=(LinkHealthAccumulator const&) = delete;
+
+	// Count the status fields of a sub-event header (link status, num_rocs, emtdc)
+	void add(DTCLib::DTC_SubEventHeader const& header);
+	// Count the sub-event header, plus the status and presence of the DataBlock of each link
+	void add(DTCLib::DTC_SubEvent const& subEvent);
+	// Count all sub-events of an event
+	void add(DTCLib::DTC_Event const& event);
+
+	// Counters of every DTC seen so far, ordered by subsystem and DTC ID
+	std::vector<DTCHealth> snapshot() const;
+
+	// Zero all counters. Sub-events added concurrently may be partly counted.
+	void reset();
+
+private:
+	static constexpr size_t NUM_DTCS = 8 << 8;  // Indexed by (subsystem << 8) | DTC ID
+
+	// Each link on its own cache lines, so that threads updating different links do not contend
+	struct alignas(64) LinkCounters
+	{
+		std::array<std::atomic<uint64_t>, STATUS_BITS> linkStatusBits;
+		std::array<std::atomic<uint64_t>, STATUS_BITS> rocStatusBits;
+		std::atomic<uint64_t> linkStatusTransitions;
+		std::atomic<uint64_t> rocStatusTransitions;
+		std::atomic<uint64_t> blocks;
+		std::atomic<uint64_t> missing;
+		std::atomic<uint8_t> lastLinkStatus;
+		std::atomic<uint8_t> lastROCStatus;
+	};
+
+	struct DTCCounters
+	{
+		alignas(64) std::atomic<uint64_t> subEvents;
+		std::atomic<uint64_t> missingROCs;
+		std::atomic<uint8_t> lastEmtdc;
+		std::array<LinkCounters, NUM_LINKS> links;
+	};
+
+	DTCCounters& counters(uint8_t subsystem, uint8_t dtcID);
+	static void clear(DTCCounters& dtc);
+
+	uint8_t expectedLinks_;
+	size_t expectedLinkCount_;
+	std::unique_ptr<std::atomic<DTCCounters*>[]> dtcs_;
+};
+
+}  // namespace mu2e
+
+#endif  // ARTDAQ_CORE_MU2E_DATA_LINKHEALTHACCUMULATOR_HH
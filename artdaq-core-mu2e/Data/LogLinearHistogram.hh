@@ -0,0 +1,104 @@
+#ifndef ARTDAQ_CORE_MU2E_DATA_LOGLINEARHISTOGRAM_HH
+#define ARTDAQ_CORE_MU2E_DATA_LOGLINEARHISTOGRAM_HH
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-size log-linear histogram of unsigned integers of up to ValueBits bits (HDR histogram layout).
+//
+// Notes:
+//  1) Values below 2^(SUB_BUCKET_BITS+1) have their own bucket, and each octave above is split into
+//     2^SUB_BUCKET_BITS buckets, so a quantile is within 2^-SUB_BUCKET_BITS of the true value. Larger values
+//     are counted in the last bucket.
+//  2) Recording is a bucket index computation and an increment, without allocation, and two histograms
+//     merge by adding their buckets, so histograms filled by different threads can be combined.
+
+namespace mu2e {
+
+template<size_t ValueBits, size_t SubBucketBits = 5>
+class LogLinearHistogram
+{
+public:
+	static constexpr size_t SUB_BUCKET_BITS = SubBucketBits;
+	static constexpr size_t NUM_BUCKETS = (ValueBits - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS;
+	static constexpr uint64_t MAX_VALUE = ValueBits >= 64 ? UINT64_MAX : (uint64_t(1) << ValueBits) - 1;
+
+	void record(uint64_t value)
+	{
+		value = std::min(value, MAX_VALUE);
+		++buckets_[bucketIndex(value)];
+		++count_;
+		sum_ += value;
+		if (value > max_) max_ = value;
+		if (value < min_) min_ = value;
+	}
+	void merge(LogLinearHistogram const& other)
+	{
+		for (size_t ii = 0; ii < NUM_BUCKETS; ++ii)
+		{
+			buckets_[ii] += other.buckets_[ii];
+		}
+		count_ += other.count_;
+		sum_ += other.sum_;
+		max_ = std::max(max_, other.max_);
+		min_ = std::min(min_, other.min_);
+	}
+	void reset() { *this = LogLinearHistogram(); }
+
+	uint64_t count() const { return count_; }
+	uint64_t sum() const { return sum_; }
+	uint64_t min() const { return count_ > 0 ? min_ : 0; }
+	uint64_t max() const { return max_; }
+	double mean() const { return count_ > 0 ? static_cast<double>(sum_) / count_ : 0; }
+	uint64_t bucketCount(size_t index) const { return buckets_[index]; }
+
+	// Highest value equivalent to the q-quantile (0 <= q <= 1), clamped to [min, max]. 0 if empty.
+	uint64_t quantile(double q) const
+	{
+		if (count_ == 0) return 0;
+		auto rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * count_));
+		rank = std::clamp<uint64_t>(rank, 1, count_);
+
+		uint64_t seen = 0;
+		for (size_t ii = 0; ii < NUM_BUCKETS; ++ii)
+		{
+			seen += buckets_[ii];
+			if (seen >= rank) return std::clamp(bucketHigh(ii), min_, max_);
+		}
+		return max_;
+	}
+
+	static size_t bucketIndex(uint64_t value)
+	{
+		if (value < (uint64_t(2) << SUB_BUCKET_BITS)) return value;
+		size_t shift = (63 - __builtin_clzll(value)) - SUB_BUCKET_BITS;
+		return (shift << SUB_BUCKET_BITS) + (value >> shift);
+	}
+	static uint64_t bucketLow(size_t index)
+	{
+		if (index < (size_t(2) << SUB_BUCKET_BITS)) return index;
+		size_t shift = (index >> SUB_BUCKET_BITS) - 1;
+		uint64_t mantissa = (index & ((size_t(1) << SUB_BUCKET_BITS) - 1)) | (size_t(1) << SUB_BUCKET_BITS);
+		return mantissa << shift;
+	}
+	static uint64_t bucketHigh(size_t index)
+	{
+		if (index < (size_t(2) << SUB_BUCKET_BITS)) return index;
+		size_t shift = (index >> SUB_BUCKET_BITS) - 1;
+		return bucketLow(index) + (uint64_t(1) << shift) - 1;
+	}
+
+private:
+	std::array<uint64_t, NUM_BUCKETS> buckets_{};
+	uint64_t count_ = 0;
+	uint64_t sum_ = 0;
+	uint64_t min_ = UINT64_MAX;
+	uint64_t max_ = 0;
+};
+
+}  // namespace mu2e
+
+#endif  // ARTDAQ_CORE_MU2E_DATA_LOGLINEARHISTOGRAM_HH
@@ -0,0 +1,178 @@
+#include "artdaq-core-mu2e/Data/ROCVolumeProfiler.hh"
+
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_BitExtract.h"
+
+#include "TRACE/tracemf.h"
+#define TRACE_NAME "ROCVolumeProfiler"
+
+#include <cstring>
+#include <iomanip>
+
+namespace {
+
+template<typename T>
+void put(std::vector<uint8_t>& output, T value)
+{
+	auto pos = output.size();
+	output.resize(pos + sizeof(T));
+	memcpy(output.data() + pos, &value, sizeof(T));
+}
+
+}  // namespace
+
+mu2e::ROCVolumeProfiler::ROCVolumeProfiler(Config const& config, std::function<void(Summary const&)> onInterval)
+	: config_(config), onInterval_(std::move(onInterval)), dtcs_(NUM_DTCS)
+{
+}
+
+mu2e::ROCVolumeProfiler::~ROCVolumeProfiler() = default;
+
+void mu2e::ROCVolumeProfiler::add(DTCLib::DTC_Event const& event)
+{
+	auto now = std::chrono::steady_clock::now();
+	auto eventWindowTag = event.GetEventWindowTag().GetEventWindowTag(true);
+	if (events_ == 0)
+	{
+		start_ = now;
+		firstEventWindowTag_ = eventWindowTag;
+	}
+	last_ = now;
+	lastEventWindowTag_ = eventWindowTag;
+	++events_;
+	eventBytes_.record(event.GetEventByteCount());
+
+	for (auto& subEvent : event.GetSubEvents())
+	{
+		auto header = subEvent.GetHeader();
+		auto& dtc = dtcs_[(static_cast<size_t>(header->source_subsystem & 0x7) << 8) | header->source_dtc_id];
+		if (!dtc) dtc.reset(new DTCCounters());
+
+		for (auto& block : subEvent.GetDataBlocks())
+		{
+			if (block.byteSize < 16) continue;
+			// Link and packet count straight from the DataHeader packet (see DTC_DMAPacket and DTC_DataHeaderPacket)
+			auto bytes = static_cast<const uint8_t*>(block.GetRawBufferPointer());
+			size_t link = DTCLib::ExtractBits<24, 3>(bytes);
+			if (link >= NUM_LINKS)
+			{
+				TLOG(TLVL_DEBUG + 5) << "DataBlock from link " << link << " ignored";
+				continue;
+			}
+			auto packets = DTCLib::ExtractBits<32, 11>(bytes);
+
+			auto& roc = dtc->links[link];
+			++roc.blocks;
+			roc.bytes += block.byteSize;
+			roc.packets += packets;
+			roc.blockBytes.record(block.byteSize);
+			roc.blockPackets.record(packets);
+			bytes_ += block.byteSize;
+		}
+	}
+
+	if ((config_.intervalEvents > 0 && events_ >= config_.intervalEvents) ||
+		(config_.intervalSeconds > 0 && std::chrono::duration<double>(now - start_).count() >= config_.intervalSeconds))
+	{
+		endInterval();
+	}
+}
+
+void mu2e::ROCVolumeProfiler::flush()
+{
+	if (events_ > 0) endInterval();
+}
+
+mu2e::ROCVolumeProfiler::Summary mu2e::ROCVolumeProfiler::current() const
+{
+	Summary summary;
+	summary.interval = interval_;
+	summary.events = events_;
+	summary.bytes = bytes_;
+	summary.firstEventWindowTag = firstEventWindowTag_;
+	summary.lastEventWindowTag = lastEventWindowTag_;
+	summary.seconds = events_ > 0 ? std::chrono::duration<double>(last_ - start_).count() : 0;
+	summary.eventBytes = eventBytes_;
+
+	for (size_t ii = 0; ii < NUM_DTCS; ++ii)
+	{
+		if (!dtcs_[ii]) continue;
+		for (size_t jj = 0; jj < NUM_LINKS; ++jj)
+		{
+			auto& roc = dtcs_[ii]->links[jj];
+			if (roc.blocks == 0) continue;
+			ROCVolume volume;
+			volume.subsystem = static_cast<DTCLib::DTC_Subsystem>(ii >> 8);
+			volume.dtcID = static_cast<uint8_t>(ii & 0xFF);
+			volume.link = static_cast<uint8_t>(jj);
+			volume.blocks = roc.blocks;
+			volume.bytes = roc.bytes;
+			volume.packets = roc.packets;
+			volume.blockBytes = roc.blockBytes;
+			volume.blockPackets = roc.blockPackets;
+			summary.rocs.push_back(volume);
+		}
+	}
+	return summary;
+}
+
+void mu2e::ROCVolumeProfiler::endInterval()
+{
+	if (onInterval_) onInterval_(current());
+	TLOG(TLVL_DEBUG + 5) << "Interval " << interval_ << ": " << events_ << " events, " << bytes_ << " bytes";
+
+	++interval_;
+	events_ = 0;
+	bytes_ = 0;
+	eventBytes_.reset();
+	for (auto& dtc : dtcs_)
+	{
+		if (dtc) *dtc = DTCCounters();
+	}
+}
+
+void mu2e::ROCVolumeProfiler::writeText(std::ostream& os, Summary const& summary)
+{
+	os << "Interval " << summary.interval << ": " << summary.events << " events (EWT " << summary.firstEventWindowTag << "-" << summary.lastEventWindowTag << ") in "
+	   << summary.seconds << " s, " << summary.bytes << " bytes; event size mean " << summary.eventBytes.mean() << " p50 " << summary.eventBytes.quantile(0.5)
+	   << " p99 " << summary.eventBytes.quantile(0.99) << " max " << summary.eventBytes.max() << std::endl;
+	os << "subsys   dtc link     blocks        bytes  share%  mean_bytes  p50_bytes  p99_bytes  max_bytes  p99_packets" << std::endl;
+	for (auto& roc : summary.rocs)
+	{
+		double share = summary.bytes > 0 ? 100.0 * roc.bytes / summary.bytes : 0;
+		os << std::setw(6) << static_cast<int>(roc.subsystem) << std::setw(6) << static_cast<int>(roc.dtcID) << std::setw(5) << static_cast<int>(roc.link)
+		   << std::setw(11) << roc.blocks << std::setw(13) << roc.bytes << std::setw(8) << std::fixed << std::setprecision(2) << share
+		   << std::setw(12) << std::setprecision(1) << roc.blockBytes.mean() << std::setw(11) << roc.blockBytes.quantile(0.5) << std::setw(11) << roc.blockBytes.quantile(0.99)
+		   << std::setw(11) << roc.blockBytes.max() << std::setw(13) << roc.blockPackets.quantile(0.99) << std::defaultfloat << std::endl;
+	}
+}
+
+// Record layout: version, interval, events, bytes, first and last EWT, seconds, event size p50/p99/max, ROC count;
+// then per ROC: subsystem, DTC ID, link, blocks, bytes, packets, block size p50/p99/max, packet count p99
+void mu2e::ROCVolumeProfiler::writeBinary(std::vector<uint8_t>& output, Summary const& summary)
+{
+	put<uint32_t>(output, BINARY_VERSION);
+	put<uint64_t>(output, summary.interval);
+	put<uint64_t>(output, summary.events);
+	put<uint64_t>(output, summary.bytes);
+	put<uint64_t>(output, summary.firstEventWindowTag);
+	put<uint64_t>(output, summary.lastEventWindowTag);
+	put<double>(output, summary.seconds);
+	put<uint32_t>(output, static_cast<uint32_t>(summary.eventBytes.quantile(0.5)));
+	put<uint32_t>(output, static_cast<uint32_t>(summary.eventBytes.quantile(0.99)));
+	put<uint32_t>(output, static_cast<uint32_t>(summary.eventBytes.max()));
+	put<uint32_t>(output, static_cast<uint32_t>(summary.rocs.size()));
+	for (auto& roc : summary.rocs)
+	{
+		put<uint8_t>(output, static_cast<uint8_t>(roc.subsystem));
+		put<uint8_t>(output, roc.dtcID);
+		put<uint8_t>(output, roc.link);
+		put<uint8_t>(output, 0);
+		put<uint64_t>(output, roc.blocks);
+		put<uint64_t>(output, roc.bytes);
+		put<uint64_t>(output, roc.packets);
+		put<uint16_t>(output, static_cast<uint16_t>(roc.blockBytes.quantile(0.5)));
+		put<uint16_t>(output, static_cast<uint16_t>(roc.blockBytes.quantile(0.99)));
+		put<uint16_t>(output, static_cast<uint16_t>(roc.blockBytes.max()));
+		put<uint16_t>(output, static_cast<uint16_t>(roc.blockPackets.quantile(0.99)));
+	}
+}
@@ -0,0 +1,125 @@
+#ifndef ARTDAQ_CORE_MU2E_DATA_ROCVOLUMEPROFILER_HH
+#define ARTDAQ_CORE_MU2E_DATA_ROCVOLUMEPROFILER_HH
+
+#include "artdaq-core-mu2e/Data/LogLinearHistogram.hh"
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_Event.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+// Per-ROC data volume profile of a stream of DTC_Events, summarized at fixed intervals for event-builder load balancing.
+//
+// Notes:
+//  1) Only the byte count of each DTC_DataBlock and the packet count, link and source of its DataHeader packet are
+//     read, straight from the block bytes; no DTC_DataHeaderPacket is constructed and no payload is touched.
+//  2) For each ROC (subsystem, DTC ID and link), the profiler counts blocks, bytes and packets, and fills
+//     LogLinearHistograms of the block byte and packet counts. Event sizes are histogrammed too. Nothing is
+//     allocated per event once every DTC has been seen.
+//  3) Counts cover an interval of intervalEvents events and/or intervalSeconds seconds, whichever ends first. At
+//     the end of an interval, the Summary is passed to the callback and the counts start again from zero, so
+//     each Summary describes the recent data rather than the whole run.
+//  4) writeText prints one line per ROC, with its share of the bytes of the interval. writeBinary appends
+//     fixed-size records in host byte order (counts and quantiles only, not the buckets), for shipping to an
+//     event-builder load balancer.
+//  5) The profiler is not thread safe; each event-builder thread should use its own.
+
+namespace mu2e {
+
+class ROCVolumeProfiler
+{
+public:
+	static constexpr size_t NUM_LINKS = 6;
+	static constexpr uint32_t BINARY_VERSION = 1;
+
+	typedef LogLinearHistogram<16> BlockHistogram;  // DataBlock byte counts and packet counts are at most 16 bits
+	typedef LogLinearHistogram<24> EventHistogram;  // DTC_EventHeader byte counts are 24 bits
+
+	struct Config
+	{
+		uint64_t intervalEvents = 10000;  // Events per interval, 0 for no event limit
+		double intervalSeconds = 0;       // Seconds per interval, 0 for no time limit
+	};
+
+	struct ROCVolume
+	{
+		DTCLib::DTC_Subsystem subsystem;
+		uint8_t dtcID;
+		uint8_t link;
+		uint64_t blocks = 0;
+		uint64_t bytes = 0;
+		uint64_t packets = 0;
+		BlockHistogram blockBytes;
+		BlockHistogram blockPackets;
+	};
+
+	struct Summary
+	{
+		uint64_t interval = 0;  // Sequence number of the interval, starting at 0
+		uint64_t events = 0;
+		uint64_t bytes = 0;     // Sum of the DataBlock byte counts
+		uint64_t firstEventWindowTag = 0;
+		uint64_t lastEventWindowTag = 0;
+		double seconds = 0;     // Wall time from the first to the last event of the interval
+		EventHistogram eventBytes;
+		std::vector<ROCVolume> rocs;  // ROCs which sent at least one block, ordered by subsystem, DTC ID and link
+	};
+
+	explicit ROCVolumeProfiler(Config const& config, std::function<void(Summary const&)> onInterval = nullptr);
+	ROCVolumeProfiler()
+		: ROCVolumeProfiler(Config()) {}
+	~ROCVolumeProfiler();
+
+	ROCVolumeProfiler(ROCVolumeProfiler const&) = delete;
+	ROCVolumeProfiler& operator=(ROCVolumeProfiler const&) = delete;
+
+	// Count the DataBlocks of an event, ending the interval if it is complete
+	void add(DTCLib::DTC_Event const& event);
+	// End the current interval now, if it holds any event
+	void flush();
+	// Summary of the interval in progress
+	Summary current() const;
+
+	static void writeText(std::ostream& os, Summary const& summary);
+	static void writeBinary(std::vector<uint8_t>& output, Summary const& summary);
+
+private:
+	static constexpr size_t NUM_DTCS = 8 << 8;  // Indexed by (subsystem << 8) | DTC ID
+
+	struct ROCCounters
+	{
+		uint64_t blocks = 0;
+		uint64_t bytes = 0;
+		uint64_t packets = 0;
+		BlockHistogram blockBytes;
+		BlockHistogram blockPackets;
+	};
+
+	struct DTCCounters
+	{
+		std::array<ROCCounters, NUM_LINKS> links;
+	};
+
+	void endInterval();
+
+	Config config_;
+	std::function<void(Summary const&)> onInterval_;
+	std::vector<std::unique_ptr<DTCCounters>> dtcs_;
+
+	uint64_t interval_ = 0;
+	uint64_t events_ = 0;
+	uint64_t bytes_ = 0;
+	uint64_t firstEventWindowTag_ = 0;
+	uint64_t lastEventWindowTag_ = 0;
+	std::chrono::steady_clock::time_point start_;
+	std::chrono::steady_clock::time_point last_;
+	EventHistogram eventBytes_;
+};
+
+}  // namespace mu2e
+
+#endif  // ARTDAQ_CORE_MU2E_DATA_ROCVOLUMEPROFILER_HH
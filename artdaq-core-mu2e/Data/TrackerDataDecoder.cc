@@ -56,7 +56,7 @@ TrackerDataDecoder::tracker_data_t TrackerDataDecoder::GetTrackerData(size_t blo
 			while (packetsProcessed < dataPtr->GetHeader()->GetPacketCount())
 			{
 				output.emplace_back(pos, readWaveform ? GetWaveform(pos) : std::vector<uint16_t>());
-				auto nPackets = 1 + pos->NumADCPackets;  // TrackerDataPacket + NumADCPackets
+				auto nPackets = 1 + DTCLib::LoadAs<TrackerDataPacket>(pos).NumADCPackets;  // TrackerDataPacket + NumADCPackets
 				packetsProcessed += nPackets;
 				pos += nPackets;
 			}
@@ -69,83 +69,100 @@ TrackerDataDecoder::tracker_data_t TrackerDataDecoder::GetTrackerData(size_t blo
 
 std::vector<uint16_t> TrackerDataDecoder::GetWaveformV0(TrackerDataPacketV0 const* trackerPacket) const
 {
-	std::vector<uint16_t> output(15);
-	output[0] = trackerPacket->ADC00;
-	output[1] = trackerPacket->ADC01();
-	output[2] = trackerPacket->ADC02();
-	output[3] = trackerPacket->ADC03;
-	output[4] = trackerPacket->ADC04;
-	output[5] = trackerPacket->ADC05();
-	output[6] = trackerPacket->ADC06();
-	output[7] = trackerPacket->ADC07;
-	output[8] = trackerPacket->ADC08;
-	output[9] = trackerPacket->ADC09();
-	output[10] = trackerPacket->ADC10();
-	output[11] = trackerPacket->ADC11;
-	output[12] = trackerPacket->ADC12;
-	output[13] = trackerPacket->ADC13();
-	output[14] = trackerPacket->ADC14();
-
+	std::vector<uint16_t> output(WaveformSizeV0);
+	DecodeWaveformV0(trackerPacket, output.data());
 	return output;
 }
 
 std::vector<uint16_t> TrackerDataDecoder::GetWaveform(TrackerDataPacket const* trackerHeaderPacket) const
 {
-	auto adcs = trackerHeaderPacket->NumADCPackets;
-	std::vector<uint16_t> output(3 + 12 * adcs);
+	std::vector<uint16_t> output(WaveformSize(trackerHeaderPacket));
+	DecodeWaveform(trackerHeaderPacket, output.data());
+	return output;
+}
+
+const TrackerDataDecoder::TrackerDataPacket* TrackerDataDecoder::Upgrade(const TrackerDataDecoder::TrackerDataPacketV0* input) const
+{
+	if (input == nullptr) return nullptr;
 
-	output[0] = trackerHeaderPacket->ADC00;
-	output[1] = trackerHeaderPacket->ADC01();
-	output[2] = trackerHeaderPacket->ADC02;
+	upgraded_data_packets_.push_back(UpgradePacket(input));
+	return &upgraded_data_packets_.back();
+}
+
+void TrackerDataDecoder::DecodeWaveformV0(TrackerDataPacketV0 const* input, uint16_t* output)
+{
+	auto trackerPacket = DTCLib::LoadAs<TrackerDataPacketV0>(input);
+	output[0] = trackerPacket.ADC00;
+	output[1] = trackerPacket.ADC01();
+	output[2] = trackerPacket.ADC02();
+	output[3] = trackerPacket.ADC03;
+	output[4] = trackerPacket.ADC04;
+	output[5] = trackerPacket.ADC05();
+	output[6] = trackerPacket.ADC06();
+	output[7] = trackerPacket.ADC07;
+	output[8] = trackerPacket.ADC08;
+	output[9] = trackerPacket.ADC09();
+	output[10] = trackerPacket.ADC10();
+	output[11] = trackerPacket.ADC11;
+	output[12] = trackerPacket.ADC12;
+	output[13] = trackerPacket.ADC13();
+	output[14] = trackerPacket.ADC14();
+}
+
+void TrackerDataDecoder::DecodeWaveform(TrackerDataPacket const* input, uint16_t* output)
+{
+	auto trackerHeaderPacket = DTCLib::LoadAs<TrackerDataPacket>(input);
+	auto adcs = trackerHeaderPacket.NumADCPackets;
+
+	output[0] = trackerHeaderPacket.ADC00;
+	output[1] = trackerHeaderPacket.ADC01();
+	output[2] = trackerHeaderPacket.ADC02;
 
 	auto adcsProcessed = 0;
 	auto idx = 2;
-	auto trackerADCPacket = reinterpret_cast<TrackerADCPacket const*>(trackerHeaderPacket + 1);
+	auto adcPacketPtr = reinterpret_cast<TrackerADCPacket const*>(input + 1);
 	while (adcsProcessed < adcs)
 	{
-		output[++idx] = trackerADCPacket->ADC0;
-		output[++idx] = trackerADCPacket->ADC1();
-		output[++idx] = trackerADCPacket->ADC2;
-		output[++idx] = trackerADCPacket->ADC3;
-		output[++idx] = trackerADCPacket->ADC4();
-		output[++idx] = trackerADCPacket->ADC5;
-		output[++idx] = trackerADCPacket->ADC6;
-		output[++idx] = trackerADCPacket->ADC7();
-		output[++idx] = trackerADCPacket->ADC8;
-		output[++idx] = trackerADCPacket->ADC9;
-		output[++idx] = trackerADCPacket->ADC10();
-		output[++idx] = trackerADCPacket->ADC11;
+		auto trackerADCPacket = DTCLib::LoadAs<TrackerADCPacket>(adcPacketPtr);
+		output[++idx] = trackerADCPacket.ADC0;
+		output[++idx] = trackerADCPacket.ADC1();
+		output[++idx] = trackerADCPacket.ADC2;
+		output[++idx] = trackerADCPacket.ADC3;
+		output[++idx] = trackerADCPacket.ADC4();
+		output[++idx] = trackerADCPacket.ADC5;
+		output[++idx] = trackerADCPacket.ADC6;
+		output[++idx] = trackerADCPacket.ADC7();
+		output[++idx] = trackerADCPacket.ADC8;
+		output[++idx] = trackerADCPacket.ADC9;
+		output[++idx] = trackerADCPacket.ADC10();
+		output[++idx] = trackerADCPacket.ADC11;
 
 		adcsProcessed++;
 		if (adcsProcessed < adcs)
-			trackerADCPacket += 1;  // Go to the next packet, assuming it's a TrackerADCPacket
+			adcPacketPtr += 1;  // Go to the next packet, assuming it's a TrackerADCPacket
 	}
-
-	return output;
 }
 
-const TrackerDataDecoder::TrackerDataPacket* TrackerDataDecoder::Upgrade(const TrackerDataDecoder::TrackerDataPacketV0* input) const
+TrackerDataDecoder::TrackerDataPacket TrackerDataDecoder::UpgradePacket(const TrackerDataDecoder::TrackerDataPacketV0* raw)
 {
-	if (input == nullptr) return nullptr;
-
-	upgraded_data_packets_.emplace_back();
-	TrackerDataPacket* output = &upgraded_data_packets_.back();
-	output->StrawIndex = input->StrawIndex;
+	auto packet = DTCLib::LoadAs<TrackerDataPacketV0>(raw);
+	TrackerDataPacket output{};
+	output.StrawIndex = packet.StrawIndex;
 
-	output->TDC0A = input->TDC0;
+	output.TDC0A = packet.TDC0;
 
-	output->TDC0B = 0;
-	output->TOT0 = input->TOT0 & 0xF;
-	output->EWMCounter = 0;
+	output.TDC0B = 0;
+	output.TOT0 = packet.TOT0 & 0xF;
+	output.EWMCounter = 0;
 
-	output->TDC1A = input->TDC1;
+	output.TDC1A = packet.TDC1;
 
-	output->TDC1B = 0;
-	output->TOT1 = input->TOT1 & 0xF;
-	output->ErrorFlags = input->PreprocessingFlags & 0xF;  // Note that we're dropping 4 bits here
+	output.TDC1B = 0;
+	output.TOT1 = packet.TOT1 & 0xF;
+	output.ErrorFlags = packet.PreprocessingFlags & 0xF;  // Note that we're dropping 4 bits here
 
-	output->NumADCPackets = 1;
-	output->PMP = 0;
+	output.NumADCPackets = 1;
+	output.PMP = 0;
 
 	return output;
 }
@@ -285,6 +285,13 @@ public:
 	tracker_data_t GetTrackerData(size_t blockIndex, bool readWaveform = true) const;
 	void ClearUpgradedPackets() { upgraded_data_packets_.clear(); }
 
+	// Allocation-free decoding of single packets, also used by DTCBatchDecoder
+	static size_t WaveformSize(const TrackerDataPacket* input) { return 3 + 12 * DTCLib::LoadAs<TrackerDataPacket>(input).NumADCPackets; }
+	static constexpr size_t WaveformSizeV0 = 15;
+	static void DecodeWaveform(const TrackerDataPacket* input, uint16_t* output);      // WaveformSize(input) samples
+	static void DecodeWaveformV0(const TrackerDataPacketV0* input, uint16_t* output);  // WaveformSizeV0 samples
+	static TrackerDataPacket UpgradePacket(const TrackerDataPacketV0* input);
+
 private:
 	const TrackerDataPacket* Upgrade(const TrackerDataPacketV0* input) const;
 	std::vector<uint16_t> GetWaveformV0(const TrackerDataPacketV0* input) const;
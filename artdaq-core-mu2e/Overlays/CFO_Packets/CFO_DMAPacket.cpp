@@ -2,9 +2,6 @@
 
 #include "TRACE/trace.h"
 
-#include <iomanip>
-#include <sstream>
-
 CFOLib::CFO_DMAPacket::CFO_DMAPacket(CFO_PacketType type, 
 	//DTC_Link_ID link, 
 	uint16_t byteCount, bool valid
@@ -67,38 +64,52 @@ CFOLib::CFO_DMAPacket::CFO_DMAPacket(const CFO_DataPacket in)
 
 std::string CFOLib::CFO_DMAPacket::headerJSON() const
 {
-	std::stringstream ss;
-	ss << "\t\"byteCount\": " << std::hex << "0x" << static_cast<int>(byteCount_) << ",\n";
-	ss << "\t\"isValid\": " << valid_ << ",\n";
-	// ss << "\t\"subsystemID\": " << std::hex << "0x" << static_cast<int>(subsystemID_) << ",\n";
-	// ss << "\t\"linkID\": " << std::dec << linkID_ << ",\n";
-	ss << "\t\"packetType\": " << packetType_ << ",\n";
-	// ss << "\t\"hopCount\": " << std::hex << "0x" << static_cast<int>(hopCount_);
-
-	return ss.str();
+	DTCLib::DTC_TextBuffer buf;
+	AppendHeaderJSON(buf);
+	return buf.str();
+}
+
+void CFOLib::CFO_DMAPacket::AppendHeaderJSON(DTCLib::DTC_TextBuffer& buf) const
+{
+	buf.Append("\t\"byteCount\": 0x").Hex(byteCount_).Append(",\n");
+	buf.Append("\t\"isValid\": ").Dec(valid_).Append(",\n");
+	// The packet type has always been streamed as a raw character (CFO_PacketType is a uint8_t enum)
+	buf.Append("\t\"packetType\": ").Append(static_cast<char>(packetType_)).Append(",\n");
 }
 
 std::string CFOLib::CFO_DMAPacket::headerPacketFormat() const
 {
-	std::stringstream ss;
-	ss << std::setfill('0') << std::hex;
-	ss << "0x" << std::setw(6) << ((byteCount_ & 0xFF00) >> 8) << "\t"
-		<< "0x" << std::setw(6) << (byteCount_ & 0xFF) << std::endl;
-	ss << std::setw(1) << static_cast<int>(valid_) << " "
-		//<< std::setw(2) << std::dec << static_cast<int>(subsystemID_) << std::hex << " "
-		//<< "0x" << std::setw(2) << linkID_ 
-		<< "\t";
-	ss << "0x" << std::setw(2) << packetType_ << "0x" << std::setw(2) << 0 << std::endl;
-	return ss.str();
+	DTCLib::DTC_TextBuffer buf;
+	AppendHeaderPacketFormat(buf);
+	return buf.str();
+}
+
+void CFOLib::CFO_DMAPacket::AppendHeaderPacketFormat(DTCLib::DTC_TextBuffer& buf) const
+{
+	buf.Append("0x").Hex((byteCount_ & 0xFF00) >> 8, 6).Append("\t0x").Hex(byteCount_ & 0xFF, 6).Append('\n');
+	buf.Dec(valid_, 1).Append(" \t");
+	buf.Append("0x").Append(static_cast<char>(packetType_), 2).Append("0x").Hex(0, 2).Append('\n');
 }
 
 std::string CFOLib::CFO_DMAPacket::toJSON()
 {
-	std::stringstream ss;
-	ss << "\"DMAPacket\": {";
-	ss << headerJSON();
-	ss << "}";
-	return ss.str();
+	DTCLib::DTC_TextBuffer buf;
+	AppendJSON(buf);
+	return buf.str();
+}
+
+void CFOLib::CFO_DMAPacket::AppendJSON(DTCLib::DTC_TextBuffer& buf) const
+{
+	buf.Append("\"DMAPacket\": {");
+	AppendHeaderJSON(buf);
+	buf.Append('}');
+}
+
+std::string CFOLib::CFO_DMAPacket::toPacketFormat()
+{
+	DTCLib::DTC_TextBuffer buf;
+	AppendPacketFormat(buf);
+	return buf.str();
 }
 
-std::string CFOLib::CFO_DMAPacket::toPacketFormat() { return headerPacketFormat(); }
+void CFOLib::CFO_DMAPacket::AppendPacketFormat(DTCLib::DTC_TextBuffer& buf) const { AppendHeaderPacketFormat(buf); }
@@ -4,6 +4,8 @@
 #include "artdaq-core-mu2e/Overlays/CFO_Packets/CFO_DataPacket.h"
 #include "artdaq-core-mu2e/Overlays/CFO_Packets/CFO_PacketType.h"
 
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_TextBuffer.h"
+
 #include <cstdint>
 #include <ostream>
 #include <string>
@@ -103,6 +105,16 @@ public:
 	/// </summary>
 	/// <returns>"packet format" string representation of DMA header information</returns>
 	std::string headerPacketFormat() const;
+	/// <summary>
+	/// Append the DMA Header in JSON to the given buffer (See headerJSON())
+	/// </summary>
+	/// <param name="buf">Buffer to append to</param>
+	void AppendHeaderJSON(DTCLib::DTC_TextBuffer& buf) const;
+	/// <summary>
+	/// Append the DMA header in "packet format" to the given buffer (See headerPacketFormat())
+	/// </summary>
+	/// <param name="buf">Buffer to append to</param>
+	void AppendHeaderPacketFormat(DTCLib::DTC_TextBuffer& buf) const;
 
 	/// <summary>
 	/// Returns if the CFO thinks the packet is valid
@@ -152,6 +164,16 @@ public:
 	/// </summary>
 	/// <returns>JSON-formatted string representation of DMA packet</returns>
 	virtual std::string toJSON();
+	/// <summary>
+	/// Append the "packet format" representation of the packet to the given buffer (See toPacketFormat())
+	/// </summary>
+	/// <param name="buf">Buffer to append to</param>
+	virtual void AppendPacketFormat(DTCLib::DTC_TextBuffer& buf) const;
+	/// <summary>
+	/// Append the JSON representation of the packet to the given buffer (See toJSON())
+	/// </summary>
+	/// <param name="buf">Buffer to append to</param>
+	virtual void AppendJSON(DTCLib::DTC_TextBuffer& buf) const;
 
 	/// <summary>
 	/// Stream the JSON representation of the CFO_DMAPacket to the given stream
@@ -1,7 +1,6 @@
 #include "artdaq-core-mu2e/Overlays/CFO_Packets/CFO_DataPacket.h"
 
-#include <iomanip>
-#include <sstream>
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_BitExtract.h"
 
 CFOLib::CFO_DataPacket::CFO_DataPacket()
 {
@@ -65,32 +64,37 @@ bool CFOLib::CFO_DataPacket::Resize(const uint16_t dmaSize)
 
 std::string CFOLib::CFO_DataPacket::toJSON() const
 {
-	std::stringstream ss;
-	ss << "\"DataPacket\": {";
-	ss << "\"data\": [";
-	ss << std::hex << std::setfill('0');
+	DTCLib::DTC_TextBuffer buf;
+	AppendJSON(buf);
+	return buf.str();
+}
+
+void CFOLib::CFO_DataPacket::AppendJSON(DTCLib::DTC_TextBuffer& buf) const
+{
+	buf.Append("\"DataPacket\": {\"data\": [");
 	uint16_t jj = 0;
 	for (uint16_t ii = 0; ii < dataSize_ - 2; ii += 2)
 	{
-		ss << "0x" << std::setw(4) << static_cast<int>(reinterpret_cast<uint16_t const*>(dataPtr_)[jj]) << ",";
+		buf.Append("0x").Hex(DTCLib::LoadLE<uint16_t>(dataPtr_ + 2 * jj), 4).Append(',');
 		++jj;
 	}
-	ss << "0x" << std::setw(4) << static_cast<int>(reinterpret_cast<uint16_t const*>(dataPtr_)[jj]) << "]";
-	ss << "}";
-	return ss.str();
+	buf.Append("0x").Hex(DTCLib::LoadLE<uint16_t>(dataPtr_ + 2 * jj), 4).Append("]}");
 }
 
 std::string CFOLib::CFO_DataPacket::toPacketFormat() const
 {
-	std::stringstream ss;
-	ss << std::setfill('0') << std::hex;
+	DTCLib::DTC_TextBuffer buf;
+	AppendPacketFormat(buf);
+	return buf.str();
+}
+
+void CFOLib::CFO_DataPacket::AppendPacketFormat(DTCLib::DTC_TextBuffer& buf) const
+{
 	for (uint16_t ii = 0; ii < dataSize_ - 1; ii += 2)
 	{
-		ss << "0x" << std::setw(2) << static_cast<int>(dataPtr_[ii + 1]) << " ";
-		ss << "" << std::setw(2) << static_cast<int>(dataPtr_[ii]) << "\n";
+		buf.Append("0x").Hex(dataPtr_[ii + 1], 2).Append(' ');
+		buf.Hex(dataPtr_[ii], 2).Append('\n');
 	}
-	ss << std::dec;
-	return ss.str();
 }
 
 bool CFOLib::CFO_DataPacket::Equals(const CFO_DataPacket& other) const
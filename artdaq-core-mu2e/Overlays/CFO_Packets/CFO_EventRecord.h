@@ -1,6 +1,8 @@
 #ifndef artdaq_core_mu2e_Overlays_CFO_Packets_CFO_EventRecord_h
 #define artdaq_core_mu2e_Overlays_CFO_Packets_CFO_EventRecord_h
 
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_TextBuffer.h"
+
 #include <cstdint>  // uint8_t, uint16_t
 #include <iomanip>
 #include <sstream>
@@ -61,23 +63,26 @@ struct CFO_EventRecord
 
 	inline std::string toJson() const
 	{
-		std::ostringstream oss;
-
-		oss << "\"CFO_EventRecord\": {\n";
-		oss << "\t\"record_format_version\": 0x" <<  std::hex << record_format_version << std::dec;
-		oss << ",\n\t\"event_tag\": " << event_tag << "(0x" <<  std::hex << event_tag << std::dec << ")";
-		oss << ",\n\t\"linux_timestamp\": " << linux_timestamp;
-		oss << ",\n\t\"event_mode\": 0x" << std::hex << event_mode << std::dec;
-		oss << ",\n\t\"event_duration\": " << event_duration;
-		oss << ",\n\t\"TDC_marker_N_from_spill\": " << TDC_marker_N_from_spill;
-		oss << ",\n\t\"DR_marker_N_est\": " << DR_marker_N_est;
-		oss << ",\n\t\"DR_marker_Nplus1_est\": " << DR_marker_Nplus1_est;
-		oss << ",\n\t\"DR_marker_N_meas\": " << DR_marker_N_meas;
-		oss << ",\n\t\"DR_marker_Nplus1_meas\": " << DR_marker_Nplus1_meas;
-		oss << "\n}";
-
-		return oss.str();
+		DTCLib::DTC_TextBuffer buf;
+		AppendJson(buf);
+		return buf.str();
 	} //end toJson()
+
+	inline void AppendJson(DTCLib::DTC_TextBuffer& buf) const
+	{
+		buf.Append("\"CFO_EventRecord\": {\n");
+		buf.Append("\t\"record_format_version\": 0x").Hex(record_format_version);
+		buf.Append(",\n\t\"event_tag\": ").Dec(event_tag).Append("(0x").Hex(event_tag).Append(')');
+		buf.Append(",\n\t\"linux_timestamp\": ").Dec(linux_timestamp);
+		buf.Append(",\n\t\"event_mode\": 0x").Hex(event_mode);
+		buf.Append(",\n\t\"event_duration\": ").Dec(event_duration);
+		buf.Append(",\n\t\"TDC_marker_N_from_spill\": ").Dec(TDC_marker_N_from_spill);
+		buf.Append(",\n\t\"DR_marker_N_est\": ").Dec(DR_marker_N_est);
+		buf.Append(",\n\t\"DR_marker_Nplus1_est\": ").Dec(DR_marker_Nplus1_est);
+		buf.Append(",\n\t\"DR_marker_N_meas\": ").Dec(DR_marker_N_meas);
+		buf.Append(",\n\t\"DR_marker_Nplus1_meas\": ").Dec(DR_marker_Nplus1_meas);
+		buf.Append("\n}");
+	} //end AppendJson()
 };
 
 }  // namespace CFOLib
@@ -1 +1,416 @@
-#include "artdaq-core-mu2e/Overlays/DTCEventFragment.hh"
\ No newline at end of file
+#include "artdaq-core-mu2e/Overlays/DTCEventFragment.hh"
+
+#include "artdaq-core-mu2e/Overlays/DTC_Types/Exceptions.h"
+#include "artdaq-core-mu2e/Overlays/FragmentType.hh"
+
+#include "TRACE/tracemf.h"
+
+#include <algorithm>
+
+mu2e::DTCEventFragment::DTCEventFragment(artdaq::Fragment const& f)
+	: artdaq_Fragment_(f)
+{
+	if (isBatched() && !eventTableFits(artdaq_Fragment_))
+	{
+		auto md = artdaq_Fragment_.metadata<Metadata>();
+		TLOG(TLVL_ERROR) << "Event table of " << md->event_count << " entries at offset " << md->table_offset << " is outside of the Fragment";
+		throw DTCLib::DTC_WrongPacketSizeException(artdaq_Fragment_.dataSizeBytes(), md->table_offset + md->event_count * sizeof(EventTableEntry));
+	}
+	events_.reset(new CachedEvent[eventCount()]);
+}
+
+bool mu2e::DTCEventFragment::eventTableFits(artdaq::Fragment const& f)
+{
+	// Written so that corrupt metadata cannot overflow the comparison
+	auto md = f.metadata<Metadata>();
+	return md->table_offset <= f.dataSizeBytes() && md->event_count <= (f.dataSizeBytes() - md->table_offset) / sizeof(EventTableEntry);
+}
+
+void mu2e::DTCEventFragment::setupEvent(size_t idx) const
+{
+	auto& cached = events_[idx];
+	const void* data = artdaq_Fragment_.dataBeginBytes();
+	if (isBatched())
+	{
+		auto md = artdaq_Fragment_.metadata<Metadata>();
+		if (idx >= md->event_count || !eventTableFits(artdaq_Fragment_))
+		{
+			TLOG(TLVL_ERROR) << "Event table entry " << idx << " of " << md->event_count << " at offset " << md->table_offset << " is outside of the Fragment";
+			throw DTCLib::DTC_WrongPacketSizeException(artdaq_Fragment_.dataSizeBytes(), md->table_offset + md->event_count * sizeof(EventTableEntry));
+		}
+		auto& entry = eventTable()[idx];
+		if (entry.offset + static_cast<uint64_t>(entry.byte_count) > md->table_offset)
+		{
+			TLOG(TLVL_ERROR) << "Event table entry " << idx << " (offset " << entry.offset << ", " << entry.byte_count << " bytes) is outside of the event data";
+			throw DTCLib::DTC_WrongPacketSizeException(md->table_offset, entry.offset + static_cast<uint64_t>(entry.byte_count));
+		}
+		data = artdaq_Fragment_.dataBeginBytes() + entry.offset;
+
+		if (idx > 0 && hasCompressedHeaders())
+		{
+			// The first event is stored unchanged and is the template of the others
+			std::call_once(headerCodecOnce_, [this] { headerCodec_.reset(new DTCLib::DTC_HeaderDeltaCodec(artdaq_Fragment_.dataBeginBytes() + eventTable()[0].offset)); });
+			cached.decoded_bytes.clear();
+			headerCodec_->DecodeEvent(data, entry.byte_count, cached.decoded_bytes);
+			data = cached.decoded_bytes.data();
+		}
+	}
+
+	if (DTCLib::DTC_TrackerBlockCodec::HasCompressedBlocks(data))
+	{
+		// Compressed tracker blocks are expanded once; the DTC_Event then refers to the decoded copy
+		std::vector<uint8_t> decoded;
+		DTCLib::DTC_TrackerBlockCodec::DecodeEvent(data, decoded);
+		cached.decoded_bytes.swap(decoded);
+		data = cached.decoded_bytes.data();
+	}
+	cached.event.reset(new DTCLib::DTC_Event(data));
+	cached.event->SetupEvent();
+}
+
+DTCLib::DTC_EventWindowTag mu2e::DTCEventFragment::getEventWindowTag(size_t idx) const
+{
+	if (idx >= eventCount()) throw std::out_of_range("Index " + std::to_string(idx) + " is out of range (event count: " + std::to_string(eventCount()) + ")");
+	if (isBatched())
+	{
+		return DTCLib::DTC_EventWindowTag(eventTable()[idx].event_window_tag);
+	}
+
+	DTCLib::DTC_EventHeader header;
+	memcpy(&header, artdaq_Fragment_.dataBeginBytes(), sizeof(header));
+	return DTCLib::DTC_EventWindowTag(header.event_tag_low, header.event_tag_high);
+}
+
+size_t mu2e::DTCEventFragment::compressHeaders(artdaq::Fragment& f)
+{
+	if (!isBatched(f) || hasCompressedHeaders(f))
+	{
+		throw cet::exception("DTCEventFragment") << "compressHeaders needs a batched Fragment (see packEvents) whose headers are not compressed yet";
+	}
+
+	auto md = *f.metadata<Metadata>();
+	if (!eventTableFits(f))
+	{
+		TLOG(TLVL_ERROR) << "Event table of " << md.event_count << " entries at offset " << md.table_offset << " is outside of the Fragment";
+		throw DTCLib::DTC_WrongPacketSizeException(f.dataSizeBytes(), md.table_offset + md.event_count * sizeof(EventTableEntry));
+	}
+	auto in = f.dataBeginBytes();
+	auto inTable = reinterpret_cast<EventTableEntry const*>(in + md.table_offset);
+	std::vector<EventTableEntry> table(inTable, inTable + md.event_count);
+	for (size_t ii = 0; ii < table.size(); ++ii)
+	{
+		DTCLib::DTC_EventHeader header;
+		if (table[ii].offset + static_cast<uint64_t>(table[ii].byte_count) > md.table_offset || table[ii].byte_count < sizeof(header))
+		{
+			TLOG(TLVL_ERROR) << "Event table entry " << ii << " (offset " << table[ii].offset << ", " << table[ii].byte_count << " bytes) is outside of the Fragment";
+			throw DTCLib::DTC_WrongPacketSizeException(md.table_offset, table[ii].offset + table[ii].byte_count);
+		}
+		memcpy(&header, in + table[ii].offset, sizeof(header));
+		if (header.inclusive_event_byte_count != table[ii].byte_count)
+		{
+			TLOG(TLVL_ERROR) << "Event " << ii << " has " << header.inclusive_event_byte_count << " bytes, but its table entry says " << table[ii].byte_count;
+			throw DTCLib::DTC_WrongPacketSizeException(table[ii].byte_count, header.inclusive_event_byte_count);
+		}
+	}
+
+	std::vector<uint8_t> encoded;
+	encoded.reserve(f.dataSizeBytes());
+	if (!table.empty())
+	{
+		DTCLib::DTC_HeaderDeltaCodec codec(in + table[0].offset);
+		for (size_t ii = 0; ii < table.size(); ++ii)
+		{
+			auto event = in + table[ii].offset;
+			table[ii].offset = encoded.size();
+			if (ii == 0)
+				encoded.insert(encoded.end(), event, event + table[ii].byte_count);
+			else
+				table[ii].byte_count = codec.EncodeEvent(event, encoded);
+			encoded.resize((encoded.size() + 7) & ~size_t(7), 0);
+		}
+	}
+	md.version = HEADER_DELTA_VERSION;
+	md.table_offset = encoded.size();
+	auto tableBytes = reinterpret_cast<const uint8_t*>(table.data());
+	encoded.insert(encoded.end(), tableBytes, tableBytes + table.size() * sizeof(EventTableEntry));
+
+	TLOG(TLVL_DEBUG + 5) << "Compressed the headers of " << table.size() << " DTC_Events from " << f.dataSizeBytes() << " to " << encoded.size() << " bytes";
+	f.resizeBytes(encoded.size());
+	memcpy(f.dataBeginBytes(), encoded.data(), encoded.size());
+	f.updateMetadata(md);
+	return encoded.size();
+}
+
+std::unique_ptr<artdaq::Fragment> mu2e::DTCEventFragment::slice(artdaq::Fragment const& f, SliceSelection const& selection)
+{
+	struct ByteRange
+	{
+		size_t offset;
+		size_t size;
+		bool emptyBlock;  // Copy only the DTC_DataHeaderPacket, with its packet count cleared
+	};
+	struct SubEventSlice
+	{
+		size_t headerOffset;
+		size_t firstRange;
+		size_t rangeCount;
+		size_t bytes;
+		size_t rocs;
+	};
+
+	if (isBatched(f))
+	{
+		throw cet::exception("DTCEventFragment") << "slice does not support batched Fragments";
+	}
+
+	auto in = f.dataBeginBytes();
+	DTCLib::DTC_EventHeader eventHeader;
+	if (f.dataSizeBytes() < sizeof(eventHeader))
+	{
+		TLOG(TLVL_ERROR) << "Fragment is too small (" << f.dataSizeBytes() << " bytes) to hold a DTC_Event";
+		throw DTCLib::DTC_WrongPacketSizeException(sizeof(eventHeader), f.dataSizeBytes());
+	}
+	memcpy(&eventHeader, in, sizeof(eventHeader));
+	size_t eventSize = eventHeader.inclusive_event_byte_count;
+	if (eventSize < sizeof(eventHeader) || eventSize > f.dataSizeBytes())
+	{
+		TLOG(TLVL_ERROR) << "DTC_Event byte count " << eventSize << " does not fit in Fragment of " << f.dataSizeBytes() << " bytes";
+		throw DTCLib::DTC_WrongPacketSizeException(f.dataSizeBytes(), eventSize);
+	}
+
+	// First pass: find the byte ranges to keep
+	std::vector<ByteRange> ranges;
+	std::vector<SubEventSlice> subEvents;
+	size_t offset = sizeof(eventHeader);
+	while (offset < eventSize)
+	{
+		DTCLib::DTC_SubEventHeader subEventHeader;
+		memcpy(&subEventHeader, in + offset, sizeof(subEventHeader));
+		size_t subEventSize = subEventHeader.inclusive_subevent_byte_count;
+		if (subEventSize < sizeof(subEventHeader) || offset + subEventSize > eventSize)
+		{
+			TLOG(TLVL_ERROR) << "Invalid sub event byte count " << subEventSize << " at offset " << offset;
+			throw DTCLib::DTC_WrongPacketSizeException(sizeof(subEventHeader), subEventSize);
+		}
+
+		auto subsystem = static_cast<DTCLib::DTC_Subsystem>(subEventHeader.source_subsystem);
+		if ((!selection.subsystems.empty() && !selection.subsystems.count(subsystem)) ||
+			(!selection.dtcIDs.empty() && !selection.dtcIDs.count(subEventHeader.source_dtc_id)))
+		{
+			offset += subEventSize;
+			continue;
+		}
+
+		SubEventSlice subEvent{offset, ranges.size(), 0, 0, 0};
+		if (selection.links.empty())
+		{
+			subEvent.bytes = subEventSize - sizeof(subEventHeader);
+			subEvent.rocs = subEventHeader.num_rocs;
+			if (subEvent.bytes > 0) ranges.push_back({offset + sizeof(subEventHeader), subEvent.bytes, false});
+		}
+		else
+		{
+			// SetupSubEvent expects the data block from link N at index N, so deselected blocks in front of a selected
+			// one are kept as empty blocks (header only), and blocks after the last selected one are dropped
+			size_t keptRanges = ranges.size();
+			size_t keptBytes = 0;
+			size_t keptRocs = 0;
+			size_t subOffset = sizeof(subEventHeader);
+			while (subOffset < subEventSize)
+			{
+				auto blockOffset = offset + subOffset;
+				auto block = in + blockOffset;
+				size_t blockSize = block[0] + (block[1] << 8);
+				if (blockSize < 16 || subOffset + blockSize > subEventSize)
+				{
+					TLOG(TLVL_ERROR) << "Invalid data block byte count " << blockSize << " at offset " << blockOffset;
+					throw DTCLib::DTC_WrongPacketSizeException(16, blockSize);
+				}
+
+				auto link = static_cast<DTCLib::DTC_Link_ID>(block[3] & 0x7);
+				if (selection.links.count(link))
+				{
+					// Adjacent selected blocks are copied as one range
+					if (ranges.size() > subEvent.firstRange && !ranges.back().emptyBlock && ranges.back().offset + ranges.back().size == blockOffset)
+						ranges.back().size += blockSize;
+					else
+						ranges.push_back({blockOffset, blockSize, false});
+					subEvent.bytes += blockSize;
+					++subEvent.rocs;
+
+					keptRanges = ranges.size();
+					keptBytes = subEvent.bytes;
+					keptRocs = subEvent.rocs;
+				}
+				else
+				{
+					ranges.push_back({blockOffset, 16, true});
+					subEvent.bytes += 16;
+					++subEvent.rocs;
+				}
+				subOffset += blockSize;
+			}
+			ranges.resize(keptRanges);
+			subEvent.bytes = keptBytes;
+			subEvent.rocs = keptRocs;
+		}
+		subEvent.rangeCount = ranges.size() - subEvent.firstRange;
+
+		if (subEvent.rocs > 0 || selection.keepEmptySubEvents) subEvents.push_back(subEvent);
+		offset += subEventSize;
+	}
+
+	size_t sliceSize = sizeof(eventHeader);
+	for (auto& subEvent : subEvents)
+	{
+		sliceSize += sizeof(DTCLib::DTC_SubEventHeader) + subEvent.bytes;
+	}
+
+	// Second pass: copy the selected ranges and patch the headers
+	auto output = artdaq::Fragment::FragmentBytes(sliceSize);
+	output->setSequenceID(f.sequenceID());
+	output->setFragmentID(f.fragmentID());
+	output->setUserType(f.type());
+	output->setTimestamp(f.timestamp());
+
+	auto out = output->dataBeginBytes();
+	eventHeader.inclusive_event_byte_count = sliceSize;
+	eventHeader.num_dtcs = subEvents.size();
+	memcpy(out, &eventHeader, sizeof(eventHeader));
+	auto pos = sizeof(eventHeader);
+
+	for (auto& subEvent : subEvents)
+	{
+		DTCLib::DTC_SubEventHeader subEventHeader;
+		memcpy(&subEventHeader, in + subEvent.headerOffset, sizeof(subEventHeader));
+		subEventHeader.inclusive_subevent_byte_count = sizeof(subEventHeader) + subEvent.bytes;
+		subEventHeader.num_rocs = subEvent.rocs;
+		memcpy(out + pos, &subEventHeader, sizeof(subEventHeader));
+		pos += sizeof(subEventHeader);
+
+		for (size_t ii = subEvent.firstRange; ii < subEvent.firstRange + subEvent.rangeCount; ++ii)
+		{
+			memcpy(out + pos, in + ranges[ii].offset, ranges[ii].size);
+			if (ranges[ii].emptyBlock)
+			{
+				// An empty block has no payload to decompress, so it must not be flagged as compressed
+				if (DTCLib::DTC_TrackerBlockCodec::IsCompressed(out + pos)) out[pos + 13] &= ~DTCLib::DTC_TrackerBlockCodec::COMPRESSED_VERSION_FLAG;
+				out[pos] = 16;
+				out[pos + 1] = 0;
+				out[pos + 4] = 0;
+				out[pos + 5] &= 0xF8;
+			}
+			pos += ranges[ii].size;
+		}
+	}
+	// Fragment payloads are whole words; clear the padding after the event
+	memset(out + pos, 0, output->dataSizeBytes() - pos);
+
+	TLOG(TLVL_DEBUG + 5) << "Sliced DTC_Event of " << eventSize << " bytes to " << sliceSize << " bytes, keeping " << subEvents.size() << " sub events";
+	return output;
+}
+
+std::unique_ptr<mu2e::DTCEventFragment> mu2e::DTCEventFragment::fromDMABuffers(artdaq::FragmentPtrs& frags, std::vector<const void*> const& dmaBuffers,
+																			  artdaq::Fragment::sequence_id_t sequenceID, artdaq::Fragment::fragment_id_t fragmentID,
+																			  artdaq::Fragment::timestamp_t timestamp)
+{
+	std::unique_ptr<artdaq::Fragment> frag{nullptr};
+	size_t eventSize = 0;
+	size_t copied = 0;
+	for (auto buffer : dmaBuffers)
+	{
+		auto ptr = static_cast<const uint8_t*>(buffer);
+		uint64_t dmaSize;
+		memcpy(&dmaSize, ptr, sizeof(dmaSize));
+		if (dmaSize < sizeof(uint64_t) || dmaSize > static_cast<uint64_t>(DTCLib::DTC_Event::MAX_DMA_SIZE))
+		{
+			TLOG(TLVL_ERROR) << "Invalid DMA transfer byte count " << dmaSize << " in buffer " << (frag ? "continuing" : "starting") << " DTC_Event";
+			throw DTCLib::DTC_WrongPacketSizeException(DTCLib::DTC_Event::MAX_DMA_SIZE, dmaSize);
+		}
+		ptr += sizeof(uint64_t);
+		size_t bufferSize = dmaSize - sizeof(uint64_t);
+
+		if (frag == nullptr)
+		{
+			DTCLib::DTC_EventHeader header;
+			if (bufferSize < sizeof(header))
+			{
+				TLOG(TLVL_ERROR) << "First DMA buffer of " << bufferSize << " bytes is too small to hold a DTC_EventHeader";
+				throw DTCLib::DTC_WrongPacketSizeException(sizeof(header), bufferSize);
+			}
+			memcpy(&header, ptr, sizeof(header));
+			eventSize = header.inclusive_event_byte_count;
+			if (eventSize < sizeof(header))
+			{
+				TLOG(TLVL_ERROR) << "Invalid DTC_Event byte count " << eventSize;
+				throw DTCLib::DTC_WrongPacketSizeException(sizeof(header), eventSize);
+			}
+
+			// The payload is not initialized; only the padding after the event is cleared
+			frag = artdaq::Fragment::FragmentBytes(eventSize);
+			frag->setSequenceID(sequenceID);
+			frag->setFragmentID(fragmentID);
+			frag->setUserType(FragmentType::DTCEVT);
+			frag->setTimestamp(timestamp);
+			memset(frag->dataBeginBytes() + eventSize, 0, frag->dataSizeBytes() - eventSize);
+		}
+
+		auto bytes = std::min(bufferSize, eventSize - copied);
+		memcpy(frag->dataBeginBytes() + copied, ptr, bytes);
+		copied += bytes;
+		if (copied == eventSize) break;
+	}
+
+	if (frag == nullptr || copied < eventSize)
+	{
+		TLOG(TLVL_ERROR) << "DMA buffers hold " << copied << " bytes of a DTC_Event of " << eventSize << " bytes";
+		throw DTCLib::DTC_WrongPacketSizeException(eventSize, copied);
+	}
+
+	frags.emplace_back(std::move(frag));
+	auto overlay = std::make_unique<DTCEventFragment>(*frags.back());
+	overlay->getData();
+	return overlay;
+}
+
+std::unique_ptr<artdaq::Fragment> mu2e::DTCEventFragment::packEvents(std::vector<const void*> const& events, artdaq::Fragment::sequence_id_t sequenceID,
+																	 artdaq::Fragment::fragment_id_t fragmentID, artdaq::Fragment::timestamp_t timestamp)
+{
+	std::vector<EventTableEntry> table;
+	table.reserve(events.size());
+	size_t offset = 0;
+	for (auto event : events)
+	{
+		DTCLib::DTC_EventHeader header;
+		memcpy(&header, event, sizeof(header));
+		if (header.inclusive_event_byte_count < sizeof(header))
+		{
+			TLOG(TLVL_ERROR) << "Invalid DTC_Event byte count " << header.inclusive_event_byte_count << " for event " << table.size();
+			throw DTCLib::DTC_WrongPacketSizeException(sizeof(header), header.inclusive_event_byte_count);
+		}
+		EventTableEntry entry;
+		entry.event_window_tag = DTCLib::DTC_EventWindowTag(header.event_tag_low, header.event_tag_high).GetEventWindowTag(true);
+		entry.offset = offset;
+		entry.byte_count = header.inclusive_event_byte_count;
+		table.push_back(entry);
+		offset += (entry.byte_count + 7) & ~size_t(7);
+	}
+
+	Metadata md;
+	md.version = CURRENT_VERSION;
+	md.event_count = table.size();
+	md.table_offset = offset;
+
+	auto frag = artdaq::Fragment::FragmentBytes(offset + table.size() * sizeof(EventTableEntry), sequenceID, fragmentID, FragmentType::DTCEVT, md, timestamp);
+	auto out = frag->dataBeginBytes();
+	for (size_t ii = 0; ii < events.size(); ++ii)
+	{
+		auto padded = (table[ii].byte_count + 7) & ~size_t(7);
+		memcpy(out + table[ii].offset, events[ii], table[ii].byte_count);
+		memset(out + table[ii].offset + table[ii].byte_count, 0, padded - table[ii].byte_count);
+	}
+	if (!table.empty()) memcpy(out + offset, table.data(), table.size() * sizeof(EventTableEntry));
+
+	TLOG(TLVL_DEBUG + 5) << "Packed " << table.size() << " DTC_Events into a Fragment of " << frag->dataSizeBytes() << " bytes";
+	return frag;
+}
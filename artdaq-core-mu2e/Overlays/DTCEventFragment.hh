@@ -1,9 +1,16 @@
 #ifndef artdaq_core_Data_Mu2eEventFragment_hh
 #define artdaq_core_Data_Mu2eEventFragment_hh
 
+#include <cstring>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
 #include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_Event.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_HeaderDeltaCodec.h"
 #include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_SubEvent.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_TrackerBlockCodec.h"
 #include "artdaq-core/Data/Fragment.hh"
 #include "cetlib_except/exception.h"
 
@@ -18,42 +25,297 @@ class DTCEventFragment;
 
 /**
  * \brief The artdaq::DTCEventFragment class represents a Fragment which contains one or more DTC_Events
+ *
+ * A Fragment without Metadata holds a single DTC_Event at the start of its payload. A batched Fragment (see
+ * packEvents) holds several DTC_Events, followed by an EventTableEntry per event; its Metadata locates the table.
+ * The headers of the events of a batched Fragment can be delta-encoded relative to its first event (see compressHeaders).
  */
 class mu2e::DTCEventFragment
 {
 public:
 	/// The current version of the DTCEventFragment
 	static constexpr uint8_t CURRENT_VERSION = 1;
+	/// Metadata version of a batched DTCEventFragment whose events after the first have delta-encoded headers
+	static constexpr uint8_t HEADER_DELTA_VERSION = 2;
+
+	/**
+	 * \brief Metadata of a batched DTCEventFragment
+	 */
+	struct Metadata
+	{
+		uint32_t version;       ///< Version of the batched layout (CURRENT_VERSION or HEADER_DELTA_VERSION)
+		uint32_t event_count;   ///< Number of DTC_Events in the Fragment
+		uint64_t table_offset;  ///< Offset of the EventTableEntry table from the start of the payload, in bytes
+
+		static size_t const size_words = 16;  ///< Size of the Metadata struct, in bytes
+	};
+	static_assert(sizeof(Metadata) == Metadata::size_words, "Metadata size changed!");
+
+	/**
+	 * \brief Entry of the event table of a batched DTCEventFragment
+	 */
+	struct EventTableEntry
+	{
+		uint64_t event_window_tag;  ///< Event Window Tag of the DTC_Event
+		uint32_t offset;            ///< Offset of the DTC_EventHeader from the start of the payload, in bytes
+		uint32_t byte_count;        ///< inclusive_event_byte_count of the DTC_Event, or its encoded size if the headers are compressed
+	};
+
+	/**
+	 * \brief Forward iterator over the DTC_Events of a DTCEventFragment
+	 */
+	class const_iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;  ///< Iterator category
+		using value_type = DTCLib::DTC_Event;                 ///< Value type
+		using difference_type = std::ptrdiff_t;               ///< Difference type
+		using pointer = const DTCLib::DTC_Event*;             ///< Pointer type
+		using reference = const DTCLib::DTC_Event&;           ///< Reference type
+
+		/**
+		 * \param frag The overlay to iterate over
+		 * \param idx Index of the event
+		 */
+		const_iterator(DTCEventFragment const* frag, size_t idx)
+			: frag_(frag), idx_(idx) {}
+
+		reference operator*() const { return frag_->getEvent(idx_); }    ///< Set up (if needed) and access the event
+		pointer operator->() const { return &frag_->getEvent(idx_); }  ///< Member access
+		const_iterator& operator++()                                   ///< Advance to the next event
+		{
+			++idx_;
+			return *this;
+		}
+		const_iterator operator++(int)  ///< Advance to the next event
+		{
+			auto tmp = *this;
+			++idx_;
+			return tmp;
+		}
+		bool operator==(const_iterator const& other) const { return idx_ == other.idx_; }  ///< Compare positions
+		bool operator!=(const_iterator const& other) const { return idx_ != other.idx_; }  ///< Compare positions
+
+	private:
+		DTCEventFragment const* frag_;
+		size_t idx_;
+	};
+
+	/**
+	 * \brief Selects the sub-events and ROC data blocks kept by slice(). An empty set selects everything.
+	 */
+	struct SliceSelection
+	{
+		std::set<DTCLib::DTC_Subsystem> subsystems;  ///< Subsystems of the sub-events to keep
+		std::set<uint8_t> dtcIDs;                    ///< Source DTC IDs of the sub-events to keep
+		std::set<DTCLib::DTC_Link_ID> links;         ///< Links of the ROC data blocks to keep
+		bool keepEmptySubEvents{false};              ///< Keep selected sub-events even if no data block is left
+	};
 
 	/**
 	 * \param f The Fragment object to use for data storage
 	 *
-	 * The constructor simply sets its const private member "artdaq_Fragment_"
-	 * to refer to the artdaq::Fragment object
+	 * The constructor sets its const private member "artdaq_Fragment_"
+	 * to refer to the artdaq::Fragment object. If f is batched, it throws
+	 * DTCLib::DTC_WrongPacketSizeException unless the event table lies inside the Fragment.
 	 */
-	explicit DTCEventFragment(artdaq::Fragment const& f)
-		: artdaq_Fragment_(f) {}
+	explicit DTCEventFragment(artdaq::Fragment const& f);
 
 	virtual ~DTCEventFragment()
 	{
 	}
 
-	DTCLib::DTC_Event getData() const 
+	/**
+	 * \brief Access the (first) DTC_Event stored in the Fragment, setting it up on first use
+	 * \return Reference to the DTC_Event, valid as long as this overlay
+	 */
+	DTCLib::DTC_Event const& getData() const 
+	{
+		return getEvent(0);
+	}
+
+	/**
+	 * \brief Whether the Fragment was built by packEvents
+	 * \return True if the Fragment has DTCEventFragment Metadata
+	 */
+	bool isBatched() const { return isBatched(artdaq_Fragment_); }
+
+	/**
+	 * \brief Number of DTC_Events in the Fragment
+	 * \return Event count from the Metadata, or 1 if the Fragment is not batched
+	 */
+	size_t eventCount() const { return isBatched() ? artdaq_Fragment_.metadata<Metadata>()->event_count : 1; }
+
+	/**
+	 * \brief Whether the event headers of the Fragment are delta-encoded (see compressHeaders)
+	 * \return True if the Fragment is batched with HEADER_DELTA_VERSION
+	 */
+	bool hasCompressedHeaders() const { return hasCompressedHeaders(artdaq_Fragment_); }
+
+	/**
+	 * \brief Access one DTC_Event stored in the Fragment, setting it up on first use
+	 * \param idx Index of the event
+	 * \return Reference to the DTC_Event, valid as long as this overlay
+	 */
+	DTCLib::DTC_Event const& getEvent(size_t idx) const
+	{
+		if (idx >= eventCount()) throw std::out_of_range("Index " + std::to_string(idx) + " is out of range (event count: " + std::to_string(eventCount()) + ")");
+		// Each event is set up exactly once, even if several threads read the same const overlay. If setupEvent
+		// throws, the next call tries again.
+		std::call_once(events_[idx].once, &DTCEventFragment::setupEvent, this, idx);
+		return *events_[idx].event;
+	}
+
+	/**
+	 * \brief Get the Event Window Tag of one DTC_Event without setting it up
+	 * \param idx Index of the event
+	 * \return Event Window Tag from the event table, or from the DTC_EventHeader if the Fragment is not batched
+	 */
+	DTCLib::DTC_EventWindowTag getEventWindowTag(size_t idx) const;
+
+	/**
+	 * \brief Find a DTC_Event by Event Window Tag, without setting up the events
+	 * \param tag Event Window Tag to look for
+	 * \return Index of the first matching event, or eventCount() if there is none
+	 */
+	size_t findEvent(DTCLib::DTC_EventWindowTag const& tag) const
 	{
-		if (event_ptr_ == nullptr)
+		for (size_t ii = 0; ii < eventCount(); ++ii)
 		{
-			event_ptr_.reset(new DTCLib::DTC_Event(artdaq_Fragment_.dataBeginBytes()));
-			event_ptr_->SetupEvent();
+			if (getEventWindowTag(ii) == tag) return ii;
 		}
-		return *event_ptr_.get();
+		return eventCount();
 	}
 
+	const_iterator begin() const { return const_iterator(this, 0); }           ///< First DTC_Event
+	const_iterator end() const { return const_iterator(this, eventCount()); }  ///< End of the DTC_Events
+
+	/**
+	 * \brief Copy the sub-events from the given subsystem
+	 * \param subsys Subsystem to select
+	 * \return Vector of copies of the matching sub-events. Use getSubsystemRange to avoid the copies.
+	 */
 	std::vector<DTCLib::DTC_SubEvent> getSubsystemData(DTCLib::DTC_Subsystem subsys) const 
 	{
-		auto data = getData();
-		return data.GetSubsystemData(subsys);
+		return getData().GetSubsystemData(subsys);
+	}
+
+	/**
+	 * \brief Non-owning view of the sub-events from the given subsystem
+	 * \param subsys Subsystem to select
+	 * \return DTC_Event::SubsystemRange over the matching sub-events, valid as long as this overlay
+	 */
+	DTCLib::DTC_Event::SubsystemRange getSubsystemRange(DTCLib::DTC_Subsystem subsys) const
+	{
+		return getData().GetSubsystemRange(subsys);
+	}
+
+	/**
+	 * \brief Compress the tracker DTC_DataBlocks of the DTC_Event stored in a Fragment, in place
+	 * \param f The Fragment holding the DTC_Event
+	 * \return The new payload size of the Fragment, in bytes
+	 *
+	 * See DTCLib::DTC_TrackerBlockCodec. Compressed blocks are flagged in their DTC_DataHeaderPacket, and getData()
+	 * restores the original bytes, so readers need no changes.
+	 */
+	static size_t compressTrackerData(artdaq::Fragment& f)
+	{
+		if (isBatched(f))
+		{
+			throw cet::exception("DTCEventFragment") << "compressTrackerData does not support batched Fragments";
+		}
+		std::vector<uint8_t> encoded;
+		encoded.reserve(f.dataSizeBytes());
+		DTCLib::DTC_TrackerBlockCodec::EncodeEvent(f.dataBeginBytes(), encoded);
+		f.resizeBytes(encoded.size());
+		memcpy(f.dataBeginBytes(), encoded.data(), encoded.size());
+		// resizeBytes rounds up to whole Fragment words; clear the tail so the output does not depend on the old data
+		memset(f.dataBeginBytes() + encoded.size(), 0, f.dataSizeBytes() - encoded.size());
+		return encoded.size();
+	}
+
+	/**
+	 * \brief Delta-encode the event headers of a batched Fragment, in place
+	 * \param f The Fragment, built by packEvents
+	 * \return The new payload size of the Fragment, in bytes
+	 *
+	 * See DTCLib::DTC_HeaderDeltaCodec. The first event is kept unchanged and is the template for the others, so each
+	 * event can still be set up on its own. getEvent restores the original bytes before DTC_Event::SetupEvent. Worth it
+	 * for batches of small events, where the headers are a large part of the data.
+	 */
+	static size_t compressHeaders(artdaq::Fragment& f);
+
+	/**
+	 * \brief Create a new DTCEVT Fragment holding only the selected parts of the DTC_Event in f
+	 * \param f The Fragment holding the DTC_Event
+	 * \param selection Sub-events and ROC data blocks to keep
+	 * \return A new Fragment with the same sequence ID, fragment ID, type and timestamp as f
+	 *
+	 * The event is not set up: the sub-event and data block byte counts are followed through the raw data, only the
+	 * selected byte ranges are copied, and inclusive_event_byte_count, num_dtcs, inclusive_subevent_byte_count and
+	 * num_rocs are patched in the copied headers. Since data blocks are identified by their position in the sub-event,
+	 * deselected links in front of a selected one are kept as empty data blocks (header packet only, never flagged as
+	 * compressed by DTCLib::DTC_TrackerBlockCodec). f must not be batched.
+	 */
+	static std::unique_ptr<artdaq::Fragment> slice(artdaq::Fragment const& f, SliceSelection const& selection);
+
+	/**
+	 * \brief Build a DTCEVT Fragment directly from the DMA buffers holding one DTC_Event
+	 * \param frags The Fragment list to append the new Fragment to
+	 * \param dmaBuffers DMA buffers of the event, in order. Each starts with its uint64_t DMA transfer byte count.
+	 * \param sequenceID Sequence ID of the new Fragment
+	 * \param fragmentID Fragment ID of the new Fragment
+	 * \param timestamp Timestamp of the new Fragment
+	 * \return A DTCEventFragment overlay of the new Fragment, with its DTC_Event already set up
+	 *
+	 * The Fragment payload is allocated once, sized from the inclusive_event_byte_count of the DTC_EventHeader at the
+	 * start of the first buffer, and the data of each buffer is copied straight into it. This avoids staging the event
+	 * in a DTC_Event(size_t) buffer first. The Fragment is owned by frags, which must outlive the overlay.
+	 */
+	static std::unique_ptr<DTCEventFragment> fromDMABuffers(artdaq::FragmentPtrs& frags, std::vector<const void*> const& dmaBuffers,
+															 artdaq::Fragment::sequence_id_t sequenceID, artdaq::Fragment::fragment_id_t fragmentID,
+															 artdaq::Fragment::timestamp_t timestamp);
+
+	/**
+	 * \brief Pack several DTC_Events into one batched DTCEVT Fragment
+	 * \param events Pointers to the DTC_EventHeader of each event
+	 * \param sequenceID Sequence ID of the new Fragment
+	 * \param fragmentID Fragment ID of the new Fragment
+	 * \param timestamp Timestamp of the new Fragment
+	 * \return The new Fragment
+	 *
+	 * Each event is copied to an 8-byte aligned offset, and the EventTableEntry table follows the last event. Packing
+	 * many small events (e.g. off-spill or calibration) in one Fragment amortizes the per-Fragment overhead.
+	 */
+	static std::unique_ptr<artdaq::Fragment> packEvents(std::vector<const void*> const& events, artdaq::Fragment::sequence_id_t sequenceID,
+														artdaq::Fragment::fragment_id_t fragmentID, artdaq::Fragment::timestamp_t timestamp);
+
+	/**
+	 * \brief Whether a Fragment was built by packEvents
+	 * \param f The Fragment to check
+	 * \return True if f has DTCEventFragment Metadata
+	 *
+	 * Throws cet::exception if the Metadata version is neither CURRENT_VERSION nor HEADER_DELTA_VERSION, since the
+	 * layout of the payload is then unknown.
+	 */
+	static bool isBatched(artdaq::Fragment const& f)
+	{
+		if (!f.hasMetadata()) return false;
+		auto version = f.metadata<Metadata>()->version;
+		if (version != CURRENT_VERSION && version != HEADER_DELTA_VERSION)
+		{
+			throw cet::exception("DTCEventFragment") << "Unknown batched Fragment version " << version;
+		}
+		return true;
 	}
 
+	/**
+	 * \brief Whether the event headers of a Fragment are delta-encoded (see compressHeaders)
+	 * \param f The Fragment to check
+	 * \return True if f is batched with HEADER_DELTA_VERSION
+	 */
+	static bool hasCompressedHeaders(artdaq::Fragment const& f) { return f.hasMetadata() && f.metadata<Metadata>()->version == HEADER_DELTA_VERSION; }
+
 protected:
 private:
   	DTCEventFragment(DTCEventFragment const&) = delete;             // DTCEventFragment should definitely not be copied
@@ -61,8 +323,24 @@ private:
   	DTCEventFragment& operator=(DTCEventFragment const&) = delete;  // DTCEventFragment should definitely not be copied
   	DTCEventFragment& operator=(DTCEventFragment&&) = delete;       // DTCEventFragment should not be moved, only the underlying Fragment
 
+	struct CachedEvent
+	{
+		std::once_flag once;
+		std::unique_ptr<DTCLib::DTC_Event> event{nullptr};
+		std::vector<uint8_t> decoded_bytes;  // Used if the event has compressed headers or tracker blocks
+	};
+
+	EventTableEntry const* eventTable() const
+	{
+		return reinterpret_cast<EventTableEntry const*>(artdaq_Fragment_.dataBeginBytes() + artdaq_Fragment_.metadata<Metadata>()->table_offset);
+	}
+	static bool eventTableFits(artdaq::Fragment const& f);
+	void setupEvent(size_t idx) const;
+
 	artdaq::Fragment const& artdaq_Fragment_;
-        mutable std::unique_ptr<DTCLib::DTC_Event> event_ptr_{nullptr};
+	std::unique_ptr<CachedEvent[]> events_;  // One per event, allocated in the constructor once the event count is checked
+	mutable std::once_flag headerCodecOnce_;
+	mutable std::unique_ptr<DTCLib::DTC_HeaderDeltaCodec> headerCodec_;  // Template of compressed headers, from the first event
 };
 
 #endif /* artdaq_core_Data_Mu2eEventFragment_hh */
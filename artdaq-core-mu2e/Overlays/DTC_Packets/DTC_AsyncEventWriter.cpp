@@ -0,0 +1,396 @@
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_AsyncEventWriter.h"
+
+#include "artdaq-core-mu2e/Overlays/DTC_Types/Exceptions.h"
+
+#include "TRACE/tracemf.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+const size_t DIRECT_IO_ALIGNMENT = 4096;
+const size_t SPINS_BEFORE_SLEEP = 64;
+const auto IDLE_SLEEP = std::chrono::microseconds(50);
+
+uint64_t NanosecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Backoff(size_t& spins)
+{
+	if (spins++ < SPINS_BEFORE_SLEEP)
+	{
+		std::this_thread::yield();
+	}
+	else
+	{
+		std::this_thread::sleep_for(IDLE_SLEEP);
+	}
+}
+
+}  // namespace
+
+DTCLib::DTC_AsyncEventWriter::DTC_AsyncEventWriter(std::string const& fileName, Options const& options)
+	: options_(options), fileName_(fileName), openTime_(std::chrono::steady_clock::now())
+{
+	size_t depth = 1;
+	while (depth < options_.queueDepth) depth <<= 1;
+	slots_.reset(new Slot[depth]);
+	slotMask_ = depth - 1;
+	for (size_t ii = 0; ii < depth; ++ii)
+	{
+		slots_[ii].sequence.store(ii, std::memory_order_relaxed);
+	}
+
+	options_.chunkBytes = (options_.chunkBytes + DIRECT_IO_ALIGNMENT - 1) & ~(DIRECT_IO_ALIGNMENT - 1);
+	if (options_.chunkBytes == 0) options_.chunkBytes = DIRECT_IO_ALIGNMENT;
+	if (options_.chunkCount < 2) options_.chunkCount = 2;
+
+	int flags = O_WRONLY | O_CREAT | O_TRUNC;
+	if (options_.directIO)
+	{
+#ifdef O_DIRECT
+		fd_ = open(fileName_.c_str(), flags | O_DIRECT, 0644);
+		if (fd_ >= 0)
+		{
+			directIO_ = true;
+		}
+		else
+		{
+			TLOG(TLVL_WARNING) << "Unable to open " << fileName_ << " with O_DIRECT (" << strerror(errno) << "), using buffered I/O";
+		}
+#else
+		TLOG(TLVL_WARNING) << "O_DIRECT is not supported on this platform, using buffered I/O for " << fileName_;
+#endif
+	}
+	if (fd_ < 0) fd_ = open(fileName_.c_str(), flags, 0644);
+	if (fd_ < 0)
+	{
+		TLOG(TLVL_ERROR) << "Unable to open " << fileName_ << ": " << strerror(errno);
+		throw DTC_IOErrorException("Unable to open " + fileName_ + ": " + strerror(errno));
+	}
+
+	for (size_t ii = 0; ii < options_.chunkCount; ++ii)
+	{
+		auto ptr = static_cast<uint8_t*>(aligned_alloc(DIRECT_IO_ALIGNMENT, options_.chunkBytes));
+		if (ptr == nullptr)
+		{
+			TLOG(TLVL_ERROR) << "Unable to allocate write chunk of " << options_.chunkBytes << " bytes";
+			for (auto chunk : chunkStorage_) free(chunk);
+			close(fd_);
+			throw std::bad_alloc();
+		}
+		chunkStorage_.push_back(ptr);
+		freeChunks_.push_back(Chunk{ptr, 0});
+	}
+
+	TLOG(TLVL_DEBUG) << "Writing " << fileName_ << " with " << options_.chunkCount << " chunks of " << options_.chunkBytes << " bytes, queue depth " << depth
+					 << (directIO_ ? ", O_DIRECT" : "");
+	packThread_ = std::thread(&DTC_AsyncEventWriter::PackLoop, this);
+	writeThread_ = std::thread(&DTC_AsyncEventWriter::WriteLoop, this);
+}
+
+DTCLib::DTC_AsyncEventWriter::~DTC_AsyncEventWriter()
+{
+	try
+	{
+		Close();
+	}
+	catch (std::exception const& ex)
+	{
+		TLOG(TLVL_ERROR) << "Error closing " << fileName_ << ": " << ex.what();
+	}
+}
+
+void DTCLib::DTC_AsyncEventWriter::Write(std::shared_ptr<DTC_Event> event)
+{
+	CheckError();
+	event->UpdateHeader();
+	Item item{std::move(event), {}};
+	BlockingPush(item);
+}
+
+void DTCLib::DTC_AsyncEventWriter::Write(std::vector<uint8_t>&& data)
+{
+	CheckError();
+	Item item{nullptr, std::move(data)};
+	BlockingPush(item);
+}
+
+bool DTCLib::DTC_AsyncEventWriter::TryWrite(std::shared_ptr<DTC_Event>& event)
+{
+	CheckError();
+	event->UpdateHeader();
+	Item item{std::move(event), {}};
+	if (Push(item)) return true;
+	event = std::move(item.event);
+	return false;
+}
+
+bool DTCLib::DTC_AsyncEventWriter::TryWrite(std::vector<uint8_t>& data)
+{
+	CheckError();
+	Item item{nullptr, std::move(data)};
+	if (Push(item)) return true;
+	data = std::move(item.data);
+	return false;
+}
+
+void DTCLib::DTC_AsyncEventWriter::Close()
+{
+	if (closed_) return;
+	closed_ = true;
+
+	closing_.store(true, std::memory_order_release);
+	packThread_.join();
+	writeThread_.join();
+
+	auto bytes = bytesWritten_.load();
+	if (directIO_ && bytes % DIRECT_IO_ALIGNMENT != 0 && ftruncate(fd_, bytes) != 0)
+	{
+		TLOG(TLVL_ERROR) << "Unable to truncate padding of " << fileName_ << ": " << strerror(errno);
+		error_.store(errno);
+	}
+	if (close(fd_) != 0)
+	{
+		TLOG(TLVL_ERROR) << "Unable to close " << fileName_ << ": " << strerror(errno);
+		error_.store(errno);
+	}
+	elapsedNanoseconds_.store(NanosecondsSince(openTime_));
+
+	for (auto chunk : chunkStorage_) free(chunk);
+	chunkStorage_.clear();
+
+	auto stats = GetStats();
+	TLOG(TLVL_DEBUG) << "Closed " << fileName_ << ": " << stats.bytesWritten << " bytes from " << stats.eventsQueued << " events in " << stats.elapsedSeconds
+					 << " s, producers stalled " << stats.producerStalls << " times for " << stats.producerStallSeconds << " s";
+	CheckError();
+}
+
+DTCLib::DTC_AsyncEventWriter::Stats DTCLib::DTC_AsyncEventWriter::GetStats() const
+{
+	Stats stats;
+	stats.eventsQueued = eventsQueued_.load();
+	stats.bytesWritten = bytesWritten_.load();
+	stats.chunksWritten = chunksWritten_.load();
+	stats.producerStalls = producerStalls_.load();
+	stats.producerStallSeconds = producerStallNanoseconds_.load() * 1e-9;
+	stats.packerStallSeconds = packerStallNanoseconds_.load() * 1e-9;
+	stats.writeSeconds = writeNanoseconds_.load() * 1e-9;
+	auto elapsed = elapsedNanoseconds_.load();
+	stats.elapsedSeconds = (elapsed != 0 ? elapsed : NanosecondsSince(openTime_)) * 1e-9;
+	stats.maxQueueDepth = maxQueueDepth_.load();
+	return stats;
+}
+
+bool DTCLib::DTC_AsyncEventWriter::Push(Item& item)
+{
+	auto pos = pushPos_.load(std::memory_order_relaxed);
+	Slot* slot;
+	for (;;)
+	{
+		slot = &slots_[pos & slotMask_];
+		auto seq = slot->sequence.load(std::memory_order_acquire);
+		auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+		if (diff == 0)
+		{
+			if (pushPos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+		}
+		else if (diff < 0)
+		{
+			return false;  // Full: the consumer has not released this slot yet
+		}
+		else
+		{
+			pos = pushPos_.load(std::memory_order_relaxed);
+		}
+	}
+	slot->item = std::move(item);
+	slot->sequence.store(pos + 1, std::memory_order_release);
+
+	++eventsQueued_;
+	auto popped = popPos_.load(std::memory_order_relaxed);
+	size_t depth = pos + 1 > popped ? pos + 1 - popped : 0;
+	auto max = maxQueueDepth_.load(std::memory_order_relaxed);
+	while (depth > max && !maxQueueDepth_.compare_exchange_weak(max, depth, std::memory_order_relaxed))
+	{
+	}
+	return true;
+}
+
+bool DTCLib::DTC_AsyncEventWriter::Pop(Item& item)
+{
+	// Only the packing thread pops
+	auto pos = popPos_.load(std::memory_order_relaxed);
+	auto& slot = slots_[pos & slotMask_];
+	if (slot.sequence.load(std::memory_order_acquire) != pos + 1) return false;
+	item = std::move(slot.item);
+	slot.item = Item();
+	slot.sequence.store(pos + slotMask_ + 1, std::memory_order_release);
+	popPos_.store(pos + 1, std::memory_order_relaxed);
+	return true;
+}
+
+void DTCLib::DTC_AsyncEventWriter::BlockingPush(Item& item)
+{
+	if (Push(item)) return;
+
+	++producerStalls_;
+	auto start = std::chrono::steady_clock::now();
+	size_t spins = 0;
+	while (!Push(item))
+	{
+		CheckError();
+		Backoff(spins);
+	}
+	producerStallNanoseconds_ += NanosecondsSince(start);
+}
+
+void DTCLib::DTC_AsyncEventWriter::CheckError() const
+{
+	auto error = error_.load();
+	if (error != 0)
+	{
+		throw DTC_IOErrorException("Error writing " + fileName_ + ": " + strerror(error));
+	}
+}
+
+void DTCLib::DTC_AsyncEventWriter::PackLoop()
+{
+	auto append = [this](const void* data, size_t size) { Append(data, size); };
+	Item item;
+	size_t spins = 0;
+	for (;;)
+	{
+		// Producers have all returned once closing_ is set, so a final Pop after seeing it drains the queue
+		if (Pop(item) || (closing_.load(std::memory_order_acquire) && Pop(item)))
+		{
+			if (item.event)
+			{
+				item.event->WriteEvent(append, options_.includeDMAWriteSize);
+			}
+			else
+			{
+				Append(item.data.data(), item.data.size());
+			}
+			item = Item();
+			spins = 0;
+		}
+		else if (closing_.load(std::memory_order_acquire))
+		{
+			break;
+		}
+		else
+		{
+			Backoff(spins);
+		}
+	}
+
+	if (current_.data != nullptr && current_.size > 0) SubmitChunk();
+	{
+		std::lock_guard<std::mutex> lock(chunkMutex_);
+		packingDone_ = true;
+	}
+	chunkCondition_.notify_all();
+}
+
+void DTCLib::DTC_AsyncEventWriter::Append(const void* data, size_t size)
+{
+	auto src = static_cast<const uint8_t*>(data);
+	while (size > 0)
+	{
+		if (current_.data == nullptr)
+		{
+			std::unique_lock<std::mutex> lock(chunkMutex_);
+			if (freeChunks_.empty())
+			{
+				auto start = std::chrono::steady_clock::now();
+				chunkCondition_.wait(lock, [this] { return !freeChunks_.empty(); });
+				packerStallNanoseconds_ += NanosecondsSince(start);
+			}
+			current_ = freeChunks_.front();
+			freeChunks_.pop_front();
+		}
+
+		auto bytes = std::min(size, options_.chunkBytes - current_.size);
+		memcpy(current_.data + current_.size, src, bytes);
+		current_.size += bytes;
+		src += bytes;
+		size -= bytes;
+		if (current_.size == options_.chunkBytes) SubmitChunk();
+	}
+}
+
+void DTCLib::DTC_AsyncEventWriter::SubmitChunk()
+{
+	{
+		std::lock_guard<std::mutex> lock(chunkMutex_);
+		fullChunks_.push_back(current_);
+	}
+	chunkCondition_.notify_all();
+	current_ = Chunk{nullptr, 0};
+}
+
+void DTCLib::DTC_AsyncEventWriter::WriteLoop()
+{
+	for (;;)
+	{
+		Chunk chunk;
+		{
+			std::unique_lock<std::mutex> lock(chunkMutex_);
+			chunkCondition_.wait(lock, [this] { return !fullChunks_.empty() || packingDone_; });
+			if (fullChunks_.empty()) break;
+			chunk = fullChunks_.front();
+			fullChunks_.pop_front();
+		}
+
+		WriteChunk(chunk);
+
+		{
+			std::lock_guard<std::mutex> lock(chunkMutex_);
+			freeChunks_.push_back(Chunk{chunk.data, 0});
+		}
+		chunkCondition_.notify_all();
+	}
+}
+
+void DTCLib::DTC_AsyncEventWriter::WriteChunk(Chunk const& chunk)
+{
+	if (error_.load() != 0) return;  // Keep recycling chunks so that producers are not blocked forever
+
+	auto length = chunk.size;
+	if (directIO_ && length % DIRECT_IO_ALIGNMENT != 0)
+	{
+		// Only the last chunk is partial; the padding is truncated on Close
+		auto padded = (length + DIRECT_IO_ALIGNMENT - 1) & ~(DIRECT_IO_ALIGNMENT - 1);
+		memset(chunk.data + length, 0, padded - length);
+		length = padded;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	size_t offset = 0;
+	while (offset < length)
+	{
+		auto ret = write(fd_, chunk.data + offset, length - offset);
+		if (ret < 0)
+		{
+			if (errno == EINTR) continue;
+			TLOG(TLVL_ERROR) << "Error writing " << length << " bytes to " << fileName_ << ": " << strerror(errno);
+			error_.store(errno);
+			return;
+		}
+		offset += ret;
+	}
+	writeNanoseconds_ += NanosecondsSince(start);
+	bytesWritten_ += chunk.size;
+	++chunksWritten_;
+	TLOG(TLVL_TRACE) << "Wrote chunk of " << chunk.size << " bytes to " << fileName_;
+}
@@ -0,0 +1,202 @@
+#ifndef artdaq_core_mu2e_Overlays_DTC_Packets_DTC_AsyncEventWriter_h
+#define artdaq_core_mu2e_Overlays_DTC_Packets_DTC_AsyncEventWriter_h
+
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_Event.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace DTCLib {
+
+/// <summary>
+/// Writes DMA-framed DTC_Events to a file from background threads, for generating large detector emulator input files
+/// without stalling event generation on disk I/O.
+///
+/// Producers hand off events through a bounded lock-free queue, either as DTC_Events (written in the format of
+/// DTC_Event::WriteEvent, serialized by the writer straight from the event's sub-event headers and DataBlocks) or as
+/// bytes which are already serialized. A packing thread copies them into large aligned chunks, and an I/O thread
+/// writes full chunks while the next one is filled (two chunks by default: double buffering). With directIO, the file
+/// is opened with O_DIRECT and written in whole chunks; the padding of the last chunk is truncated on Close.
+///
+/// When the disk falls behind, the chunks fill up, the queue fills up and Write blocks; the time producers spent
+/// blocked is reported in the Stats, together with the sustained throughput.
+/// </summary>
+class DTC_AsyncEventWriter
+{
+public:
+	/// <summary>
+	/// Options of a DTC_AsyncEventWriter
+	/// </summary>
+	struct Options
+	{
+		size_t queueDepth{1024};        ///< Number of events the queue holds, rounded up to a power of two
+		size_t chunkBytes{16 << 20};    ///< Size of each write, rounded up to a multiple of 4096 bytes
+		size_t chunkCount{2};           ///< Number of chunks; at least 2, so that one is filled while another is written
+		bool directIO{false};           ///< Open the file with O_DIRECT (falls back to buffered I/O if not supported)
+		bool includeDMAWriteSize{true}; ///< Precede each DMA buffer of a DTC_Event with the DMA Write Size word
+	};
+
+	/// <summary>
+	/// Throughput and backpressure statistics
+	/// </summary>
+	struct Stats
+	{
+		uint64_t eventsQueued{0};          ///< Events and serialized buffers accepted by Write
+		uint64_t bytesWritten{0};          ///< Bytes written to the file, excluding O_DIRECT padding
+		uint64_t chunksWritten{0};         ///< Number of chunk writes
+		uint64_t producerStalls{0};        ///< Number of Write calls which found the queue full
+		double producerStallSeconds{0};    ///< Total time producers waited for room in the queue
+		double packerStallSeconds{0};      ///< Total time the packing thread waited for a free chunk (disk-bound)
+		double writeSeconds{0};            ///< Total time spent in write calls
+		double elapsedSeconds{0};          ///< Time since the file was opened (until Close)
+		size_t maxQueueDepth{0};           ///< Largest number of queued events seen by a producer
+
+		/// <summary>
+		/// Sustained throughput, over the lifetime of the writer
+		/// </summary>
+		/// <returns>Bytes written per second of elapsed time</returns>
+		double Throughput() const { return elapsedSeconds > 0 ? bytesWritten / elapsedSeconds : 0; }
+		/// <summary>
+		/// Throughput of the write calls alone
+		/// </summary>
+		/// <returns>Bytes written per second spent writing</returns>
+		double WriteBandwidth() const { return writeSeconds > 0 ? bytesWritten / writeSeconds : 0; }
+	};
+
+	/// <summary>
+	/// Open (truncating) the output file and start the background threads. Throws DTC_IOErrorException if the file cannot be opened.
+	/// </summary>
+	/// <param name="fileName">Output file</param>
+	/// <param name="options">Options to use</param>
+	DTC_AsyncEventWriter(std::string const& fileName, Options const& options);
+	/// <summary>
+	/// Open (truncating) the output file with default Options
+	/// </summary>
+	/// <param name="fileName">Output file</param>
+	explicit DTC_AsyncEventWriter(std::string const& fileName)
+		: DTC_AsyncEventWriter(fileName, Options()) {}
+	/// <summary>
+	/// Close the file if Close was not called. Errors are logged, not thrown.
+	/// </summary>
+	~DTC_AsyncEventWriter();
+
+	DTC_AsyncEventWriter(DTC_AsyncEventWriter const&) = delete;
+	DTC_AsyncEventWriter& operator=(DTC_AsyncEventWriter const&) = delete;
+
+	/// <summary>
+	/// Queue a DTC_Event, blocking while the queue is full. The header of the event is updated on the calling thread;
+	/// the event must not be modified afterwards, and its data is kept alive by the writer until it is written.
+	/// Throws DTC_IOErrorException if an earlier write failed.
+	/// </summary>
+	/// <param name="event">Event to write</param>
+	void Write(std::shared_ptr<DTC_Event> event);
+	/// <summary>
+	/// Queue bytes which are already DMA-framed (e.g. from DTC_Event::WriteEvent), blocking while the queue is full.
+	/// Throws DTC_IOErrorException if an earlier write failed.
+	/// </summary>
+	/// <param name="data">Bytes to write</param>
+	void Write(std::vector<uint8_t>&& data);
+	/// <summary>
+	/// Queue a DTC_Event if the queue is not full
+	/// </summary>
+	/// <param name="event">Event to write. Left unchanged if the queue is full.</param>
+	/// <returns>Whether the event was queued</returns>
+	bool TryWrite(std::shared_ptr<DTC_Event>& event);
+	/// <summary>
+	/// Queue serialized bytes if the queue is not full
+	/// </summary>
+	/// <param name="data">Bytes to write. Left unchanged if the queue is full.</param>
+	/// <returns>Whether the bytes were queued</returns>
+	bool TryWrite(std::vector<uint8_t>& data);
+
+	/// <summary>
+	/// Write everything queued, stop the background threads and close the file. All producers must have returned
+	/// from Write. Throws DTC_IOErrorException if a write failed. Further calls do nothing.
+	/// </summary>
+	void Close();
+
+	/// <summary>
+	/// Get a snapshot of the statistics. May be called from any thread.
+	/// </summary>
+	/// <returns>Current Stats</returns>
+	Stats GetStats() const;
+
+private:
+	struct Item
+	{
+		std::shared_ptr<DTC_Event> event;
+		std::vector<uint8_t> data;
+	};
+
+	// Bounded multi-producer queue: a ring of slots, each with a sequence number telling whether it is free for the
+	// producer holding a given position or full for the consumer.
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		Item item;
+	};
+
+	struct Chunk
+	{
+		uint8_t* data;
+		size_t size;
+	};
+
+	bool Push(Item& item);
+	bool Pop(Item& item);
+	void BlockingPush(Item& item);
+	void CheckError() const;
+
+	void PackLoop();
+	void WriteLoop();
+	void Append(const void* data, size_t size);
+	void SubmitChunk();
+	void WriteChunk(Chunk const& chunk);
+
+	Options options_;
+	std::string fileName_;
+	int fd_{-1};
+	bool directIO_{false};
+	bool closed_{false};
+	std::chrono::steady_clock::time_point openTime_;
+
+	std::unique_ptr<Slot[]> slots_;
+	size_t slotMask_;
+	alignas(64) std::atomic<size_t> pushPos_{0};
+	alignas(64) std::atomic<size_t> popPos_{0};
+	std::atomic<bool> closing_{false};
+
+	std::vector<uint8_t*> chunkStorage_;
+	Chunk current_{nullptr, 0};  // Chunk being filled, owned by the packing thread
+	std::mutex chunkMutex_;
+	std::condition_variable chunkCondition_;
+	std::deque<Chunk> freeChunks_;
+	std::deque<Chunk> fullChunks_;
+	bool packingDone_{false};
+
+	std::atomic<int> error_{0};
+	std::atomic<uint64_t> eventsQueued_{0};
+	std::atomic<uint64_t> bytesWritten_{0};
+	std::atomic<uint64_t> chunksWritten_{0};
+	std::atomic<uint64_t> producerStalls_{0};
+	std::atomic<uint64_t> producerStallNanoseconds_{0};
+	std::atomic<uint64_t> packerStallNanoseconds_{0};
+	std::atomic<uint64_t> writeNanoseconds_{0};
+	std::atomic<uint64_t> elapsedNanoseconds_{0};  // Set on Close
+	std::atomic<size_t> maxQueueDepth_{0};
+
+	std::thread packThread_;
+	std::thread writeThread_;
+};
+
+}  // namespace DTCLib
+
+#endif  // artdaq_core_mu2e_Overlays_DTC_Packets_DTC_AsyncEventWriter_h
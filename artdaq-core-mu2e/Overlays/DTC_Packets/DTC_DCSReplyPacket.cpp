@@ -4,8 +4,6 @@
 
 #include "TRACE/tracemf.h"
 
-#include <iomanip>
-
 // ~~~ Packet Types ~~~ (**** can be sent s2c, --- can be sent by CFO, @@@ can be sent by ROC)
 // 0 DCS Request   ****
 // 1 Heartbeat (broadcast) ---
@@ -99,84 +97,66 @@ DTCLib::DTC_DCSReplyPacket::DTC_DCSReplyPacket(DTC_DataPacket in)
 	}
 }
 
-std::string DTCLib::DTC_DCSReplyPacket::toJSON()
+void DTCLib::DTC_DCSReplyPacket::AppendJSON(DTC_TextBuffer& buf) const
 {
-	std::stringstream ss;
-	ss << "\"DCSReplyPacket\": {\n";
-	ss << headerJSON();
-	ss << ",\n\"Operation Type\":" << DTC_DCSOperationTypeConverter(type_);
-	ss << ",\n\"Double Operation\":" << (doubleOp_ ? "\"true\"" : "\"false\"");
-	ss << ",\n\"Request Acknowledgement\":" << (requestAck_ ? "\"true\"" : "\"false\"");
-	ss << ",\n\"DCS Request FIFO Empty\": " << (dcsReceiveFIFOEmpty_ ? "\"true\"" : "\"false\"");
-	ss << ",\n\"Corrupt Flag\": " << (corruptFlag_ ? "\"true\"" : "\"false\"");
-	ss << ",\n\"Address1\": " << static_cast<int>(address1_);
+	buf.Append("\"DCSReplyPacket\": {\n");
+	AppendHeaderJSON(buf);
+	buf.Append(",\n\"Operation Type\":\"").Append(DTC_DCSOperationTypeConverter(type_).toString()).Append('"');
+	buf.Append(",\n\"Double Operation\":").Append(doubleOp_ ? "\"true\"" : "\"false\"");
+	buf.Append(",\n\"Request Acknowledgement\":").Append(requestAck_ ? "\"true\"" : "\"false\"");
+	buf.Append(",\n\"DCS Request FIFO Empty\": ").Append(dcsReceiveFIFOEmpty_ ? "\"true\"" : "\"false\"");
+	buf.Append(",\n\"Corrupt Flag\": ").Append(corruptFlag_ ? "\"true\"" : "\"false\"");
+	buf.Append(",\n\"Address1\": ").Dec(address1_);
 	if (type_ != DTC_DCSOperationType_BlockRead)
 	{
-		ss << ",\n\"Data1\": " << static_cast<int>(data1_);
-		ss << ",\n\"Address2\": " << static_cast<int>(address2_);
-		ss << ",\n\"Data2\": " << static_cast<int>(data2_);
+		buf.Append(",\n\"Data1\": ").Dec(data1_);
+		buf.Append(",\n\"Address2\": ").Dec(address2_);
+		buf.Append(",\n\"Data2\": ").Dec(data2_);
 	}
 	else
 	{
-		ss << ",\n\"Block Word Count\": " << static_cast<int>(data1_);
-		auto counter = 0;
+		buf.Append(",\n\"Block Word Count\": ").Dec(data1_);
+		size_t counter = 0;
 		for (auto& word : blockReadData_)
 		{
-			ss << ",\n\"Block Read word " << counter << "\":" << static_cast<int>(word);
+			buf.Append(",\n\"Block Read word ").Dec(counter).Append("\":").Dec(word);
 			counter++;
 		}
 	}
-	ss << "\n}";
-	return ss.str();
+	buf.Append("\n}");
 }
 
-std::string DTCLib::DTC_DCSReplyPacket::toPacketFormat()
+void DTCLib::DTC_DCSReplyPacket::AppendPacketFormat(DTC_TextBuffer& buf) const
 {
-	std::stringstream ss;
-	
-	ss << headerPacketFormat() << std::hex << std::setfill('0');
+	AppendHeaderPacketFormat(buf);
 
 	auto firstWord = (packetCount_ & 0x3FC) >> 2;
 	auto secondWord = ((packetCount_ & 0x3) << 6) + (corruptFlag_ ? 0x20 : 0) + (dcsReceiveFIFOEmpty_ ? 0x10 : 0) +
 		(requestAck_ ? 0x8 : 0) + (doubleOp_ ? 0x4 : 0) + static_cast<int>(type_);
-	ss << std::setw(8) << firstWord << "\t" << secondWord << std::endl;
+	buf.Hex(firstWord, 8).Append('\t').Hex(secondWord).Append('\n');
 
-	ss << std::setw(8) << ((address1_ & 0xFF00) >> 8) << "\t" << (address1_ & 0xFF) << std::endl;
-	ss << std::setw(8) << ((data1_ & 0xFF00) >> 8) << "\t" << (data1_ & 0xFF) << std::endl;
+	buf.Hex((address1_ & 0xFF00) >> 8, 8).Append('\t').Hex(address1_ & 0xFF).Append('\n');
+	buf.Hex((data1_ & 0xFF00) >> 8, 8).Append('\t').Hex(data1_ & 0xFF).Append('\n');
 	if (type_ != DTC_DCSOperationType_BlockRead)
 	{
-		ss << std::setw(8) << ((address2_ & 0xFF00) >> 8) << "\t" << (address2_ & 0xFF) << std::endl;
-		ss << std::setw(8) << ((data2_ & 0xFF00) >> 8) << "\t" << (data2_ & 0xFF) << std::endl;
-		ss << "        \t        " << std::endl;
+		buf.Hex((address2_ & 0xFF00) >> 8, 8).Append('\t').Hex(address2_ & 0xFF).Append('\n');
+		buf.Hex((data2_ & 0xFF00) >> 8, 8).Append('\t').Hex(data2_ & 0xFF).Append('\n');
+		buf.Append("        \t        \n");
 	}
 	else
 	{
-		if (blockReadData_.size() > 0)
-		{
-			ss << std::setw(8) << ((blockReadData_[0] & 0xFF00) >> 8) << "\t" << (blockReadData_[0] & 0xFF) << std::endl;
-		}
-		else
-		{
-			ss << "        \t        " << std::endl;
-		}
-		if (blockReadData_.size() > 1)
-		{
-			ss << std::setw(8) << ((blockReadData_[1] & 0xFF00) >> 8) << "\t" << (blockReadData_[1] & 0xFF) << std::endl;
-		}
-		else
+		for (size_t ii = 0; ii < 3; ++ii)
 		{
-			ss << "        \t        " << std::endl;
-		}
-		if (blockReadData_.size() > 2)
-		{
-			ss << std::setw(8) << ((blockReadData_[2] & 0xFF00) >> 8) << "\t" << (blockReadData_[2] & 0xFF) << std::endl;
-		}
-		else
-		{
-			ss << "        \t        " << std::endl;
+			if (blockReadData_.size() > ii)
+			{
+				buf.Hex((blockReadData_[ii] & 0xFF00) >> 8, 8).Append('\t').Hex(blockReadData_[ii] & 0xFF).Append('\n');
+			}
+			else
+			{
+				buf.Append("        \t        \n");
+			}
 		}
 	}
-	return ss.str();
 }
 
 DTCLib::DTC_DataPacket DTCLib::DTC_DCSReplyPacket::ConvertToDataPacket() const
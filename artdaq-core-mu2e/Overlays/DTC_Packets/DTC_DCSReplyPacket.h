@@ -81,7 +81,7 @@ public:
 	/// </summary>
 	/// <param name="secondOp">Whether to read the second operation</param>
 	/// <returns>Pair of address, data from the reply packet</returns>
-	std::pair<uint16_t, uint16_t> GetReply(bool secondOp = false)
+	std::pair<uint16_t, uint16_t> GetReply(bool secondOp = false) const
 	{
 		if (!secondOp) return std::make_pair(address1_, data1_);
 		return std::make_pair(address2_, data2_);
@@ -99,15 +99,15 @@ public:
 	/// <returns>DTC_DataPacket with DTC_DCSReplyPacket contents set</returns>
 	DTC_DataPacket ConvertToDataPacket() const override;
 	/// <summary>
-	/// Convert the DTC_DCSReplyPacket to JSON representation
+	/// Append the JSON representation of the DTC_DCSReplyPacket to the given buffer
 	/// </summary>
-	/// <returns>JSON-formatted string representation of DTC_DCSReplyPacket</returns>
-	std::string toJSON() override;
+	/// <param name="buf">Buffer to append to</param>
+	void AppendJSON(DTC_TextBuffer& buf) const override;
 	/// <summary>
-	/// Converts the DTC_DCSReplyPacket to "packet format" representation (See DTC_DataPacket::toPacketFormat())
+	/// Append the "packet format" representation of the DTC_DCSReplyPacket to the given buffer (See DTC_DataPacket::toPacketFormat())
 	/// </summary>
-	/// <returns>"packet format" string representation of DTC_DCSReplyPacket</returns>
-	std::string toPacketFormat() override;
+	/// <param name="buf">Buffer to append to</param>
+	void AppendPacketFormat(DTC_TextBuffer& buf) const override;
 
 private:
 	uint8_t DTCErrorBits_;
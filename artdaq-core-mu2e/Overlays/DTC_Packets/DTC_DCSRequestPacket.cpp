@@ -53,81 +53,63 @@ DTCLib::DTC_DCSRequestPacket::DTC_DCSRequestPacket(DTC_DataPacket in)
 	std::cout << "Constructor copy: " << toJSON() << std::endl;
 }
 
-std::string DTCLib::DTC_DCSRequestPacket::toJSON()
+void DTCLib::DTC_DCSRequestPacket::AppendJSON(DTC_TextBuffer& buf) const
 {
-	std::stringstream ss;
-	ss << "\"DCSRequestPacket\": {\n";
-	ss << headerJSON();
-	ss << ",\n\"Operation Type\":" << DTC_DCSOperationTypeConverter(type_);
-	ss << ",\n\"Request Acknowledgement\":" << (requestAck_ ? "\"true\"" : "\"false\"");
-	ss << ",\n\"Address1\": " << static_cast<int>(address1_);
+	buf.Append("\"DCSRequestPacket\": {\n");
+	AppendHeaderJSON(buf);
+	buf.Append(",\n\"Operation Type\":\"").Append(DTC_DCSOperationTypeConverter(type_).toString()).Append('"');
+	buf.Append(",\n\"Request Acknowledgement\":").Append(requestAck_ ? "\"true\"" : "\"false\"");
+	buf.Append(",\n\"Address1\": ").Dec(address1_);
 	if (type_ != DTC_DCSOperationType_BlockWrite)
 	{
-		ss << ",\n\"Data1\": " << static_cast<int>(data1_);
-		ss << ",\n\"Address2\": " << static_cast<int>(address2_);
-		ss << ",\n\"Data2\": " << static_cast<int>(data2_);
+		buf.Append(",\n\"Data1\": ").Dec(data1_);
+		buf.Append(",\n\"Address2\": ").Dec(address2_);
+		buf.Append(",\n\"Data2\": ").Dec(data2_);
 	}
 	else
 	{
-		auto counter = 0;
-		ss << ",\n\"Block Word Count\": " << static_cast<int>(data1_);
+		buf.Append(",\n\"Block Word Count\": ").Dec(data1_);
+		size_t counter = 0;
 		for (auto& word : blockWriteData_)
 		{
-			ss << ",\n\"Block Write word " << counter << "\":" << static_cast<int>(word);
+			buf.Append(",\n\"Block Write word ").Dec(counter).Append("\":").Dec(word);
 			counter++;
 		}
 	}
-	ss << "\n}";
-
-	return ss.str();
+	buf.Append("\n}");
 }
 
-std::string DTCLib::DTC_DCSRequestPacket::toPacketFormat()
+void DTCLib::DTC_DCSRequestPacket::AppendPacketFormat(DTC_TextBuffer& buf) const
 {
-	std::stringstream ss;
-	ss << headerPacketFormat() << std::hex << std::setfill('0');
+	AppendHeaderPacketFormat(buf);
 
 	auto firstWord = (packetCount_ & 0x3FC) >> 2;
 	auto secondWord =
 		((packetCount_ & 0x3) << 6) + (incrementAddress_ ? 0x10 : 0) + (requestAck_ ? 0x8 : 0) + (static_cast<int>(type_) & 0x7);
-	ss << std::setw(8) << firstWord << "\t" << secondWord << std::endl;
+	buf.Hex(firstWord, 8).Append('\t').Hex(secondWord).Append('\n');
 
-	ss << std::setw(8) << ((address1_ & 0xFF00) >> 8) << "\t" << (address1_ & 0xFF) << std::endl;
-	ss << std::setw(8) << ((data1_ & 0xFF00) >> 8) << "\t" << (data1_ & 0xFF) << std::endl;
+	buf.Hex((address1_ & 0xFF00) >> 8, 8).Append('\t').Hex(address1_ & 0xFF).Append('\n');
+	buf.Hex((data1_ & 0xFF00) >> 8, 8).Append('\t').Hex(data1_ & 0xFF).Append('\n');
 	if (type_ != DTC_DCSOperationType_BlockWrite)
 	{
-		ss << std::setw(8) << ((address2_ & 0xFF00) >> 8) << "\t" << (address2_ & 0xFF) << std::endl;
-		ss << std::setw(8) << ((data2_ & 0xFF00) >> 8) << "\t" << (data2_ & 0xFF) << std::endl;
-		ss << "        \t        " << std::endl;
+		buf.Hex((address2_ & 0xFF00) >> 8, 8).Append('\t').Hex(address2_ & 0xFF).Append('\n');
+		buf.Hex((data2_ & 0xFF00) >> 8, 8).Append('\t').Hex(data2_ & 0xFF).Append('\n');
+		buf.Append("        \t        \n");
 	}
 	else
 	{
-		if (blockWriteData_.size() > 0)
-		{
-			ss << std::setw(8) << ((blockWriteData_[0] & 0xFF00) >> 8) << "\t" << (blockWriteData_[0] & 0xFF) << std::endl;
-		}
-		else
-		{
-			ss << "        \t        " << std::endl;
-		}
-		if (blockWriteData_.size() > 1)
-		{
-			ss << std::setw(8) << ((blockWriteData_[1] & 0xFF00) >> 8) << "\t" << (blockWriteData_[1] & 0xFF) << std::endl;
-		}
-		else
-		{
-			ss << "        \t        " << std::endl;
-		}
-		if (blockWriteData_.size() > 2)
-		{
-			ss << std::setw(8) << ((blockWriteData_[2] & 0xFF00) >> 8) << "\t" << (blockWriteData_[2] & 0xFF) << std::endl;
-		}
-		else
+		for (size_t ii = 0; ii < 3; ++ii)
 		{
-			ss << "        \t        " << std::endl;
+			if (blockWriteData_.size() > ii)
+			{
+				buf.Hex((blockWriteData_[ii] & 0xFF00) >> 8, 8).Append('\t').Hex(blockWriteData_[ii] & 0xFF).Append('\n');
+			}
+			else
+			{
+				buf.Append("        \t        \n");
+			}
 		}
 	}
-	return ss.str();
 }
 
 void DTCLib::DTC_DCSRequestPacket::AddRequest(uint16_t address, uint16_t data)
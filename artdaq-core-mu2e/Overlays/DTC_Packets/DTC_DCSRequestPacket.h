@@ -102,7 +102,7 @@ public:
 	/// </summary>
 	/// <param name="secondOp">Whether to read the second request</param>
 	/// <returns>Pair of address, data from the given request</returns>
-	std::pair<uint16_t, uint16_t> GetRequest(bool secondOp = false)
+	std::pair<uint16_t, uint16_t> GetRequest(bool secondOp = false) const
 	{
 		if (!secondOp) return std::make_pair(address1_, data1_);
 		return std::make_pair(address2_, data2_);
@@ -147,15 +147,15 @@ public:
 	/// <returns>DTC_DataPacket with DCS Request Packet contents set</returns>
 	DTC_DataPacket ConvertToDataPacket() const override;
 	/// <summary>
-	/// Convert the DCS Request Packet to JSON representation
+	/// Append the JSON representation of the DCS Request Packet to the given buffer
 	/// </summary>
-	/// <returns>JSON-formatted string representation of DCS Request packet</returns>
-	std::string toJSON() override;
+	/// <param name="buf">Buffer to append to</param>
+	void AppendJSON(DTC_TextBuffer& buf) const override;
 	/// <summary>
-	/// Converts the DCS Request Packet to "packet format" representation (See DTC_DataPacket::toPacketFormat())
+	/// Append the "packet format" representation of the DCS Request Packet to the given buffer (See DTC_DataPacket::toPacketFormat())
 	/// </summary>
-	/// <returns>"packet format" string representation of DCS Request packet</returns>
-	std::string toPacketFormat() override;
+	/// <param name="buf">Buffer to append to</param>
+	void AppendPacketFormat(DTC_TextBuffer& buf) const override;
 
 private:
 	DTC_DCSOperationType type_;
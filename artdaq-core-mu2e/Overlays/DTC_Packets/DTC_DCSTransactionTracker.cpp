@@ -0,0 +1,217 @@
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_DCSTransactionTracker.h"
+
+#include "TRACE/tracemf.h"
+
+#include <algorithm>
+
+DTCLib::DTC_DCSTransactionTracker::DTC_DCSTransactionTracker(size_t capacity)
+{
+	size_t size = 1;
+	while (size < capacity) size <<= 1;
+	slots_.resize(size);
+	mask_ = size - 1;
+	completed_.reserve(size);
+}
+
+bool DTCLib::DTC_DCSTransactionTracker::RequestSent(const DTC_DCSRequestPacket& request, std::chrono::steady_clock::time_point when)
+{
+	auto type = request.GetType();
+	auto isWrite = type == DTC_DCSOperationType_Write || type == DTC_DCSOperationType_DoubleWrite || type == DTC_DCSOperationType_BlockWrite;
+	if (isWrite && !request.RequestsAck())
+	{
+		TLOG(TLVL_DEBUG + 10) << "DCS write without acknowledgement will not be tracked";
+		return true;
+	}
+
+	if (in_flight_ == slots_.size())
+	{
+		TLOG(TLVL_WARNING) << "DCS in-flight table is full (" << slots_.size() << " requests), cannot track request on link " << request.GetLinkID();
+		return false;
+	}
+
+	auto op1 = request.GetRequest();
+	DTC_DCSTransaction transaction;
+	transaction.sequence = next_sequence_++;
+	transaction.link = request.GetLinkID();
+	transaction.requestType = type;
+	transaction.address = op1.first;
+	transaction.requestData = op1.second;
+	if (request.IsDoubleOp())
+	{
+		transaction.address2 = request.GetRequest(true).first;
+	}
+	transaction.requestTime = when;
+
+	auto key = MakeKey(transaction.link, type, transaction.address);
+	auto index = HomeSlot(key);
+	while (slots_[index].used) index = (index + 1) & mask_;
+
+	slots_[index].used = true;
+	slots_[index].key = key;
+	slots_[index].transaction = transaction;
+	++in_flight_;
+	++link_in_flight_[transaction.link & 0x7];
+	return true;
+}
+
+bool DTCLib::DTC_DCSTransactionTracker::ReplyReceived(const DTC_DCSReplyPacket& reply, std::chrono::steady_clock::time_point when)
+{
+	auto type = reply.GetType();
+	auto op1 = reply.GetReply();
+
+	uint8_t status = DTC_DCSTransactionStatus_OK;
+	uint32_t keyMask = ~0u;
+	if (type == DTC_DCSOperationType_Timeout)
+	{
+		status |= DTC_DCSTransactionStatus_Timeout;
+		keyMask = ~OP_BITS;
+	}
+	else if (type == DTC_DCSOperationType_InvalidS2C)
+	{
+		status |= DTC_DCSTransactionStatus_InvalidS2C;
+		keyMask = ~OP_BITS;
+	}
+	if (reply.ROCIsCorrupt()) status |= DTC_DCSTransactionStatus_ROCCorrupt;
+	if (reply.GetDTCErrorBits() != 0) status |= DTC_DCSTransactionStatus_DTCError;
+
+	auto key = MakeKey(reply.GetLinkID(), type, op1.first);
+	auto index = FindOldest(key, keyMask);
+	if (index == slots_.size())
+	{
+		TLOG(TLVL_WARNING) << "DCS reply on link " << reply.GetLinkID() << " for address 0x" << std::hex << op1.first << " does not match any outstanding request";
+		DTC_DCSTransaction transaction;
+		transaction.link = reply.GetLinkID();
+		transaction.replyType = type;
+		transaction.address = op1.first;
+		transaction.replyData = op1.second;
+		transaction.dtcErrorBits = reply.GetDTCErrorBits();
+		transaction.status = status | DTC_DCSTransactionStatus_Unsolicited;
+		transaction.replyTime = when;
+		completed_.push_back(transaction);
+		return false;
+	}
+
+	auto transaction = slots_[index].transaction;
+	Erase(index);
+
+	transaction.replyType = type;
+	transaction.replyData = op1.second;
+	if (reply.IsDoubleOperation())
+	{
+		transaction.replyData2 = reply.GetReply(true).second;
+	}
+	transaction.dtcErrorBits = reply.GetDTCErrorBits();
+	transaction.status = status;
+	transaction.replyTime = when;
+
+	auto& timing = link_timing_[transaction.link & 0x7];
+	auto rtt = static_cast<uint64_t>(std::max(transaction.RoundTripTime().count(), static_cast<std::chrono::nanoseconds::rep>(0)));
+	if (timing.count == 0 || rtt < timing.min_ns) timing.min_ns = rtt;
+	if (rtt > timing.max_ns) timing.max_ns = rtt;
+	timing.last_ns = rtt;
+	timing.sum_ns += rtt;
+	++timing.count;
+	if (!transaction.IsOK()) ++timing.errors;
+
+	completed_.push_back(transaction);
+	return true;
+}
+
+size_t DTCLib::DTC_DCSTransactionTracker::ExpireOlderThan(std::chrono::steady_clock::duration age, std::chrono::steady_clock::time_point now)
+{
+	std::vector<DTC_DCSTransaction> expired;
+	std::vector<DTC_DCSTransaction> remaining;
+	for (auto& slot : slots_)
+	{
+		if (!slot.used) continue;
+		if (now - slot.transaction.requestTime > age)
+			expired.push_back(slot.transaction);
+		else
+			remaining.push_back(slot.transaction);
+	}
+	if (expired.empty()) return 0;
+
+	// Backward-shift deletion cannot be done while scanning the table, so rebuild it from the survivors
+	for (auto& slot : slots_) slot.used = false;
+	in_flight_ = 0;
+	link_in_flight_.fill(0);
+	for (auto& transaction : remaining)
+	{
+		auto key = MakeKey(transaction.link, transaction.requestType, transaction.address);
+		auto index = HomeSlot(key);
+		while (slots_[index].used) index = (index + 1) & mask_;
+		slots_[index].used = true;
+		slots_[index].key = key;
+		slots_[index].transaction = transaction;
+		++in_flight_;
+		++link_in_flight_[transaction.link & 0x7];
+	}
+
+	std::sort(expired.begin(), expired.end(), [](DTC_DCSTransaction const& a, DTC_DCSTransaction const& b) { return a.sequence < b.sequence; });
+	for (auto& transaction : expired)
+	{
+		TLOG(TLVL_DEBUG) << "DCS request #" << transaction.sequence << " on link " << transaction.link << " for address 0x" << std::hex << transaction.address << " expired without reply";
+		transaction.status |= DTC_DCSTransactionStatus_Expired;
+		++link_timing_[transaction.link & 0x7].expired;
+		completed_.push_back(transaction);
+	}
+	return expired.size();
+}
+
+size_t DTCLib::DTC_DCSTransactionTracker::DrainCompleted(std::vector<DTC_DCSTransaction>& output)
+{
+	output.clear();
+	output.swap(completed_);
+	return output.size();
+}
+
+void DTCLib::DTC_DCSTransactionTracker::ResetLinkTiming()
+{
+	link_timing_.fill(DTC_DCSLinkTiming());
+}
+
+void DTCLib::DTC_DCSTransactionTracker::Clear()
+{
+	for (auto& slot : slots_) slot.used = false;
+	in_flight_ = 0;
+	link_in_flight_.fill(0);
+	completed_.clear();
+}
+
+size_t DTCLib::DTC_DCSTransactionTracker::FindOldest(uint32_t key, uint32_t keyMask) const
+{
+	auto found = slots_.size();
+	auto index = HomeSlot(key);
+	for (size_t probes = 0; probes < slots_.size() && slots_[index].used; ++probes)
+	{
+		if ((slots_[index].key & keyMask) == (key & keyMask) &&
+			(found == slots_.size() || slots_[index].transaction.sequence < slots_[found].transaction.sequence))
+		{
+			found = index;
+		}
+		index = (index + 1) & mask_;
+	}
+	return found;
+}
+
+void DTCLib::DTC_DCSTransactionTracker::Erase(size_t index)
+{
+	--in_flight_;
+	--link_in_flight_[slots_[index].transaction.link & 0x7];
+
+	// Backward-shift deletion keeps every probe chain contiguous without tombstones
+	auto hole = index;
+	auto next = (hole + 1) & mask_;
+	while (next != index && slots_[next].used)
+	{
+		auto home = HomeSlot(slots_[next].key);
+		auto inRange = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+		if (!inRange)
+		{
+			slots_[hole] = slots_[next];
+			hole = next;
+		}
+		next = (next + 1) & mask_;
+	}
+	slots_[hole].used = false;
+}
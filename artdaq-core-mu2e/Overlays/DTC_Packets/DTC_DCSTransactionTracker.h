@@ -0,0 +1,213 @@
+#ifndef artdaq_core_mu2e_Overlays_DTC_Packets_DTC_DCSTransactionTracker_h
+#define artdaq_core_mu2e_Overlays_DTC_Packets_DTC_DCSTransactionTracker_h
+
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_DCSReplyPacket.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_DCSRequestPacket.h"
+
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_DCSOperationType.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_Link_ID.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace DTCLib {
+
+/// <summary>
+/// Bit flags describing the outcome of a DCS transaction
+/// </summary>
+enum DTC_DCSTransactionStatus : uint8_t
+{
+	DTC_DCSTransactionStatus_OK = 0,
+	DTC_DCSTransactionStatus_Timeout = 0x1,      ///< ROC replied with DTC_DCSOperationType_Timeout
+	DTC_DCSTransactionStatus_InvalidS2C = 0x2,   ///< ROC replied with DTC_DCSOperationType_InvalidS2C
+	DTC_DCSTransactionStatus_ROCCorrupt = 0x4,   ///< "I am corrupt" flag was set in the reply
+	DTC_DCSTransactionStatus_DTCError = 0x8,     ///< One or more DTC error bits were set in the reply
+	DTC_DCSTransactionStatus_Expired = 0x10,     ///< No reply was received before DTC_DCSTransactionTracker::ExpireOlderThan
+	DTC_DCSTransactionStatus_Unsolicited = 0x20, ///< Reply did not match any outstanding request
+};
+
+/// <summary>
+/// A matched (or expired/unsolicited) DCS request/reply pair
+/// </summary>
+struct DTC_DCSTransaction
+{
+	uint64_t sequence{0};                                       ///< Order in which the request was registered
+	DTC_Link_ID link{DTC_Link_Unused};                          ///< Link of the ROC
+	DTC_DCSOperationType requestType{DTC_DCSOperationType_Unknown};  ///< Opcode of the request
+	DTC_DCSOperationType replyType{DTC_DCSOperationType_Unknown};    ///< Opcode of the reply (Unknown if no reply)
+	uint16_t address{0};                                        ///< Op1 address of the request
+	uint16_t requestData{0};                                    ///< Op1 write data (or block word count) of the request
+	uint16_t replyData{0};                                      ///< Op1 data (or block word count) of the reply
+	uint16_t address2{0};                                       ///< Op2 address (double operations only)
+	uint16_t replyData2{0};                                     ///< Op2 data of the reply (double operations only)
+	uint8_t dtcErrorBits{0};                                    ///< DTC error bits of the reply
+	uint8_t status{DTC_DCSTransactionStatus_OK};                ///< DTC_DCSTransactionStatus bit flags
+	std::chrono::steady_clock::time_point requestTime{};        ///< Time the request was registered
+	std::chrono::steady_clock::time_point replyTime{};          ///< Time the reply was registered
+
+	/// <summary>
+	/// Whether the transaction completed without any error flag
+	/// </summary>
+	/// <returns>True if status is DTC_DCSTransactionStatus_OK</returns>
+	bool IsOK() const { return status == DTC_DCSTransactionStatus_OK; }
+
+	/// <summary>
+	/// Round-trip time of the transaction
+	/// </summary>
+	/// <returns>Time between request and reply, or zero if there was no reply</returns>
+	std::chrono::nanoseconds RoundTripTime() const
+	{
+		if (status & (DTC_DCSTransactionStatus_Expired | DTC_DCSTransactionStatus_Unsolicited)) return std::chrono::nanoseconds(0);
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(replyTime - requestTime);
+	}
+};
+
+/// <summary>
+/// Round-trip statistics for the DCS transactions on one link
+/// </summary>
+struct DTC_DCSLinkTiming
+{
+	uint64_t count{0};        ///< Number of matched transactions
+	uint64_t sum_ns{0};       ///< Sum of round-trip times, in ns
+	uint64_t min_ns{0};       ///< Minimum round-trip time, in ns
+	uint64_t max_ns{0};       ///< Maximum round-trip time, in ns
+	uint64_t last_ns{0};      ///< Most recent round-trip time, in ns
+	uint64_t errors{0};       ///< Number of transactions with any error flag
+	uint64_t expired{0};      ///< Number of requests which never received a reply
+
+	/// <summary>
+	/// Mean round-trip time
+	/// </summary>
+	/// <returns>Mean round-trip time in ns, or 0 if no transactions were matched</returns>
+	double MeanNs() const { return count > 0 ? static_cast<double>(sum_ns) / count : 0.0; }
+};
+
+/// <summary>
+/// Pairs DTC_DCSReplyPackets with the DTC_DCSRequestPackets that caused them, allowing many outstanding DCS operations per link.
+///
+/// Requests are kept in a fixed-capacity open-addressing table keyed by (link, opcode, address). Replies are matched to the
+/// oldest outstanding request with the same key; Timeout and InvalidS2C replies, which do not carry the original opcode, are
+/// matched by (link, address) alone. Completed transactions are accumulated and handed out in batches by DrainCompleted.
+///
+/// This class is not thread-safe; it is intended to be owned by the thread which drives the DCS traffic of a DTC.
+/// </summary>
+class DTC_DCSTransactionTracker
+{
+public:
+	/// Default number of in-flight slots
+	static const size_t DEFAULT_CAPACITY = 256;
+
+	/// <summary>
+	/// Construct a DTC_DCSTransactionTracker
+	/// </summary>
+	/// <param name="capacity">Maximum number of outstanding requests, rounded up to a power of two</param>
+	explicit DTC_DCSTransactionTracker(size_t capacity = DEFAULT_CAPACITY);
+
+	/// <summary>
+	/// Register a request which has been sent to a ROC. Write operations which do not request an acknowledgement
+	/// produce no reply and are not tracked.
+	/// </summary>
+	/// <param name="request">Request that was sent</param>
+	/// <param name="when">Time the request was sent (Default: now)</param>
+	/// <returns>False if the in-flight table is full (the request was not registered), true otherwise</returns>
+	bool RequestSent(const DTC_DCSRequestPacket& request, std::chrono::steady_clock::time_point when = std::chrono::steady_clock::now());
+
+	/// <summary>
+	/// Register a reply received from a ROC. The matched transaction (or an Unsolicited record if no request matched)
+	/// is added to the completed batch.
+	/// </summary>
+	/// <param name="reply">Reply that was received</param>
+	/// <param name="when">Time the reply was received (Default: now)</param>
+	/// <returns>True if the reply was matched to an outstanding request</returns>
+	bool ReplyReceived(const DTC_DCSReplyPacket& reply, std::chrono::steady_clock::time_point when = std::chrono::steady_clock::now());
+
+	/// <summary>
+	/// Move all requests older than the given age to the completed batch with the Expired flag set
+	/// </summary>
+	/// <param name="age">Maximum age of an outstanding request</param>
+	/// <param name="now">Current time (Default: now)</param>
+	/// <returns>Number of requests expired</returns>
+	size_t ExpireOlderThan(std::chrono::steady_clock::duration age, std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+	/// <summary>
+	/// Hand out the completed transactions accumulated since the last call. The contents of output are replaced,
+	/// and its storage is recycled for the next batch.
+	/// </summary>
+	/// <param name="output">Vector to receive the batch, in completion order</param>
+	/// <returns>Number of transactions in the batch</returns>
+	size_t DrainCompleted(std::vector<DTC_DCSTransaction>& output);
+
+	/// <summary>
+	/// Number of completed transactions waiting to be drained
+	/// </summary>
+	/// <returns>Number of completed transactions</returns>
+	size_t CompletedCount() const { return completed_.size(); }
+
+	/// <summary>
+	/// Number of requests waiting for a reply
+	/// </summary>
+	/// <returns>Number of in-flight requests</returns>
+	size_t InFlightCount() const { return in_flight_; }
+
+	/// <summary>
+	/// Number of outstanding requests on the given link
+	/// </summary>
+	/// <param name="link">Link to query</param>
+	/// <returns>Number of in-flight requests on the link</returns>
+	size_t InFlightCount(DTC_Link_ID link) const { return link_in_flight_[link & 0x7]; }
+
+	/// <summary>
+	/// Maximum number of in-flight requests
+	/// </summary>
+	/// <returns>Capacity of the in-flight table</returns>
+	size_t Capacity() const { return slots_.size(); }
+
+	/// <summary>
+	/// Get the round-trip statistics for the given link
+	/// </summary>
+	/// <param name="link">Link to query</param>
+	/// <returns>DTC_DCSLinkTiming for the link</returns>
+	const DTC_DCSLinkTiming& GetLinkTiming(DTC_Link_ID link) const { return link_timing_[link & 0x7]; }
+
+	/// <summary>
+	/// Reset the round-trip statistics of all links
+	/// </summary>
+	void ResetLinkTiming();
+
+	/// <summary>
+	/// Drop all outstanding requests and completed transactions
+	/// </summary>
+	void Clear();
+
+private:
+	struct Slot
+	{
+		bool used{false};
+		uint32_t key{0};
+		DTC_DCSTransaction transaction;
+	};
+
+	static const uint32_t OP_BITS = 0x30000;
+	static uint32_t MakeKey(DTC_Link_ID link, uint8_t op, uint16_t address)
+	{
+		return (static_cast<uint32_t>(link & 0x7) << 18) | (static_cast<uint32_t>(op & 0x3) << 16) | address;
+	}
+	// Opcode bits are excluded from the hash so that replies without an opcode probe the same chain
+	size_t HomeSlot(uint32_t key) const { return ((key & ~OP_BITS) * 0x9E3779B1u >> 8) & mask_; }
+	size_t FindOldest(uint32_t key, uint32_t keyMask) const;
+	void Erase(size_t index);
+
+	std::vector<Slot> slots_;
+	size_t mask_;
+	size_t in_flight_{0};
+	uint64_t next_sequence_{0};
+	std::array<size_t, 8> link_in_flight_{};
+	std::array<DTC_DCSLinkTiming, 8> link_timing_{};
+	std::vector<DTC_DCSTransaction> completed_;
+};
+
+}  // namespace DTCLib
+
+#endif  // artdaq_core_mu2e_Overlays_DTC_Packets_DTC_DCSTransactionTracker_h
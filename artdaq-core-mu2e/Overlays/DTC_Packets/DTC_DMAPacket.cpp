@@ -1,9 +1,9 @@
 #include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_DMAPacket.h"
 
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_BitExtract.h"
+
 #include "TRACE/trace.h"
 
-#include <iomanip>
-#include <sstream>
 
 DTCLib::DTC_DMAPacket::DTC_DMAPacket(DTC_PacketType type, DTC_Link_ID link, uint16_t byteCount, bool valid, uint8_t subsystemID, uint8_t hopCount)
 	: byteCount_(byteCount), valid_(valid), subsystemID_(subsystemID), linkID_(link), packetType_(type), hopCount_(hopCount) {}
@@ -34,18 +34,13 @@ DTCLib::DTC_DataPacket DTCLib::DTC_DMAPacket::ConvertToDataPacket() const
 
 DTCLib::DTC_DMAPacket::DTC_DMAPacket(const DTC_DataPacket in)
 {
-	auto word2 = in.GetData()[2];
-	uint8_t hopCount = word2 & 0xF;
-	uint8_t packetType = (word2 >> 4) & 0xF;
-	auto word3 = in.GetData()[3];
-	uint8_t linkID = word3 & 0x7;
-	valid_ = (word3 & 0x80) == 0x80;
-	subsystemID_ = (in.GetData()[5] >> 5) & 0x7;
-
-	byteCount_ = in.GetData()[0] + (in.GetData()[1] << 8);
-	hopCount_ = hopCount;
-	linkID_ = static_cast<DTC_Link_ID>(linkID);
-	packetType_ = static_cast<DTC_PacketType>(packetType);
+	auto arr = in.GetData();
+	byteCount_ = static_cast<uint16_t>(ExtractBits<0, 16>(arr));
+	hopCount_ = static_cast<uint8_t>(ExtractBits<16, 4>(arr));
+	packetType_ = static_cast<DTC_PacketType>(ExtractBits<20, 4>(arr));
+	linkID_ = static_cast<DTC_Link_ID>(ExtractBits<24, 3>(arr));
+	valid_ = ExtractBits<31, 1>(arr) != 0;
+	subsystemID_ = static_cast<uint8_t>(ExtractBits<45, 3>(arr));
 
 	// This TRACE can be time-consuming!
 #ifndef __OPTIMIZE__
@@ -55,37 +50,54 @@ DTCLib::DTC_DMAPacket::DTC_DMAPacket(const DTC_DataPacket in)
 
 std::string DTCLib::DTC_DMAPacket::headerJSON() const
 {
-	std::stringstream ss;
-	ss << "\t\"byteCount\": " << std::hex << "0x" << static_cast<int>(byteCount_);
-	ss << ",\n\t\"isValid\": " << valid_;
-	ss << ",\n\t\"subsystemID\": " << std::hex << "0x" << static_cast<int>(subsystemID_);
-	ss << ",\n\t\"linkID\": " << std::dec << linkID_;
-	ss << ",\n\t\"packetType\": " << static_cast<int>(packetType_);
-	ss << ",\n\t\"hopCount\": " << std::hex << "0x" << static_cast<int>(hopCount_);
-
-	return ss.str();
+	DTC_TextBuffer buf;
+	AppendHeaderJSON(buf);
+	return buf.str();
+}
+
+void DTCLib::DTC_DMAPacket::AppendHeaderJSON(DTC_TextBuffer& buf) const
+{
+	buf.Append("\t\"byteCount\": 0x").Hex(byteCount_);
+	buf.Append(",\n\t\"isValid\": ").Dec(valid_);
+	buf.Append(",\n\t\"subsystemID\": 0x").Hex(subsystemID_);
+	buf.Append(",\n\t\"linkID\": ").Dec(linkID_);
+	buf.Append(",\n\t\"packetType\": ").Dec(packetType_);
+	buf.Append(",\n\t\"hopCount\": 0x").Hex(hopCount_);
 }
 
 std::string DTCLib::DTC_DMAPacket::headerPacketFormat() const
 {
-	std::stringstream ss;
-	ss << std::setfill('0') << std::hex;
-	ss << "0x" << std::setw(6) << ((byteCount_ & 0xFF00) >> 8) << "\t"
-		<< "0x" << std::setw(6) << (byteCount_ & 0xFF) << std::endl;
-	ss << std::setw(1) << static_cast<int>(valid_) << " "
-		<< std::setw(2) << std::dec << static_cast<int>(subsystemID_) << std::hex << " "
-		<< "0x" << std::setw(2) << linkID_ << "\t";
-	ss << "0x" << std::setw(2) << static_cast<int>(packetType_) << "0x" << std::setw(2) << 0 << std::endl;
-	return ss.str();
+	DTC_TextBuffer buf;
+	AppendHeaderPacketFormat(buf);
+	return buf.str();
+}
+
+void DTCLib::DTC_DMAPacket::AppendHeaderPacketFormat(DTC_TextBuffer& buf) const
+{
+	buf.Append("0x").Hex((byteCount_ & 0xFF00) >> 8, 6).Append("\t0x").Hex(byteCount_ & 0xFF, 6).Append('\n');
+	buf.Dec(valid_, 1).Append(' ').Dec(subsystemID_, 2).Append(" 0x").Hex(linkID_, 2).Append('\t');
+	buf.Append("0x").Hex(packetType_, 2).Append("0x").Hex(0, 2).Append('\n');
 }
 
 std::string DTCLib::DTC_DMAPacket::toJSON()
 {
-	std::stringstream ss;
-	ss << "\"DMAPacket\": {\n";
-	ss << headerJSON();
-	ss << "\n}";
-	return ss.str();
+	DTC_TextBuffer buf;
+	AppendJSON(buf);
+	return buf.str();
+}
+
+void DTCLib::DTC_DMAPacket::AppendJSON(DTC_TextBuffer& buf) const
+{
+	buf.Append("\"DMAPacket\": {\n");
+	AppendHeaderJSON(buf);
+	buf.Append("\n}");
+}
+
+std::string DTCLib::DTC_DMAPacket::toPacketFormat()
+{
+	DTC_TextBuffer buf;
+	AppendPacketFormat(buf);
+	return buf.str();
 }
 
-std::string DTCLib::DTC_DMAPacket::toPacketFormat() { return headerPacketFormat(); }
+void DTCLib::DTC_DMAPacket::AppendPacketFormat(DTC_TextBuffer& buf) const { AppendHeaderPacketFormat(buf); }
@@ -5,6 +5,7 @@
 #include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_DataPacket.h"
 
 #include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_Link_ID.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_TextBuffer.h"
 
 #include <cstdint>
 #include <ostream>
@@ -95,6 +96,16 @@ public:
 	/// </summary>
 	/// <returns>"packet format" string representation of DMA header information</returns>
 	std::string headerPacketFormat() const;
+	/// <summary>
+	/// Append the DMA Header in JSON to the given buffer (See headerJSON())
+	/// </summary>
+	/// <param name="buf">Buffer to append to</param>
+	void AppendHeaderJSON(DTC_TextBuffer& buf) const;
+	/// <summary>
+	/// Append the DMA header in "packet format" to the given buffer (See headerPacketFormat())
+	/// </summary>
+	/// <param name="buf">Buffer to append to</param>
+	void AppendHeaderPacketFormat(DTC_TextBuffer& buf) const;
 
 	/// <summary>
 	/// Returns if the DTC thinks the packet is valid
@@ -144,6 +155,16 @@ public:
 	/// </summary>
 	/// <returns>JSON-formatted string representation of DMA packet</returns>
 	virtual std::string toJSON();
+	/// <summary>
+	/// Append the "packet format" representation of the packet to the given buffer (See toPacketFormat())
+	/// </summary>
+	/// <param name="buf">Buffer to append to</param>
+	virtual void AppendPacketFormat(DTC_TextBuffer& buf) const;
+	/// <summary>
+	/// Append the JSON representation of the packet to the given buffer (See toJSON())
+	/// </summary>
+	/// <param name="buf">Buffer to append to</param>
+	virtual void AppendJSON(DTC_TextBuffer& buf) const;
 
 	/// <summary>
 	/// Stream the JSON representation of the DTC_DMAPacket to the given stream
@@ -3,6 +3,7 @@
 
 #include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_DataHeaderPacket.h"
 #include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_DataPacket.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_BufferPool.h"
 
 #include <cassert>
 #include <cstdint>
@@ -17,7 +18,7 @@ namespace DTCLib {
 /// </summary>
 struct DTC_DataBlock
 {
-	std::shared_ptr<std::vector<uint8_t>> allocBytes{nullptr};  ///< Used if the block owns its memory
+	std::shared_ptr<DTC_Buffer> allocBytes{nullptr};  ///< Used if the block owns its memory
 	const void* blockPointer{nullptr};                          ///< Pointer to DataBlock in Memory
 	size_t byteSize{0};                                         ///< Size of DataBlock
 private:
@@ -45,17 +46,24 @@ public:
 	DTC_DataBlock(const void* ptr, size_t sz)
 		: blockPointer(ptr), byteSize(sz) {}
 
+	/// <summary>
+	/// Create a DTC_DataBlock owning an uninitialized buffer of the given size from the default DTC_BufferSource
+	/// </summary>
+	/// <param name="sz">Size of DataBlock</param>
 	DTC_DataBlock(size_t sz)
-		: allocBytes(new std::vector<uint8_t>(sz)), blockPointer(allocBytes->data()), byteSize(sz)
+		: allocBytes(DTC_BufferSource::GetDefault()->Get(sz)), blockPointer(allocBytes->data()), byteSize(sz)
 	{
 	}
 
 	inline std::shared_ptr<DTC_DataHeaderPacket> GetHeader() const
 	{
 		assert(byteSize >= 16);
-		if (hdr) return hdr;
-		hdr = std::make_shared<DTC_DataHeaderPacket>(DTC_DataPacket(blockPointer));
-		return hdr;
+		// Atomic publication, so that several threads may call GetHeader on the same const DTC_DataBlock
+		auto cached = std::atomic_load(&hdr);
+		if (cached) return cached;
+		auto created = std::make_shared<DTC_DataHeaderPacket>(DTC_DataPacket(blockPointer));
+		if (std::atomic_compare_exchange_strong(&hdr, &cached, created)) return created;
+		return cached;
 	}
 
 	inline const void* GetRawBufferPointer() const
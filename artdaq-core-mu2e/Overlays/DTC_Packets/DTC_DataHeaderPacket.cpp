@@ -1,5 +1,6 @@
 #include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_DataHeaderPacket.h"
 
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_BitExtract.h"
 #include "artdaq-core-mu2e/Overlays/DTC_Types/Exceptions.h"
 
 #include "TRACE/tracemf.h"
@@ -21,12 +22,12 @@ DTCLib::DTC_DataHeaderPacket::DTC_DataHeaderPacket(DTC_DataPacket in)
 		throw ex;
 	}
 	auto arr = in.GetData();
-	packetCount_ = arr[4] + ((arr[5]&7) << 8);
-	event_tag_ = DTC_EventWindowTag(arr, 6);
-	status_ = arr[12];
-	dataPacketVersion_ = arr[13];
-	dtcId_ = arr[14];
-	evbMode_ = arr[15];
+	packetCount_ = static_cast<uint16_t>(ExtractBits<32, 11>(arr));
+	event_tag_ = DTC_EventWindowTag(ExtractBits<48, 48>(arr));
+	status_ = static_cast<uint8_t>(ExtractBits<96, 8>(arr));
+	dataPacketVersion_ = static_cast<uint8_t>(ExtractBits<104, 8>(arr));
+	dtcId_ = static_cast<uint8_t>(ExtractBits<112, 8>(arr));
+	evbMode_ = static_cast<uint8_t>(ExtractBits<120, 8>(arr));
 
 	if ((packetCount_ + 1) * 16 != byteCount_) {
 		auto ex = DTC_WrongPacketSizeException((packetCount_ + 1) * 16, byteCount_);
@@ -37,32 +38,27 @@ DTCLib::DTC_DataHeaderPacket::DTC_DataHeaderPacket(DTC_DataPacket in)
 	}
 }
 
-std::string DTCLib::DTC_DataHeaderPacket::toJSON()
+void DTCLib::DTC_DataHeaderPacket::AppendJSON(DTC_TextBuffer& buf) const
 {
-	std::stringstream ss;
-	ss << "\"DataHeaderPacket\": {\n";
-	ss << headerJSON();
-	ss << ",\n\t\"packetCount\": " << std::dec << static_cast<int>(packetCount_);
-	ss << ",\n" << event_tag_.toJSON();
-	ss << ",\n\t\"status\": " << std::dec << static_cast<int>(status_);
-	ss << ",\n\t\"packetVersion\": " << std::hex << static_cast<int>(dataPacketVersion_);
-	ss << ",\n\t\"DTC ID\": " << std::dec << static_cast<int>(dtcId_);
-	ss << ",\n\t\"evbMode\": " << std::hex << "0x" << static_cast<int>(evbMode_);
-	ss << "\n}";
-	return ss.str();
+	buf.Append("\"DataHeaderPacket\": {\n");
+	AppendHeaderJSON(buf);
+	buf.Append(",\n\t\"packetCount\": ").Dec(packetCount_);
+	buf.Append(",\n");
+	event_tag_.AppendJSON(buf);
+	buf.Append(",\n\t\"status\": ").Dec(status_);
+	buf.Append(",\n\t\"packetVersion\": ").Hex(dataPacketVersion_);
+	buf.Append(",\n\t\"DTC ID\": ").Dec(dtcId_);
+	buf.Append(",\n\t\"evbMode\": 0x").Hex(evbMode_);
+	buf.Append("\n}");
 }
 
-std::string DTCLib::DTC_DataHeaderPacket::toPacketFormat()
+void DTCLib::DTC_DataHeaderPacket::AppendPacketFormat(DTC_TextBuffer& buf) const
 {
-	std::stringstream ss;
-	ss << headerPacketFormat() << std::setfill('0') << std::hex;
-	ss << "     0x" << std::setw(1) << ((packetCount_ & 0x0700) >> 8) << "\t"
-		<< "0x" << std::setw(6) << (packetCount_ & 0xFF) << "\n";
-	ss << event_tag_.toPacketFormat();
-	ss << "0x" << std::setw(6) << static_cast<int>(dataPacketVersion_) << "\t"
-		<< "0x" << std::setw(6) << static_cast<int>(status_) << "\n";
-	ss << "0x" << std::setw(6) << static_cast<int>(evbMode_) << "\t" << std::dec << std::setw(8) << static_cast<int>(dtcId_) << "\n";
-	return ss.str();
+	AppendHeaderPacketFormat(buf);
+	buf.Append("     0x").Hex((packetCount_ & 0x0700) >> 8, 1).Append("\t0x").Hex(packetCount_ & 0xFF, 6).Append('\n');
+	event_tag_.AppendPacketFormat(buf);
+	buf.Append("0x").Hex(dataPacketVersion_, 6).Append("\t0x").Hex(status_, 6).Append('\n');
+	buf.Append("0x").Hex(evbMode_, 6).Append('\t').Dec(dtcId_, 8).Append('\n');
 }
 
 DTCLib::DTC_DataPacket DTCLib::DTC_DataHeaderPacket::ConvertToDataPacket() const
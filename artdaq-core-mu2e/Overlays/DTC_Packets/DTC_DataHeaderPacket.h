@@ -97,15 +97,15 @@ public:
 	uint8_t GetStatus() const { return status_; }
 
 	/// <summary>
-	/// Convert the DTC_DataHeaderPacket to JSON representation
+	/// Append the JSON representation of the DTC_DataHeaderPacket to the given buffer
 	/// </summary>
-	/// <returns>JSON-formatted string representation of DTC_DataHeaderPacket</returns>
-	std::string toJSON() override;
+	/// <param name="buf">Buffer to append to</param>
+	void AppendJSON(DTC_TextBuffer& buf) const override;
 	/// <summary>
-	/// Converts the DTC_DataHeaderPacket to "packet format" representation (See DTC_DataPacket::toPacketFormat())
+	/// Append the "packet format" representation of the DTC_DataHeaderPacket to the given buffer (See DTC_DataPacket::toPacketFormat())
 	/// </summary>
-	/// <returns>"packet format" string representation of DTC_DataHeaderPacket</returns>
-	std::string toPacketFormat() override;
+	/// <param name="buf">Buffer to append to</param>
+	void AppendPacketFormat(DTC_TextBuffer& buf) const override;
 
 	/// <summary>
 	/// Determine if two Data Header packets are equal (Evaluates DataPacket == DataPacket, see DTC_DataPacket::Equals)
@@ -1,7 +1,6 @@
 #include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_DataPacket.h"
 
-#include <iomanip>
-#include <sstream>
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_BitExtract.h"
 
 DTCLib::DTC_DataPacket::DTC_DataPacket()
 {
@@ -65,34 +64,35 @@ bool DTCLib::DTC_DataPacket::Resize(const uint16_t dmaSize)
 
 std::string DTCLib::DTC_DataPacket::toJSON() const
 {
-	std::stringstream ss;
-	ss << "\"DataPacket\": {";
-	ss << "\"data\": [";
-	ss << std::hex << std::setfill('0');
-	uint16_t jj = 0;
-	for (uint16_t ii = 0; ii < dataSize_ - 2; ii += 2)
-	{
-		ss << "0x" << std::setw(4) << static_cast<int>(reinterpret_cast<uint16_t const*>(dataPtr_)[jj]) << ",";
-		++jj;
-	}
-	ss << "0x" << std::setw(4) << static_cast<int>(reinterpret_cast<uint16_t const*>(dataPtr_)[jj]) << "]";
-	ss << "}";
-	return ss.str();
+	DTC_TextBuffer buf;
+	AppendJSON(buf);
+	return buf.str();
+}
+
+void DTCLib::DTC_DataPacket::AppendJSON(DTC_TextBuffer& buf) const
+{
+	buf.Append("\"DataPacket\": {");
+	AppendPacketFormat(buf);
+	buf.Append('}');
 }
 
 std::string DTCLib::DTC_DataPacket::toPacketFormat() const
 {
-	std::stringstream ss;
-	ss << "\"data\": [";
-	ss << std::hex << std::setfill('0');
+	DTC_TextBuffer buf;
+	AppendPacketFormat(buf);
+	return buf.str();
+}
+
+void DTCLib::DTC_DataPacket::AppendPacketFormat(DTC_TextBuffer& buf) const
+{
+	buf.Append("\"data\": [");
 	uint16_t jj = 0;
 	for (uint16_t ii = 0; ii < dataSize_ - 2; ii += 2)
 	{
-		ss << "0x" << std::setw(4) << static_cast<int>(reinterpret_cast<uint16_t const*>(dataPtr_)[jj]) << ",";
+		buf.Append("0x").Hex(LoadLE<uint16_t>(dataPtr_ + 2 * jj), 4).Append(',');
 		++jj;
 	}
-	ss << "0x" << std::setw(4) << static_cast<int>(reinterpret_cast<uint16_t const*>(dataPtr_)[jj]) << "]";
-	return ss.str();
+	buf.Append("0x").Hex(LoadLE<uint16_t>(dataPtr_ + 2 * jj), 4).Append(']');
 }
 
 bool DTCLib::DTC_DataPacket::Equals(const DTC_DataPacket& other) const
@@ -1,6 +1,8 @@
 #ifndef artdaq_core_mu2e_Overlays_DTC_Packets_DTC_DataPacket_h
 #define artdaq_core_mu2e_Overlays_DTC_Packets_DTC_DataPacket_h
 
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_TextBuffer.h"
+
 #include <cstdint>
 #include <cstring>
 #include <ostream>
@@ -81,6 +83,16 @@ public:
 	/// <returns>"packet format" string representation of the DTC_DataPacket</returns>
 	std::string toPacketFormat() const;
 	/// <summary>
+	/// Append the JSON representation of the DTC_DataPacket to the given buffer (See toJSON())
+	/// </summary>
+	/// <param name="buf">Buffer to append to</param>
+	void AppendJSON(DTC_TextBuffer& buf) const;
+	/// <summary>
+	/// Append the "packet format" representation of the DTC_DataPacket to the given buffer (See toPacketFormat())
+	/// </summary>
+	/// <param name="buf">Buffer to append to</param>
+	void AppendPacketFormat(DTC_TextBuffer& buf) const;
+	/// <summary>
 	/// Resize a DTC_DataPacket in "owner" mode. New size must be larger than current.
 	/// </summary>
 	/// <param name="dmaSize">Size in bytes of the new packet</param>
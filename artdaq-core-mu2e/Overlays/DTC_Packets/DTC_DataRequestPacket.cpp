@@ -27,30 +27,25 @@ DTCLib::DTC_DataRequestPacket::DTC_DataRequestPacket(DTC_DataPacket in)
 	debugPacketCount_ = in.GetData()[14] + (in.GetData()[15] << 8);
 }
 
-std::string DTCLib::DTC_DataRequestPacket::toJSON()
+void DTCLib::DTC_DataRequestPacket::AppendJSON(DTC_TextBuffer& buf) const
 {
-	std::stringstream ss;
-	ss << "\"DataRequestPacket\": {";
-	ss << headerJSON() << ",";
-	ss << event_tag_.toJSON() << ",";
-	ss << "\"debug\":" << (debug_ ? "true" : "false") << ",";
-	ss << "\"debugPacketCount\": " << std::dec << static_cast<int>(debugPacketCount_) << ",";
-	ss << DTC_DebugTypeConverter(type_);
-	ss << "}";
-	return ss.str();
+	buf.Append("\"DataRequestPacket\": {");
+	AppendHeaderJSON(buf);
+	buf.Append(',');
+	event_tag_.AppendJSON(buf);
+	buf.Append(",\"debug\":").Append(debug_ ? "true" : "false");
+	buf.Append(",\"debugPacketCount\": ").Dec(debugPacketCount_);
+	buf.Append(",\"DTC_DebugType\":\"").Append(DTC_DebugTypeConverter(type_).toString()).Append('"');
+	buf.Append('}');
 }
 
-std::string DTCLib::DTC_DataRequestPacket::toPacketFormat()
+void DTCLib::DTC_DataRequestPacket::AppendPacketFormat(DTC_TextBuffer& buf) const
 {
-	std::stringstream ss;
-	ss << headerPacketFormat() << std::setfill('0') << std::hex;
-	ss << event_tag_.toPacketFormat();
-	ss << "        \t        \n";
-	ss << "        \t0x" << std::setw(2) << static_cast<int>(type_) << "   " << std::setw(1) << static_cast<int>(debug_)
-		<< "\n";
-	ss << "0x" << std::setw(6) << ((debugPacketCount_ & 0xFF00) >> 8) << "\t"
-		<< "0x" << std::setw(6) << (debugPacketCount_ & 0xFF) << "\n";
-	return ss.str();
+	AppendHeaderPacketFormat(buf);
+	event_tag_.AppendPacketFormat(buf);
+	buf.Append("        \t        \n");
+	buf.Append("        \t0x").Hex(type_, 2).Append("   ").Dec(debug_, 1).Append('\n');
+	buf.Append("0x").Hex((debugPacketCount_ & 0xFF00) >> 8, 6).Append("\t0x").Hex(debugPacketCount_ & 0xFF, 6).Append('\n');
 }
 
 DTCLib::DTC_DataPacket DTCLib::DTC_DataRequestPacket::ConvertToDataPacket() const
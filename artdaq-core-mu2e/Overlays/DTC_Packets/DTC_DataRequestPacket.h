@@ -90,15 +90,15 @@ public:
 	/// <returns>DTC_DataPacket with DTC_DataRequestPacket contents set</returns>
 	DTC_DataPacket ConvertToDataPacket() const override;
 	/// <summary>
-	/// Convert the DTC_DataRequestPacket to JSON representation
+	/// Append the JSON representation of the DTC_DataRequestPacket to the given buffer
 	/// </summary>
-	/// <returns>JSON-formatted string representation of DTC_DataRequestPacket</returns>
-	std::string toJSON() override;
+	/// <param name="buf">Buffer to append to</param>
+	void AppendJSON(DTC_TextBuffer& buf) const override;
 	/// <summary>
-	/// Converts the DTC_DataRequestPacket to "packet format" representation (See DTC_DataPacket::toPacketFormat())
+	/// Append the "packet format" representation of the DTC_DataRequestPacket to the given buffer (See DTC_DataPacket::toPacketFormat())
 	/// </summary>
-	/// <returns>"packet format" string representation of DTC_DataRequestPacket</returns>
-	std::string toPacketFormat() override;
+	/// <param name="buf">Buffer to append to</param>
+	void AppendPacketFormat(DTC_TextBuffer& buf) const override;
 
 private:
 	DTC_EventWindowTag event_tag_;
@@ -13,7 +13,7 @@ DTCLib::DTC_Event::DTC_Event(const void* data)
 }
 
 DTCLib::DTC_Event::DTC_Event(size_t data_size)
-	: allocBytes(new std::vector<uint8_t>(data_size)), header_(), sub_events_(), buffer_ptr_(allocBytes->data())
+	: allocBytes(DTC_BufferSource::GetDefault()->Get(data_size)), header_(), sub_events_(), buffer_ptr_(allocBytes->data())
 {
 	TLOG(TLVL_TRACE) << "Empty DTC_Event created, copy in data and call SetupEvent to finalize";
 }
@@ -97,67 +97,74 @@ void DTCLib::DTC_Event::WriteEvent(std::ostream& o, bool includeDMAWriteSize)
 	TLOG(TLVL_TRACE) << "Updating header byte counts";
 	UpdateHeader();
 
-	if (header_.inclusive_event_byte_count + sizeof(uint64_t) + (includeDMAWriteSize ? sizeof(uint64_t) : 0) < MAX_DMA_SIZE) {
-		TLOG(TLVL_TRACE) << "Event fits into one buffer, writing";
-		auto pos = o.tellp();
-		Utilities::WriteDMABufferSizeWords(o, includeDMAWriteSize, header_.inclusive_event_byte_count, pos, false);
-
-        TLOG(TLVL_TRACE) << "Writing DTC_EventHeader for event " << GetEventWindowTag().GetEventWindowTag(true) << " sz=" << sizeof(DTC_EventHeader);
-		o.write(reinterpret_cast<const char*>(&header_), sizeof(DTC_EventHeader));
+	WriteEvent([&o](const void* data, size_t size) { o.write(static_cast<const char*>(data), size); }, includeDMAWriteSize);
+}
 
-		for (auto& subevt : sub_events_)
-		{
-			TLOG(TLVL_TRACE) << "Writing DTC_SubEventHeader for DTC " << static_cast<int>(subevt.GetDTCID()) << " sz=" << sizeof(DTC_SubEventHeader);
-			o.write(reinterpret_cast<const char*>(subevt.GetHeader()), sizeof(DTC_SubEventHeader));
-			auto ii = 0;
-			for (auto& blk : subevt.GetDataBlocks())
-			{
-				TLOG(TLVL_TRACE) << "Writing Data Block " << ii << ", roc=" << blk.GetHeader()->GetLinkID() << ", sz=" << blk.byteSize;
-				o.write(static_cast<const char*>(blk.blockPointer), blk.byteSize);
-				++ii;
-			}
-		}
+void DTCLib::DTC_Event::WriteEvent(std::function<void(const void*, size_t)> const& write, bool includeDMAWriteSize) const
+{
+	const size_t size_words_bytes = sizeof(uint64_t) + (includeDMAWriteSize ? sizeof(uint64_t) : 0);
+	const bool single_buffer = header_.inclusive_event_byte_count + size_words_bytes < MAX_DMA_SIZE;
+	if (single_buffer)
+	{
+		TLOG(TLVL_TRACE) << "Event fits into one buffer, writing";
 	}
-	else 
+	else
 	{
 		TLOG(TLVL_TRACE) << "Event spans multiple buffers, beginning write";
-		auto buffer_start = o.tellp();
-		size_t bytes_written = Utilities::WriteDMABufferSizeWords(o, includeDMAWriteSize, header_.inclusive_event_byte_count, buffer_start, false);
-
-		o.write(reinterpret_cast<const char*>(&header_), sizeof(DTC_EventHeader));
-		size_t buffer_data_size = sizeof(DTC_EventHeader);
-		size_t total_data_size = 0;
+	}
 
+	// The event header, then each sub-event header followed by its DataBlocks. A new DMA buffer is started before any
+	// piece which would overflow the current one.
+	auto for_each_piece = [this](auto&& piece) {
+		piece(&header_, sizeof(DTC_EventHeader));
 		for (auto& subevt : sub_events_)
 		{
-			if (bytes_written + buffer_data_size + sizeof(DTC_SubEventHeader) > MAX_DMA_SIZE)
-			{
-				TLOG(TLVL_TRACE) << "Starting new buffer, writing size words " << buffer_data_size << " to old buffer";
-				Utilities::WriteDMABufferSizeWords(o, includeDMAWriteSize, buffer_data_size, buffer_start, true);
-				buffer_start = o.tellp();
-				total_data_size += buffer_data_size;
-				TLOG(TLVL_TRACE) << "Writing anticipated data size " << header_.inclusive_event_byte_count - total_data_size << " to new buffer.";
-				bytes_written = Utilities::WriteDMABufferSizeWords(o, includeDMAWriteSize, header_.inclusive_event_byte_count - total_data_size, buffer_start, false);
-				buffer_data_size = 0;
-			}
-			o.write(reinterpret_cast<const char*>(subevt.GetHeader()), sizeof(DTC_SubEventHeader));
-			buffer_data_size += sizeof(DTC_SubEventHeader);
+			piece(subevt.GetHeader(), sizeof(DTC_SubEventHeader));
 			for (auto& blk : subevt.GetDataBlocks())
 			{
-				if (bytes_written + buffer_data_size + blk.byteSize > MAX_DMA_SIZE) 
-				{
-					TLOG(TLVL_TRACE) << "Starting new buffer, writing size words " << buffer_data_size << " to old buffer";
-					Utilities::WriteDMABufferSizeWords(o, includeDMAWriteSize, buffer_data_size, buffer_start, true);
-					buffer_start = o.tellp();
-					total_data_size += buffer_data_size;
-					TLOG(TLVL_TRACE) << "Writing anticipated data size " << header_.inclusive_event_byte_count - total_data_size << " to new buffer.";
-					bytes_written = Utilities::WriteDMABufferSizeWords(o, includeDMAWriteSize, header_.inclusive_event_byte_count - total_data_size, buffer_start, false);
-					buffer_data_size = 0;
-				}
-				o.write(static_cast<const char*>(blk.blockPointer), blk.byteSize);
-				buffer_data_size += blk.byteSize;
+				piece(blk.blockPointer, blk.byteSize);
 			}
 		}
-	}
+	};
+	auto starts_buffer = [&](size_t buffer_data_size, size_t piece_size) {
+		return !single_buffer && size_words_bytes + buffer_data_size + piece_size > MAX_DMA_SIZE;
+	};
+
+	// The size words precede the data of each buffer, so the buffer sizes are laid out before anything is written
+	std::vector<size_t> buffer_sizes;
+	for_each_piece([&](const void*, size_t size) {
+		if (buffer_sizes.empty() || starts_buffer(buffer_sizes.back(), size)) buffer_sizes.push_back(0);
+		buffer_sizes.back() += size;
+	});
+
+	auto write_size_words = [&](size_t data_size) {
+		TLOG(TLVL_TRACE) << "Writing size words for DMA buffer of " << data_size << " bytes";
+		if (includeDMAWriteSize)
+		{
+			uint64_t dmaWriteSize = data_size + sizeof(uint64_t) + sizeof(uint64_t);
+			write(&dmaWriteSize, sizeof(uint64_t));
+		}
+		uint64_t dmaSize = data_size + sizeof(uint64_t);
+		write(&dmaSize, sizeof(uint64_t));
+	};
+
+	size_t buffer = 0;
+	size_t buffer_data_size = 0;
+	bool first_piece = true;
+	for_each_piece([&](const void* data, size_t size) {
+		if (first_piece)
+		{
+			write_size_words(buffer_sizes[0]);
+			first_piece = false;
+		}
+		else if (starts_buffer(buffer_data_size, size))
+		{
+			++buffer;
+			write_size_words(buffer_sizes[buffer]);
+			buffer_data_size = 0;
+		}
+		write(data, size);
+		buffer_data_size += size;
+	});
 }
 
@@ -9,6 +9,8 @@
 #include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_EventWindowTag.h"
 
 #include <cstdint>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <vector>
 
@@ -17,6 +19,89 @@ namespace DTCLib {
 class DTC_Event
 {
 public:
+	/// <summary>
+	/// Non-owning view of the sub-events of a DTC_Event which come from one subsystem. Iterating skips the sub-events
+	/// of other subsystems; nothing is copied. The view is valid as long as the sub-events of the DTC_Event are not
+	/// modified.
+	/// </summary>
+	class SubsystemRange
+	{
+	public:
+		/// <summary>
+		/// Forward iterator over the matching sub-events
+		/// </summary>
+		class const_iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;  ///< Iterator category
+			using value_type = DTC_SubEvent;                      ///< Value type
+			using difference_type = std::ptrdiff_t;               ///< Difference type
+			using pointer = const DTC_SubEvent*;                  ///< Pointer type
+			using reference = const DTC_SubEvent&;                ///< Reference type
+
+			/// <summary>
+			/// Construct an iterator, advancing to the first matching sub-event at or after it
+			/// </summary>
+			/// <param name="it">Position in the sub-event vector</param>
+			/// <param name="end">End of the sub-event vector</param>
+			/// <param name="subsys">Subsystem to match</param>
+			const_iterator(std::vector<DTC_SubEvent>::const_iterator it, std::vector<DTC_SubEvent>::const_iterator end, DTC_Subsystem subsys)
+				: it_(it), end_(end), subsys_(subsys) { Skip(); }
+
+			reference operator*() const { return *it_; }   ///< Dereference
+			pointer operator->() const { return &*it_; }  ///< Member access
+			/// <summary>
+			/// Advance to the next matching sub-event
+			/// </summary>
+			/// <returns>Reference to this iterator</returns>
+			const_iterator& operator++()
+			{
+				++it_;
+				Skip();
+				return *this;
+			}
+			/// <summary>
+			/// Advance to the next matching sub-event
+			/// </summary>
+			/// <returns>Copy of the iterator before it was advanced</returns>
+			const_iterator operator++(int)
+			{
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+			bool operator==(const_iterator const& other) const { return it_ == other.it_; }  ///< Compare positions
+			bool operator!=(const_iterator const& other) const { return it_ != other.it_; }  ///< Compare positions
+
+		private:
+			void Skip()
+			{
+				while (it_ != end_ && it_->GetSubsystem() != subsys_) ++it_;
+			}
+
+			std::vector<DTC_SubEvent>::const_iterator it_;
+			std::vector<DTC_SubEvent>::const_iterator end_;
+			DTC_Subsystem subsys_;
+		};
+
+		/// <summary>
+		/// Construct a SubsystemRange
+		/// </summary>
+		/// <param name="subEvents">Sub-events to filter</param>
+		/// <param name="subsys">Subsystem to match</param>
+		SubsystemRange(std::vector<DTC_SubEvent> const& subEvents, DTC_Subsystem subsys)
+			: sub_events_(&subEvents), subsys_(subsys) {}
+
+		const_iterator begin() const { return const_iterator(sub_events_->begin(), sub_events_->end(), subsys_); }  ///< First matching sub-event
+		const_iterator end() const { return const_iterator(sub_events_->end(), sub_events_->end(), subsys_); }      ///< End of the range
+		bool empty() const { return begin() == end(); }                                                             ///< Whether no sub-event matches
+		size_t size() const { return std::distance(begin(), end()); }                                               ///< Number of matching sub-events
+
+	private:
+		std::vector<DTC_SubEvent> const* sub_events_;
+		DTC_Subsystem subsys_;
+	};
+
 	/// <summary>
 	/// Construct a DTC_Event in "overlay" mode using the given DMA buffer pointer. Flag will be set that the packet
 	/// is read-only.
@@ -24,6 +109,10 @@ public:
 	/// <param name="data">Pointer data</param>
 	explicit DTC_Event(const void* data);
 
+	/// <summary>
+	/// Construct a DTC_Event owning an uninitialized buffer from the default DTC_BufferSource. Copy the data in, then call SetupEvent.
+	/// </summary>
+	/// <param name="data_size">Size of the buffer, in bytes</param>
 	explicit DTC_Event(size_t data_size);
 
 	DTC_Event()
@@ -72,6 +161,11 @@ public:
 		if (idx >= sub_events_.size()) throw std::out_of_range("Index " + std::to_string(idx) + " is out of range (max: " + std::to_string(sub_events_.size() - 1) + ")");
 		return &sub_events_[idx];
 	}
+	const DTC_SubEvent* GetSubEvent(size_t idx) const
+	{
+		if (idx >= sub_events_.size()) throw std::out_of_range("Index " + std::to_string(idx) + " is out of range (max: " + std::to_string(sub_events_.size() - 1) + ")");
+		return &sub_events_[idx];
+	}
 
 	void AddSubEvent(DTC_SubEvent subEvt)
 	{
@@ -89,6 +183,13 @@ public:
 		return nullptr;
 	}
 
+	/// <summary>
+	/// Get a non-owning view of the sub-events from the given subsystem
+	/// </summary>
+	/// <param name="subsys">Subsystem to select</param>
+	/// <returns>SubsystemRange over the matching sub-events</returns>
+	SubsystemRange GetSubsystemRange(DTC_Subsystem subsys) const { return SubsystemRange(sub_events_, subsys); }
+
 	std::vector<DTC_SubEvent> GetSubsystemData(DTC_Subsystem subsys) const {
 		std::vector<DTC_SubEvent> output;
 
@@ -102,12 +203,21 @@ public:
 	}
 
 	DTC_EventHeader* GetHeader() { return &header_; }
+	const DTC_EventHeader* GetHeader() const { return &header_; }
 
 	void UpdateHeader();
 	void WriteEvent(std::ostream& output, bool includeDMAWriteSize = true);
+	/// <summary>
+	/// Write the event in the DMA-framed format of WriteEvent(std::ostream&), as a sequence of write calls. The size words
+	/// of each DMA buffer are computed up front, so the output does not need to be seekable. The header is not updated;
+	/// call UpdateHeader first if the event was modified.
+	/// </summary>
+	/// <param name="write">Called with each piece of the output, in order. The pointer is only valid during the call.</param>
+	/// <param name="includeDMAWriteSize">Whether to precede each DMA buffer with the DMA Write Size word used by the detector emulator</param>
+	void WriteEvent(std::function<void(const void*, size_t)> const& write, bool includeDMAWriteSize = true) const;
 
 private:
-	std::shared_ptr<std::vector<uint8_t>> allocBytes{nullptr};  ///< Used if the block owns its memory
+	std::shared_ptr<DTC_Buffer> allocBytes{nullptr};  ///< Used if the block owns its memory
 	DTC_EventHeader header_;
 	std::vector<DTC_SubEvent> sub_events_;
 	const void* buffer_ptr_;
@@ -1,6 +1,8 @@
 #ifndef artdaq_core_mu2e_Overlays_DTC_Packets_DTC_EventHeader_h
 #define artdaq_core_mu2e_Overlays_DTC_Packets_DTC_EventHeader_h
 
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_TextBuffer.h"
+
 #include <cstdint>
 #include <iomanip>
 #include <sstream>
@@ -44,23 +46,27 @@ struct DTC_EventHeader
 
 	inline std::string toJson() const
 	{
-		std::ostringstream oss;
-
-		oss << "\"DTC_EventHeader\": {\n";
-		oss << "\t\"inclusive_event_byte_count\": " << inclusive_event_byte_count;
-		oss << ",\n\t\"event_tag_low\": " << event_tag_low;
-		oss << ",\n\t\"event_tag_high\": " << event_tag_high;
-		oss << ",\n\t\"num_dtcs\": " << num_dtcs;
-		oss << ",\n\t\"event_mode\": 0x" << std::hex << event_mode;
-		oss << ",\n\t\"dtc_mac\": " << dtc_mac;
-		oss << ",\n\t\"partition_id\": " << partition_id;
-		oss << ",\n\t\"evb_mode\": " << evb_mode;
-		oss << ",\n\t\"evb_id\": " << evb_id;
-		oss << ",\n\t\"evb_status\": " << evb_status;
-		oss << ",\n\t\"emtdc\": " << emtdc;
-		oss << "\n}";
+		DTC_TextBuffer buf;
+		AppendJson(buf);
+		return buf.str();
+	}
 
-		return oss.str();
+	inline void AppendJson(DTC_TextBuffer& buf) const
+	{
+		buf.Append("\"DTC_EventHeader\": {\n");
+		buf.Append("\t\"inclusive_event_byte_count\": ").Dec(inclusive_event_byte_count);
+		buf.Append(",\n\t\"event_tag_low\": ").Dec(event_tag_low);
+		buf.Append(",\n\t\"event_tag_high\": ").Dec(event_tag_high);
+		buf.Append(",\n\t\"num_dtcs\": ").Dec(num_dtcs);
+		// Every field after event_mode has always been printed in hex (without prefix)
+		buf.Append(",\n\t\"event_mode\": 0x").Hex(event_mode);
+		buf.Append(",\n\t\"dtc_mac\": ").Hex(dtc_mac);
+		buf.Append(",\n\t\"partition_id\": ").Hex(partition_id);
+		buf.Append(",\n\t\"evb_mode\": ").Hex(evb_mode);
+		buf.Append(",\n\t\"evb_id\": ").Hex(evb_id);
+		buf.Append(",\n\t\"evb_status\": ").Hex(evb_status);
+		buf.Append(",\n\t\"emtdc\": ").Hex(emtdc);
+		buf.Append("\n}");
 	}
 };
 
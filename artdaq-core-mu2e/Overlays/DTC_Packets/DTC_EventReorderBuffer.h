@@ -0,0 +1,224 @@
+#ifndef artdaq_core_mu2e_Overlays_DTC_Packets_DTC_EventReorderBuffer_h
+#define artdaq_core_mu2e_Overlays_DTC_Packets_DTC_EventReorderBuffer_h
+
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_EventWindowTag.h"
+
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace DTCLib {
+
+/// <summary>
+/// Result of DTC_EventReorderBuffer::Insert
+/// </summary>
+enum DTC_ReorderStatus : uint8_t
+{
+	DTC_ReorderStatus_Accepted = 0,   ///< Event was buffered
+	DTC_ReorderStatus_Late = 1,       ///< Events with a later EWT were already released; the event was not buffered. Call Reset if the EWT was reset.
+	DTC_ReorderStatus_Duplicate = 2,  ///< An event with the same EWT is already buffered; the event was not buffered
+	DTC_ReorderStatus_Full = 3,       ///< EWT is beyond the window; Pop with force until Insert succeeds
+};
+
+/// <summary>
+/// Counters of a DTC_EventReorderBuffer
+/// </summary>
+struct DTC_ReorderCounters
+{
+	uint64_t released{0};    ///< Events released by Pop
+	uint64_t skipped{0};     ///< EWTs given up on because of the latency limit or a forced Pop
+	uint64_t late{0};        ///< Inserts rejected as DTC_ReorderStatus_Late
+	uint64_t duplicates{0};  ///< Inserts rejected as DTC_ReorderStatus_Duplicate
+	uint64_t full{0};        ///< Inserts rejected as DTC_ReorderStatus_Full
+};
+
+/// <summary>
+/// Fixed-capacity buffer which releases events in Event Window Tag order.
+///
+/// Events are stored as handles (e.g. std::unique_ptr&lt;artdaq::Fragment&gt; or a pointer) in a ring of capacity
+/// slots indexed by EWT, covering the EWTs [next, next + capacity), where next is the EWT of the next event to
+/// release. Pop releases the event at next once it has arrived. A missing EWT is skipped once later events have been
+/// waiting for it for maxLatency, or when Pop is called with force. Events which arrive after their EWT was released
+/// or skipped are flagged as late and handed back to the caller instead of being reordered. When the buffer is empty,
+/// an event beyond the window moves the window up to it, and the EWTs in between are counted as skipped.
+///
+/// Insert and Pop are O(1) (skipping a gap costs one step per skipped EWT), and the slot storage is allocated once.
+/// Not thread-safe.
+/// </summary>
+/// <typeparam name="Handle">Default-constructible, movable type stored for each event</typeparam>
+template <typename Handle>
+class DTC_EventReorderBuffer
+{
+public:
+	/// Clock used for the latency limit
+	using Clock = std::chrono::steady_clock;
+
+	/// <summary>
+	/// Construct a DTC_EventReorderBuffer
+	/// </summary>
+	/// <param name="capacity">Number of EWTs in the window, rounded up to a power of two</param>
+	/// <param name="maxLatency">How long buffered events wait for a missing earlier EWT before it is skipped</param>
+	DTC_EventReorderBuffer(size_t capacity, std::chrono::microseconds maxLatency)
+		: maxLatency_(maxLatency)
+	{
+		size_t size = 1;
+		while (size < capacity) size <<= 1;
+		slots_.resize(size);
+		mask_ = size - 1;
+	}
+
+	/// <summary>
+	/// Buffer an event. The handle is moved from only if the event is accepted.
+	/// </summary>
+	/// <param name="tag">EWT of the event</param>
+	/// <param name="handle">Handle of the event</param>
+	/// <param name="now">Arrival time (Default: now)</param>
+	/// <returns>DTC_ReorderStatus of the insert</returns>
+	DTC_ReorderStatus Insert(DTC_EventWindowTag const& tag, Handle& handle, Clock::time_point now = Clock::now())
+	{
+		auto ewt = tag.GetEventWindowTag(true);
+		if (!started_)
+		{
+			next_ = ewt;
+			started_ = true;
+		}
+		if (ewt < next_)
+		{
+			++counters_.late;
+			return DTC_ReorderStatus_Late;
+		}
+		if (ewt - next_ > mask_ && count_ == 0)
+		{
+			// Nothing is buffered, so move the window up to this event instead of waiting for EWTs which may never come
+			counters_.skipped += ewt - next_;
+			next_ = ewt;
+			waiting_ = false;
+		}
+		if (ewt - next_ > mask_)
+		{
+			++counters_.full;
+			return DTC_ReorderStatus_Full;
+		}
+
+		auto& slot = slots_[ewt & mask_];
+		if (slot.full)
+		{
+			++counters_.duplicates;
+			return DTC_ReorderStatus_Duplicate;
+		}
+		slot.handle = std::move(handle);
+		slot.full = true;
+		++count_;
+		if (ewt != next_ && !waiting_)
+		{
+			// The event at next is missing, start the latency clock
+			waiting_ = true;
+			waitStart_ = now;
+		}
+		return DTC_ReorderStatus_Accepted;
+	}
+
+	/// <summary>
+	/// Release the next event in EWT order, if it is available
+	/// </summary>
+	/// <param name="handle">Receives the handle of the released event</param>
+	/// <param name="tag">Receives the EWT of the released event</param>
+	/// <param name="now">Current time, for the latency limit (Default: now)</param>
+	/// <param name="force">Skip missing EWTs regardless of the latency limit (Default: false)</param>
+	/// <returns>True if an event was released</returns>
+	bool Pop(Handle& handle, DTC_EventWindowTag& tag, Clock::time_point now = Clock::now(), bool force = false)
+	{
+		while (count_ > 0)
+		{
+			auto& slot = slots_[next_ & mask_];
+			if (slot.full)
+			{
+				handle = std::move(slot.handle);
+				slot.handle = Handle();
+				slot.full = false;
+				tag = DTC_EventWindowTag(next_);
+				++next_;
+				--count_;
+				++counters_.released;
+				// Restart the latency clock if later events are still buffered behind a gap
+				waiting_ = count_ > 0 && !slots_[next_ & mask_].full;
+				waitStart_ = now;
+				return true;
+			}
+
+			if (!waiting_)
+			{
+				waiting_ = true;
+				waitStart_ = now;
+			}
+			if (!force && now - waitStart_ < maxLatency_) return false;
+			++next_;
+			++counters_.skipped;
+		}
+		return false;
+	}
+
+	/// <summary>
+	/// Discard all buffered events and start over, e.g. at a run boundary where the EWT restarts. The window starts at
+	/// the EWT of the next Insert. Discarded events are counted as skipped (Pop with force first to release them
+	/// instead); the other counters are kept.
+	/// </summary>
+	void Reset()
+	{
+		for (auto& slot : slots_)
+		{
+			if (slot.full)
+			{
+				slot.handle = Handle();
+				slot.full = false;
+				++counters_.skipped;
+			}
+		}
+		count_ = 0;
+		started_ = false;
+		waiting_ = false;
+	}
+
+	/// <summary>
+	/// EWT of the next event to release
+	/// </summary>
+	/// <returns>EWT at the start of the window</returns>
+	DTC_EventWindowTag GetNextEventWindowTag() const { return DTC_EventWindowTag(next_); }
+	/// <summary>
+	/// Number of buffered events
+	/// </summary>
+	/// <returns>Event count</returns>
+	size_t size() const { return count_; }
+	/// <summary>
+	/// Number of EWTs in the window
+	/// </summary>
+	/// <returns>Slot count</returns>
+	size_t capacity() const { return slots_.size(); }
+	/// <summary>
+	/// Get the counters of the buffer
+	/// </summary>
+	/// <returns>Reference to the DTC_ReorderCounters</returns>
+	DTC_ReorderCounters const& GetCounters() const { return counters_; }
+
+private:
+	struct Slot
+	{
+		Handle handle{};
+		bool full{false};
+	};
+
+	std::vector<Slot> slots_;
+	uint64_t mask_{0};
+	uint64_t next_{0};
+	size_t count_{0};
+	bool started_{false};
+	bool waiting_{false};
+	Clock::time_point waitStart_{};
+	std::chrono::microseconds maxLatency_;
+	DTC_ReorderCounters counters_;
+};
+
+}  // namespace DTCLib
+
+#endif  // artdaq_core_mu2e_Overlays_DTC_Packets_DTC_EventReorderBuffer_h
@@ -0,0 +1,345 @@
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_EventReplayer.h"
+
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_EventHeader.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_SubEventHeader.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Types/Exceptions.h"
+
+#include "TRACE/tracemf.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const uint64_t EVENT_WINDOW_TAG_MASK = 0x0000FFFFFFFFFFFF;
+const size_t DATA_HEADER_TAG_OFFSET = 6;  // Byte offset of the DTC_EventWindowTag in a DTC_DataHeaderPacket
+const auto SPIN_MARGIN = std::chrono::microseconds(100);
+
+template <typename Header>
+uint64_t ShiftTag(Header& header, uint64_t delta)
+{
+	uint64_t tag = (static_cast<uint64_t>(header.event_tag_high) << 32) + header.event_tag_low;
+	tag = (tag + delta) & EVENT_WINDOW_TAG_MASK;
+	header.event_tag_low = tag & 0xFFFFFFFF;
+	header.event_tag_high = tag >> 32;
+	return tag;
+}
+
+}  // namespace
+
+DTCLib::DTC_EventReplayer::DTC_EventReplayer(std::string const& fileName, Options const& options)
+	: options_(options), fileName_(fileName)
+{
+	int fd = open(fileName_.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		TLOG(TLVL_ERROR) << "Unable to open " << fileName_ << ": " << strerror(errno);
+		throw DTC_IOErrorException("Unable to open " + fileName_ + ": " + strerror(errno));
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		auto err = errno;
+		close(fd);
+		TLOG(TLVL_ERROR) << "Unable to stat " << fileName_ << ": " << strerror(err);
+		throw DTC_IOErrorException("Unable to stat " + fileName_ + ": " + strerror(err));
+	}
+	mapSize_ = st.st_size;
+	if (mapSize_ > 0)
+	{
+		int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+		if (options_.populate) flags |= MAP_POPULATE;
+#endif
+		auto ptr = mmap(nullptr, mapSize_, PROT_READ, flags, fd, 0);
+		if (ptr == MAP_FAILED)
+		{
+			auto err = errno;
+			close(fd);
+			TLOG(TLVL_ERROR) << "Unable to map " << fileName_ << ": " << strerror(err);
+			throw DTC_IOErrorException("Unable to map " + fileName_ + ": " + strerror(err));
+		}
+		map_ = static_cast<const uint8_t*>(ptr);
+		madvise(ptr, mapSize_, MADV_SEQUENTIAL);
+	}
+	close(fd);
+
+	try
+	{
+		Index();
+	}
+	catch (...)
+	{
+		if (map_ != nullptr) munmap(const_cast<uint8_t*>(map_), mapSize_);
+		throw;
+	}
+	TLOG(TLVL_DEBUG) << "Indexed " << index_.size() << " events in " << fileName_ << " (" << mapSize_ << " bytes), tag span " << tagSpan_;
+}
+
+DTCLib::DTC_EventReplayer::~DTC_EventReplayer()
+{
+	if (map_ != nullptr) munmap(const_cast<uint8_t*>(map_), mapSize_);
+}
+
+size_t DTCLib::DTC_EventReplayer::SizeWordsBytes() const
+{
+	return sizeof(uint64_t) + (options_.includeDMAWriteSize ? sizeof(uint64_t) : 0);
+}
+
+size_t DTCLib::DTC_EventReplayer::BufferSize(const uint8_t* buffer) const
+{
+	uint64_t dmaSize;
+	memcpy(&dmaSize, buffer + SizeWordsBytes() - sizeof(uint64_t), sizeof(uint64_t));
+	if (dmaSize < sizeof(uint64_t)) return 0;
+	if (options_.includeDMAWriteSize)
+	{
+		uint64_t dmaWriteSize;
+		memcpy(&dmaWriteSize, buffer, sizeof(uint64_t));
+		if (dmaWriteSize != dmaSize + sizeof(uint64_t)) return 0;
+	}
+	return dmaSize - sizeof(uint64_t) + SizeWordsBytes();
+}
+
+void DTCLib::DTC_EventReplayer::Index()
+{
+	auto size_words_bytes = SizeWordsBytes();
+	uint64_t min_tag = EVENT_WINDOW_TAG_MASK;
+	uint64_t max_tag = 0;
+
+	// Size of the DMA buffer at pos, or 0 if the file ends before it does
+	auto buffer_at = [&](size_t pos) -> size_t {
+		if (mapSize_ - pos < size_words_bytes) return 0;
+		auto size = BufferSize(map_ + pos);
+		if (size == 0)
+		{
+			TLOG(TLVL_ERROR) << "Invalid DMA size words at offset " << pos << " of " << fileName_;
+			throw DTC_DataCorruptionException();
+		}
+		return size <= mapSize_ - pos ? size : 0;
+	};
+
+	size_t pos = 0;
+	while (pos < mapSize_)
+	{
+		auto start = pos;
+		auto buffer_size = buffer_at(pos);
+		if (buffer_size == 0 || buffer_size < size_words_bytes + sizeof(DTC_EventHeader)) break;
+
+		DTC_EventHeader header;
+		memcpy(&header, map_ + pos + size_words_bytes, sizeof(header));
+		size_t data_size = buffer_size - size_words_bytes;
+		pos += buffer_size;
+		while (data_size < header.inclusive_event_byte_count && (buffer_size = buffer_at(pos)) != 0)
+		{
+			data_size += buffer_size - size_words_bytes;
+			pos += buffer_size;
+		}
+		if (data_size < header.inclusive_event_byte_count) break;
+		if (data_size != header.inclusive_event_byte_count)
+		{
+			TLOG(TLVL_ERROR) << "DMA buffers of the event at offset " << start << " of " << fileName_ << " hold " << data_size
+							 << " bytes, but its header says " << header.inclusive_event_byte_count;
+			throw DTC_DataCorruptionException();
+		}
+
+		uint64_t tag = (static_cast<uint64_t>(header.event_tag_high) << 32) + header.event_tag_low;
+		min_tag = std::min(min_tag, tag);
+		max_tag = std::max(max_tag, tag);
+		index_.push_back(IndexEntry{start, pos - start, tag});
+	}
+	if (pos < mapSize_)
+	{
+		TLOG(TLVL_WARNING) << "Ignoring truncated event at offset " << pos << " of " << fileName_;
+	}
+	tagSpan_ = index_.empty() ? 0 : max_tag - min_tag + 1;
+}
+
+bool DTCLib::DTC_EventReplayer::Next(Chunk& chunk)
+{
+	if (!started_)
+	{
+		started_ = true;
+		startTime_ = std::chrono::steady_clock::now();
+	}
+
+	if (eventData_ == nullptr)
+	{
+		if (index_.empty() || (options_.loops != 0 && loop_ >= options_.loops)) return false;
+
+		auto& entry = index_[event_];
+		eventData_ = map_ + entry.offset;
+		eventTag_ = entry.tag;
+		eventOffset_ = 0;
+		if (options_.rewriteEventWindowTags && loop_ > 0)
+		{
+			uint64_t delta = loop_ * tagSpan_;
+			rewriteBuffer_.assign(eventData_, eventData_ + entry.size);
+			RewriteTags(rewriteBuffer_.data(), entry.size, delta);
+			eventData_ = rewriteBuffer_.data();
+			eventTag_ = (eventTag_ + delta) & EVENT_WINDOW_TAG_MASK;
+		}
+
+		std::chrono::steady_clock::time_point when;
+		if (Schedule(entry.size, when)) WaitUntil(when);
+	}
+
+	auto& entry = index_[event_];
+	chunk.data = eventData_ + eventOffset_;
+	chunk.size = BufferSize(chunk.data);
+	chunk.eventIndex = event_;
+	chunk.loop = loop_;
+	chunk.eventWindowTag = DTC_EventWindowTag(eventTag_);
+	chunk.firstOfEvent = eventOffset_ == 0;
+	eventOffset_ += chunk.size;
+	chunk.lastOfEvent = eventOffset_ >= entry.size;
+
+	++stats_.chunks;
+	stats_.bytes += chunk.size;
+	if (chunk.lastOfEvent)
+	{
+		eventData_ = nullptr;
+		++stats_.events;
+		if (++event_ == index_.size())
+		{
+			event_ = 0;
+			++loop_;
+			++stats_.loops;
+		}
+	}
+	return true;
+}
+
+size_t DTCLib::DTC_EventReplayer::Run(std::function<bool(Chunk const&)> const& callback)
+{
+	size_t events = 0;
+	Chunk chunk;
+	while (Next(chunk))
+	{
+		if (!callback(chunk)) break;
+		if (chunk.lastOfEvent) ++events;
+	}
+	return events;
+}
+
+void DTCLib::DTC_EventReplayer::Rewind()
+{
+	event_ = 0;
+	loop_ = 0;
+	eventData_ = nullptr;
+	eventOffset_ = 0;
+	started_ = false;
+	scheduledEvents_ = 0;
+	scheduledBytes_ = 0;
+}
+
+DTCLib::DTC_EventReplayer::Stats DTCLib::DTC_EventReplayer::GetStats() const
+{
+	auto stats = stats_;
+	if (started_) stats.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count();
+	if (stats.pacedEvents > 0)
+	{
+		stats.jitterMeanMicroseconds = jitterSum_ / stats.pacedEvents;
+		stats.jitterRmsMicroseconds = std::sqrt(jitterSumSquares_ / stats.pacedEvents);
+	}
+	return stats;
+}
+
+bool DTCLib::DTC_EventReplayer::Schedule(size_t eventBytes, std::chrono::steady_clock::time_point& when)
+{
+	if (options_.eventsPerSecond <= 0 && options_.bytesPerSecond <= 0) return false;
+
+	// Time at which the schedule allows this event, counting only the on phase of the spill cycle
+	double beam_time = 0;
+	if (options_.eventsPerSecond > 0) beam_time = scheduledEvents_ / options_.eventsPerSecond;
+	if (options_.bytesPerSecond > 0) beam_time = std::max(beam_time, scheduledBytes_ / options_.bytesPerSecond);
+	++scheduledEvents_;
+	scheduledBytes_ += eventBytes;
+
+	double wall_time = beam_time;
+	if (options_.spillOnSeconds > 0 && options_.spillOffSeconds > 0)
+	{
+		double spills = std::floor(beam_time / options_.spillOnSeconds);
+		wall_time = spills * (options_.spillOnSeconds + options_.spillOffSeconds) + (beam_time - spills * options_.spillOnSeconds);
+	}
+	when = startTime_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(wall_time));
+	return true;
+}
+
+void DTCLib::DTC_EventReplayer::WaitUntil(std::chrono::steady_clock::time_point when)
+{
+	auto now = std::chrono::steady_clock::now();
+	if (when - now > SPIN_MARGIN)
+	{
+		std::this_thread::sleep_until(when - SPIN_MARGIN);
+	}
+	while ((now = std::chrono::steady_clock::now()) < when)
+	{
+	}
+
+	double lateness = std::chrono::duration<double, std::micro>(now - when).count();
+	++stats_.pacedEvents;
+	jitterSum_ += lateness;
+	jitterSumSquares_ += lateness * lateness;
+	stats_.jitterMaxMicroseconds = std::max(stats_.jitterMaxMicroseconds, lateness);
+}
+
+void DTCLib::DTC_EventReplayer::RewriteTags(uint8_t* event, size_t size, uint64_t delta) const
+{
+	// Sub-event headers and DataBlocks never straddle DMA buffers (see DTC_Event::WriteEvent)
+	auto size_words_bytes = SizeWordsBytes();
+	size_t pos = 0;
+	size_t subevent_remaining = 0;
+	bool first_buffer = true;
+	while (pos < size)
+	{
+		auto buffer_end = pos + BufferSize(event + pos);
+		pos += size_words_bytes;
+		if (first_buffer)
+		{
+			DTC_EventHeader header;
+			memcpy(&header, event + pos, sizeof(header));
+			ShiftTag(header, delta);
+			memcpy(event + pos, &header, sizeof(header));
+			pos += sizeof(header);
+			first_buffer = false;
+		}
+
+		while (pos < buffer_end)
+		{
+			if (subevent_remaining == 0)
+			{
+				if (buffer_end - pos < sizeof(DTC_SubEventHeader)) break;
+				DTC_SubEventHeader header;
+				memcpy(&header, event + pos, sizeof(header));
+				ShiftTag(header, delta);
+				memcpy(event + pos, &header, sizeof(header));
+				subevent_remaining = header.inclusive_subevent_byte_count > sizeof(header) ? header.inclusive_subevent_byte_count - sizeof(header) : 0;
+				pos += sizeof(header);
+				continue;
+			}
+
+			size_t block_size = event[pos] + (event[pos + 1] << 8);
+			if (block_size < 16 || block_size > buffer_end - pos || block_size > subevent_remaining)
+			{
+				TLOG(TLVL_WARNING) << "Inconsistent DataBlock size " << block_size << " in " << fileName_ << ", DataBlock tags of this DMA buffer not rewritten";
+				subevent_remaining = 0;
+				break;
+			}
+			uint64_t tag = 0;
+			for (size_t ii = 0; ii < 6; ++ii) tag |= static_cast<uint64_t>(event[pos + DATA_HEADER_TAG_OFFSET + ii]) << (8 * ii);
+			tag = (tag + delta) & EVENT_WINDOW_TAG_MASK;
+			for (size_t ii = 0; ii < 6; ++ii) event[pos + DATA_HEADER_TAG_OFFSET + ii] = (tag >> (8 * ii)) & 0xFF;
+			pos += block_size;
+			subevent_remaining -= block_size;
+		}
+		pos = buffer_end;
+	}
+}
@@ -0,0 +1,185 @@
+#ifndef artdaq_core_mu2e_Overlays_DTC_Packets_DTC_EventReplayer_h
+#define artdaq_core_mu2e_Overlays_DTC_Packets_DTC_EventReplayer_h
+
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_EventWindowTag.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace DTCLib {
+
+/// <summary>
+/// Replays a DMA-framed DTC event file (as written by DTC_Event::WriteEvent or DTC_AsyncEventWriter) at a controlled
+/// rate, for load testing event builders.
+///
+/// The file is memory-mapped and indexed once; events are then handed out one DMA buffer (size words included) at a
+/// time, either pulled with Next or pushed to a callback with Run. Chunks point into the mapping, so nothing is copied
+/// unless DTC_EventWindowTags are rewritten.
+///
+/// Pacing follows a schedule computed from the target event rate and/or byte rate (the slower one wins), optionally
+/// gated by an on/off spill cycle: the schedule only advances during the on phase. The first chunk of each event is
+/// released when its scheduled time is reached, by sleeping and then spinning for the last few microseconds; the
+/// lateness of each release is kept as jitter statistics.
+///
+/// When the file is replayed more than once, rewriteEventWindowTags shifts the tags of each pass by the tag span of the
+/// file, so that tags keep increasing. The tags of the event header, the sub-event headers and the DataBlock headers are
+/// rewritten in a copy of the event.
+/// </summary>
+class DTC_EventReplayer
+{
+public:
+	/// <summary>
+	/// Options of a DTC_EventReplayer
+	/// </summary>
+	struct Options
+	{
+		bool includeDMAWriteSize{true};     ///< Whether each DMA buffer in the file starts with the DMA Write Size word
+		double eventsPerSecond{0};          ///< Target event rate, 0 for no limit
+		double bytesPerSecond{0};           ///< Target byte rate (size words included), 0 for no limit
+		double spillOnSeconds{0};           ///< Length of the on phase of the spill cycle (needs a target rate), 0 for continuous replay
+		double spillOffSeconds{0};          ///< Length of the off phase of the spill cycle
+		size_t loops{1};                    ///< Number of passes over the file, 0 to replay until stopped
+		bool rewriteEventWindowTags{true};  ///< Shift the DTC_EventWindowTags of each pass after the first
+		bool populate{false};               ///< Read the whole file into the page cache when it is mapped
+	};
+
+	/// <summary>
+	/// One DMA buffer of an event
+	/// </summary>
+	struct Chunk
+	{
+		const uint8_t* data;                ///< Start of the DMA buffer, at its first size word
+		size_t size;                        ///< Size of the DMA buffer, size words included
+		size_t eventIndex;                  ///< Index of the event in the file
+		size_t loop;                        ///< Pass over the file, starting at 0
+		DTC_EventWindowTag eventWindowTag;  ///< Tag of the event, after rewriting
+		bool firstOfEvent;                  ///< Whether this is the first DMA buffer of the event
+		bool lastOfEvent;                   ///< Whether this is the last DMA buffer of the event
+	};
+
+	/// <summary>
+	/// Replay and pacing statistics
+	/// </summary>
+	struct Stats
+	{
+		uint64_t events{0};           ///< Events emitted
+		uint64_t chunks{0};           ///< DMA buffers emitted
+		uint64_t bytes{0};            ///< Bytes emitted, size words included
+		uint64_t loops{0};            ///< Completed passes over the file
+		double elapsedSeconds{0};     ///< Time since the first chunk was requested
+		uint64_t pacedEvents{0};      ///< Events released on a schedule (jitter samples)
+		double jitterMeanMicroseconds{0};  ///< Mean lateness of paced events
+		double jitterRmsMicroseconds{0};   ///< RMS lateness of paced events
+		double jitterMaxMicroseconds{0};   ///< Largest lateness of a paced event
+
+		/// <summary>
+		/// Achieved event rate
+		/// </summary>
+		/// <returns>Events per second of elapsed time</returns>
+		double EventRate() const { return elapsedSeconds > 0 ? events / elapsedSeconds : 0; }
+		/// <summary>
+		/// Achieved byte rate
+		/// </summary>
+		/// <returns>Bytes per second of elapsed time</returns>
+		double Throughput() const { return elapsedSeconds > 0 ? bytes / elapsedSeconds : 0; }
+	};
+
+	/// <summary>
+	/// Map and index a DMA-framed event file. Throws DTC_IOErrorException if the file cannot be mapped, and
+	/// DTC_DataCorruptionException if its framing is inconsistent. A truncated last event is ignored.
+	/// </summary>
+	/// <param name="fileName">File to replay</param>
+	/// <param name="options">Options to use</param>
+	DTC_EventReplayer(std::string const& fileName, Options const& options);
+	/// <summary>
+	/// Map and index a DMA-framed event file, with default Options (one unpaced pass)
+	/// </summary>
+	/// <param name="fileName">File to replay</param>
+	explicit DTC_EventReplayer(std::string const& fileName)
+		: DTC_EventReplayer(fileName, Options()) {}
+	~DTC_EventReplayer();
+
+	DTC_EventReplayer(DTC_EventReplayer const&) = delete;
+	DTC_EventReplayer& operator=(DTC_EventReplayer const&) = delete;
+
+	/// <summary>
+	/// Get the next DMA buffer, waiting for its scheduled time if it starts an event. The chunk is valid until the next
+	/// call to Next (and until the replayer is destroyed).
+	/// </summary>
+	/// <param name="chunk">Receives the DMA buffer</param>
+	/// <returns>False when all passes are done</returns>
+	bool Next(Chunk& chunk);
+	/// <summary>
+	/// Emit DMA buffers to a callback until all passes are done or the callback returns false
+	/// </summary>
+	/// <param name="callback">Called with each DMA buffer; the chunk is only valid during the call</param>
+	/// <returns>Number of complete events emitted</returns>
+	size_t Run(std::function<bool(Chunk const&)> const& callback);
+	/// <summary>
+	/// Start again from the first event of the first pass, with a new schedule. Stats are kept.
+	/// </summary>
+	void Rewind();
+
+	/// <summary>
+	/// Number of complete events in the file
+	/// </summary>
+	/// <returns>Event count</returns>
+	size_t GetEventCount() const { return index_.size(); }
+	/// <summary>
+	/// Shift applied to the DTC_EventWindowTags of each pass when rewriting
+	/// </summary>
+	/// <returns>Largest tag minus smallest tag in the file, plus one</returns>
+	uint64_t GetEventWindowTagSpan() const { return tagSpan_; }
+	/// <summary>
+	/// Get the replay statistics
+	/// </summary>
+	/// <returns>Current Stats</returns>
+	Stats GetStats() const;
+
+private:
+	struct IndexEntry
+	{
+		size_t offset;    // Start of the first DMA buffer of the event
+		size_t size;      // Size of all DMA buffers of the event, size words included
+		uint64_t tag;     // DTC_EventWindowTag of the event header
+	};
+
+	size_t SizeWordsBytes() const;
+	size_t BufferSize(const uint8_t* buffer) const;
+	void Index();
+	bool Schedule(size_t eventBytes, std::chrono::steady_clock::time_point& when);
+	void WaitUntil(std::chrono::steady_clock::time_point when);
+	void RewriteTags(uint8_t* event, size_t size, uint64_t delta) const;
+
+	Options options_;
+	std::string fileName_;
+	const uint8_t* map_{nullptr};
+	size_t mapSize_{0};
+	std::vector<IndexEntry> index_;
+	uint64_t tagSpan_{0};
+
+	// Position of the next chunk
+	size_t event_{0};
+	size_t loop_{0};
+	const uint8_t* eventData_{nullptr};  // Event being emitted: in the mapping, or in rewriteBuffer_
+	size_t eventOffset_{0};              // Offset of the next DMA buffer in the event
+	uint64_t eventTag_{0};
+	std::vector<uint8_t> rewriteBuffer_;
+
+	// Schedule
+	bool started_{false};
+	std::chrono::steady_clock::time_point startTime_;
+	uint64_t scheduledEvents_{0};
+	uint64_t scheduledBytes_{0};
+
+	Stats stats_;
+	double jitterSum_{0};
+	double jitterSumSquares_{0};
+};
+
+}  // namespace DTCLib
+
+#endif  // artdaq_core_mu2e_Overlays_DTC_Packets_DTC_EventReplayer_h
@@ -0,0 +1,234 @@
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_HeaderDeltaCodec.h"
+
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_BitExtract.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Types/Exceptions.h"
+
+#include "TRACE/tracemf.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+enum EncodingMode : uint8_t
+{
+	Mode_Raw = 0,
+	Mode_Delta = 1,
+};
+
+struct SubEventLayout
+{
+	size_t offset;
+	std::vector<size_t> blockOffsets;
+};
+
+// Follow the sub-event and data block byte counts of an event. Returns false if they do not add up to the event.
+bool WalkEvent(const uint8_t* event, std::vector<SubEventLayout>& layout)
+{
+	DTCLib::DTC_EventHeader header;
+	memcpy(&header, event, sizeof(header));
+	size_t size = header.inclusive_event_byte_count;
+	if (size < sizeof(header)) return false;
+
+	size_t pos = sizeof(header);
+	while (pos < size)
+	{
+		DTCLib::DTC_SubEventHeader subHeader;
+		if (size - pos < sizeof(subHeader)) return false;
+		memcpy(&subHeader, event + pos, sizeof(subHeader));
+		size_t subSize = subHeader.inclusive_subevent_byte_count;
+		if (subSize < sizeof(subHeader) || subSize > size - pos) return false;
+
+		layout.push_back(SubEventLayout{pos, {}});
+		size_t subEnd = pos + subSize;
+		size_t blockPos = pos + sizeof(subHeader);
+		while (blockPos < subEnd)
+		{
+			if (subEnd - blockPos < DTCLib::DTC_HeaderDeltaCodec::DATA_HEADER_SIZE) return false;
+			size_t blockSize = DTCLib::LoadLE<uint16_t>(event + blockPos);
+			if (blockSize < DTCLib::DTC_HeaderDeltaCodec::DATA_HEADER_SIZE || blockSize > subEnd - blockPos) return false;
+			layout.back().blockOffsets.push_back(blockPos);
+			blockPos += blockSize;
+		}
+		pos = subEnd;
+	}
+	return true;
+}
+
+void PutVarint(size_t value, std::vector<uint8_t>& output)
+{
+	while (value >= 0x80)
+	{
+		output.push_back(static_cast<uint8_t>(value) | 0x80);
+		value >>= 7;
+	}
+	output.push_back(static_cast<uint8_t>(value));
+}
+
+bool GetVarint(const uint8_t*& in, const uint8_t* end, size_t& value)
+{
+	value = 0;
+	for (size_t shift = 0; in < end && shift < 64; shift += 7)
+	{
+		auto byte = *in++;
+		value |= static_cast<size_t>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) return true;
+	}
+	return false;
+}
+
+// Mask of the bytes of current which differ from reference, then those bytes
+void PutDelta(const uint8_t* reference, const uint8_t* current, size_t size, std::vector<uint8_t>& output)
+{
+	auto maskPos = output.size();
+	output.resize(maskPos + (size + 7) / 8, 0);
+	for (size_t ii = 0; ii < size; ++ii)
+	{
+		if (current[ii] != reference[ii])
+		{
+			output[maskPos + ii / 8] |= 1 << (ii % 8);
+			output.push_back(current[ii]);
+		}
+	}
+}
+
+bool GetDelta(const uint8_t* reference, size_t size, const uint8_t*& in, const uint8_t* end, uint8_t* current)
+{
+	size_t maskSize = (size + 7) / 8;
+	if (static_cast<size_t>(end - in) < maskSize) return false;
+	auto mask = in;
+	in += maskSize;
+	for (size_t ii = 0; ii < size; ++ii)
+	{
+		if (mask[ii / 8] & (1 << (ii % 8)))
+		{
+			if (in == end) return false;
+			current[ii] = *in++;
+		}
+		else
+		{
+			current[ii] = reference[ii];
+		}
+	}
+	return true;
+}
+
+[[noreturn]] void ThrowTruncated(size_t encodedSize)
+{
+	TLOG(TLVL_ERROR) << "Encoded DTC_Event of " << encodedSize << " bytes is truncated or corrupt";
+	throw DTCLib::DTC_DataCorruptionException();
+}
+
+const uint8_t ZERO_HEADER[sizeof(DTCLib::DTC_SubEventHeader)] = {};
+
+}  // namespace
+
+DTCLib::DTC_HeaderDeltaCodec::DTC_HeaderDeltaCodec(const void* templateEvent)
+{
+	auto event = static_cast<const uint8_t*>(templateEvent);
+	memcpy(&eventHeader_, event, sizeof(eventHeader_));
+
+	// A template whose byte counts do not add up still provides the headers found before the inconsistency
+	std::vector<SubEventLayout> layout;
+	if (!WalkEvent(event, layout))
+	{
+		TLOG(TLVL_DEBUG + 5) << "Template DTC_Event is inconsistent, using the first " << layout.size() << " sub events";
+	}
+	for (auto& subEvent : layout)
+	{
+		SubEventTemplate subTemplate;
+		memcpy(&subTemplate.header, event + subEvent.offset, sizeof(subTemplate.header));
+		for (auto blockOffset : subEvent.blockOffsets)
+		{
+			DataHeaderBytes block;
+			memcpy(block.data(), event + blockOffset, DATA_HEADER_SIZE);
+			subTemplate.blocks.push_back(block);
+		}
+		subEvents_.push_back(subTemplate);
+	}
+}
+
+size_t DTCLib::DTC_HeaderDeltaCodec::EncodeEvent(const void* eventPtr, std::vector<uint8_t>& output) const
+{
+	auto event = static_cast<const uint8_t*>(eventPtr);
+	auto start = output.size();
+
+	std::vector<SubEventLayout> layout;
+	if (!WalkEvent(event, layout))
+	{
+		DTC_EventHeader header;
+		memcpy(&header, event, sizeof(header));
+		size_t size = std::max(sizeof(header), static_cast<size_t>(header.inclusive_event_byte_count));
+		TLOG(TLVL_DEBUG + 5) << "DTC_Event byte counts do not add up, storing " << size << " bytes unchanged";
+		output.push_back(Mode_Raw);
+		output.insert(output.end(), event, event + size);
+		return output.size() - start;
+	}
+
+	output.push_back(Mode_Delta);
+	PutDelta(reinterpret_cast<const uint8_t*>(&eventHeader_), event, sizeof(DTC_EventHeader), output);
+	PutVarint(layout.size(), output);
+	for (size_t ii = 0; ii < layout.size(); ++ii)
+	{
+		auto subTemplate = ii < subEvents_.size() ? &subEvents_[ii] : nullptr;
+		auto reference = subTemplate ? reinterpret_cast<const uint8_t*>(&subTemplate->header) : ZERO_HEADER;
+		PutDelta(reference, event + layout[ii].offset, sizeof(DTC_SubEventHeader), output);
+
+		auto& blockOffsets = layout[ii].blockOffsets;
+		PutVarint(blockOffsets.size(), output);
+		for (size_t jj = 0; jj < blockOffsets.size(); ++jj)
+		{
+			auto block = event + blockOffsets[jj];
+			auto blockReference = subTemplate && jj < subTemplate->blocks.size() ? subTemplate->blocks[jj].data() : ZERO_HEADER;
+			PutDelta(blockReference, block, DATA_HEADER_SIZE, output);
+			size_t blockSize = LoadLE<uint16_t>(block);
+			output.insert(output.end(), block + DATA_HEADER_SIZE, block + blockSize);
+		}
+	}
+	return output.size() - start;
+}
+
+size_t DTCLib::DTC_HeaderDeltaCodec::DecodeEvent(const void* encoded, size_t encodedSize, std::vector<uint8_t>& output) const
+{
+	auto in = static_cast<const uint8_t*>(encoded);
+	auto end = in + encodedSize;
+	auto start = output.size();
+	if (in == end) ThrowTruncated(encodedSize);
+
+	if (*in++ == Mode_Raw)
+	{
+		output.insert(output.end(), in, end);
+		return output.size() - start;
+	}
+
+	output.resize(start + sizeof(DTC_EventHeader));
+	if (!GetDelta(reinterpret_cast<const uint8_t*>(&eventHeader_), sizeof(DTC_EventHeader), in, end, output.data() + start)) ThrowTruncated(encodedSize);
+
+	size_t subEventCount;
+	if (!GetVarint(in, end, subEventCount)) ThrowTruncated(encodedSize);
+	for (size_t ii = 0; ii < subEventCount; ++ii)
+	{
+		auto subTemplate = ii < subEvents_.size() ? &subEvents_[ii] : nullptr;
+		auto reference = subTemplate ? reinterpret_cast<const uint8_t*>(&subTemplate->header) : ZERO_HEADER;
+		auto pos = output.size();
+		output.resize(pos + sizeof(DTC_SubEventHeader));
+		if (!GetDelta(reference, sizeof(DTC_SubEventHeader), in, end, output.data() + pos)) ThrowTruncated(encodedSize);
+
+		size_t blockCount;
+		if (!GetVarint(in, end, blockCount)) ThrowTruncated(encodedSize);
+		for (size_t jj = 0; jj < blockCount; ++jj)
+		{
+			auto blockReference = subTemplate && jj < subTemplate->blocks.size() ? subTemplate->blocks[jj].data() : ZERO_HEADER;
+			pos = output.size();
+			output.resize(pos + DATA_HEADER_SIZE);
+			if (!GetDelta(blockReference, DATA_HEADER_SIZE, in, end, output.data() + pos)) ThrowTruncated(encodedSize);
+
+			size_t blockSize = LoadLE<uint16_t>(output.data() + pos);
+			size_t payload = blockSize > DATA_HEADER_SIZE ? blockSize - DATA_HEADER_SIZE : 0;
+			if (static_cast<size_t>(end - in) < payload) ThrowTruncated(encodedSize);
+			output.insert(output.end(), in, in + payload);
+			in += payload;
+		}
+	}
+	return output.size() - start;
+}
@@ -0,0 +1,70 @@
+#ifndef artdaq_core_mu2e_Overlays_DTC_Packets_DTC_HeaderDeltaCodec_h
+#define artdaq_core_mu2e_Overlays_DTC_Packets_DTC_HeaderDeltaCodec_h
+
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_EventHeader.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_SubEventHeader.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DTCLib {
+
+/// <summary>
+/// Lossless compression of the headers of a DTC_Event relative to a template event.
+///
+/// From one event to the next of a stream, the DTC_EventHeader, the DTC_SubEventHeaders and the DTC_DataHeaderPackets of
+/// the ROC data blocks mostly repeat; only the event window tag, byte and packet counts, and DRP latencies change. Each
+/// header is encoded as a bit mask of the bytes which differ from the header at the same position in the template
+/// (sub-event i, data block j), followed by those bytes. Data block payloads are copied unchanged. Headers with no
+/// counterpart in the template are compared to zeros.
+///
+/// Decoding reproduces the original event byte for byte, so the result can be passed to DTC_Event::SetupEvent. Events
+/// whose sub-event or data block byte counts do not add up are stored unchanged.
+/// </summary>
+class DTC_HeaderDeltaCodec
+{
+public:
+	/// Size of a DTC_DataHeaderPacket, in bytes
+	static const size_t DATA_HEADER_SIZE = 16;
+
+	/// <summary>
+	/// Construct a DTC_HeaderDeltaCodec, copying the headers of the template event
+	/// </summary>
+	/// <param name="templateEvent">Pointer to the DTC_EventHeader of the template event</param>
+	explicit DTC_HeaderDeltaCodec(const void* templateEvent);
+
+	/// <summary>
+	/// Encode one DTC_Event
+	/// </summary>
+	/// <param name="event">Pointer to the DTC_EventHeader</param>
+	/// <param name="output">Vector to append the encoded event to</param>
+	/// <returns>Number of bytes appended</returns>
+	size_t EncodeEvent(const void* event, std::vector<uint8_t>& output) const;
+	/// <summary>
+	/// Decode one DTC_Event encoded with the same template. Throws DTC_DataCorruptionException if the encoded event is
+	/// truncated.
+	/// </summary>
+	/// <param name="encoded">Pointer to the encoded event</param>
+	/// <param name="encodedSize">Size of the encoded event, in bytes</param>
+	/// <param name="output">Vector to append the original event to</param>
+	/// <returns>Number of bytes appended</returns>
+	size_t DecodeEvent(const void* encoded, size_t encodedSize, std::vector<uint8_t>& output) const;
+
+private:
+	typedef std::array<uint8_t, DATA_HEADER_SIZE> DataHeaderBytes;
+
+	struct SubEventTemplate
+	{
+		DTC_SubEventHeader header;
+		std::vector<DataHeaderBytes> blocks;
+	};
+
+	DTC_EventHeader eventHeader_;
+	std::vector<SubEventTemplate> subEvents_;
+};
+
+}  // namespace DTCLib
+
+#endif  // artdaq_core_mu2e_Overlays_DTC_Packets_DTC_HeaderDeltaCodec_h
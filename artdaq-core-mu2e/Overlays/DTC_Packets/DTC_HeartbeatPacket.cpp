@@ -4,8 +4,6 @@
 
 #include "TRACE/tracemf.h"
 
-#include <sstream>
-
 DTCLib::DTC_HeartbeatPacket::DTC_HeartbeatPacket(DTC_Link_ID link)
 	: DTC_DMAPacket(DTC_PacketType_Heartbeat, link), event_tag_(), eventMode_(), deliveryRingTDC_()
 {
@@ -39,34 +37,28 @@ DTCLib::DTC_HeartbeatPacket::DTC_HeartbeatPacket(const DTC_DataPacket in)
 	event_tag_ = DTC_EventWindowTag(arr, 4);
 }
 
-std::string DTCLib::DTC_HeartbeatPacket::toJSON()
+void DTCLib::DTC_HeartbeatPacket::AppendJSON(DTC_TextBuffer& buf) const
 {
-	std::stringstream ss;
-	ss << "\"ReadoutRequestPacket\": {";
-	ss << headerJSON() << ",";
-	ss << event_tag_.toJSON() << ",";
-	ss << "\"request\": [" << std::hex << "0x" << static_cast<int>(eventMode_.mode0) << ",";
-	ss << std::hex << "0x" << static_cast<int>(eventMode_.mode1) << ",";
-	ss << std::hex << "0x" << static_cast<int>(eventMode_.mode2) << ",";
-	ss << std::hex << "0x" << static_cast<int>(eventMode_.mode3) << ",";
-	ss << std::hex << "0x" << static_cast<int>(eventMode_.mode4) << "],";
-	ss << "\"deliveryRingTDC\": " << std::hex << " 0x" << static_cast<int>(deliveryRingTDC_) << "";
-	ss << "}";
-	return ss.str();
+	buf.Append("\"ReadoutRequestPacket\": {");
+	AppendHeaderJSON(buf);
+	buf.Append(',');
+	event_tag_.AppendJSON(buf);
+	buf.Append(",\"request\": [0x").Hex(eventMode_.mode0);
+	buf.Append(",0x").Hex(eventMode_.mode1);
+	buf.Append(",0x").Hex(eventMode_.mode2);
+	buf.Append(",0x").Hex(eventMode_.mode3);
+	buf.Append(",0x").Hex(eventMode_.mode4).Append("],");
+	buf.Append("\"deliveryRingTDC\":  0x").Hex(deliveryRingTDC_);
+	buf.Append('}');
 }
 
-std::string DTCLib::DTC_HeartbeatPacket::toPacketFormat()
+void DTCLib::DTC_HeartbeatPacket::AppendPacketFormat(DTC_TextBuffer& buf) const
 {
-	std::stringstream ss;
-	ss << headerPacketFormat() << std::setfill('0') << std::hex;
-	ss << event_tag_.toPacketFormat();
-	ss << "0x" << std::setw(6) << static_cast<int>(eventMode_.mode1) << "\t0x" << std::setw(6)
-		<< static_cast<int>(eventMode_.mode0) << "\n";
-	ss << "0x" << std::setw(6) << static_cast<int>(eventMode_.mode3) << "\t0x" << std::setw(6)
-		<< static_cast<int>(eventMode_.mode2) << "\n";
-	ss << "0x" << std::setw(6) << static_cast<int>(deliveryRingTDC_) << "\t0x" << std::setw(6)
-		<< static_cast<int>(eventMode_.mode4) << "\n";
-	return ss.str();
+	AppendHeaderPacketFormat(buf);
+	event_tag_.AppendPacketFormat(buf);
+	buf.Append("0x").Hex(eventMode_.mode1, 6).Append("\t0x").Hex(eventMode_.mode0, 6).Append('\n');
+	buf.Append("0x").Hex(eventMode_.mode3, 6).Append("\t0x").Hex(eventMode_.mode2, 6).Append('\n');
+	buf.Append("0x").Hex(deliveryRingTDC_, 6).Append("\t0x").Hex(eventMode_.mode4, 6).Append('\n');
 }
 
 DTCLib::DTC_DataPacket DTCLib::DTC_HeartbeatPacket::ConvertToDataPacket() const
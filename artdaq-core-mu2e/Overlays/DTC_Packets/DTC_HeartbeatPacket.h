@@ -71,15 +71,15 @@ public:
 	/// <returns>DTC_DataPacket with DTC_HeartbeatPacket contents set</returns>
 	DTC_DataPacket ConvertToDataPacket() const override;
 	/// <summary>
-	/// Convert the DTC_HeartbeatPacket to JSON representation
+	/// Append the JSON representation of the DTC_HeartbeatPacket to the given buffer
 	/// </summary>
-	/// <returns>JSON-formatted string representation of DTC_HeartbeatPacket</returns>
-	std::string toJSON() override;
+	/// <param name="buf">Buffer to append to</param>
+	void AppendJSON(DTC_TextBuffer& buf) const override;
 	/// <summary>
-	/// Converts the DTC_HeartbeatPacket to "packet format" representation (See DTC_DataPacket::toPacketFormat())
+	/// Append the "packet format" representation of the DTC_HeartbeatPacket to the given buffer (See DTC_DataPacket::toPacketFormat())
 	/// </summary>
-	/// <returns>"packet format" string representation of DTC_HeartbeatPacket</returns>
-	std::string toPacketFormat() override;
+	/// <param name="buf">Buffer to append to</param>
+	void AppendPacketFormat(DTC_TextBuffer& buf) const override;
 
 private:
 	DTC_EventWindowTag event_tag_;
@@ -0,0 +1,93 @@
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_PacketStreamSynthesizer.h"
+
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_DataRequestPacket.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_HeartbeatPacket.h"
+
+#include "TRACE/tracemf.h"
+
+#include <cstring>
+
+DTCLib::DTC_PacketStreamSynthesizer::DTC_PacketStreamSynthesizer(std::vector<DTC_Link_ID> const& links, uint8_t deliveryRingTDC,
+																 bool debug, uint16_t debugPacketCount, DTC_DebugType type)
+	: links_(links)
+{
+	for (auto& link : links_)
+	{
+		PacketTemplate hb;
+		auto hbPacket = DTC_HeartbeatPacket(link, DTC_EventWindowTag(), DTC_EventMode(), deliveryRingTDC).ConvertToDataPacket();
+		memcpy(hb.data(), hbPacket.GetData(), PACKET_SIZE);
+		heartbeatTemplates_.push_back(hb);
+
+		PacketTemplate dr;
+		auto drPacket = DTC_DataRequestPacket(link, DTC_EventWindowTag(), debug, debugPacketCount, type).ConvertToDataPacket();
+		memcpy(dr.data(), drPacket.GetData(), PACKET_SIZE);
+		dataRequestTemplates_.push_back(dr);
+	}
+}
+
+size_t DTCLib::DTC_PacketStreamSynthesizer::FillHeartbeats(uint8_t* buffer, size_t bufferSize, DTC_EventWindowTag firstTag, size_t count, DTC_EventMode const& mode) const
+{
+	return Fill(buffer, bufferSize, firstTag, count, heartbeatTemplates_, &mode, 1);
+}
+
+size_t DTCLib::DTC_PacketStreamSynthesizer::FillHeartbeats(uint8_t* buffer, size_t bufferSize, DTC_EventWindowTag firstTag, size_t count, std::vector<DTC_EventMode> const& modes) const
+{
+	if (modes.empty())
+	{
+		return FillHeartbeats(buffer, bufferSize, firstTag, count);
+	}
+	return Fill(buffer, bufferSize, firstTag, count, heartbeatTemplates_, modes.data(), modes.size());
+}
+
+size_t DTCLib::DTC_PacketStreamSynthesizer::FillDataRequests(uint8_t* buffer, size_t bufferSize, DTC_EventWindowTag firstTag, size_t count) const
+{
+	return Fill(buffer, bufferSize, firstTag, count, dataRequestTemplates_, nullptr, 0);
+}
+
+size_t DTCLib::DTC_PacketStreamSynthesizer::WindowsThatFit(size_t bufferSize, size_t count) const
+{
+	if (BytesPerEventWindow() == 0) return 0;
+	auto fit = bufferSize / BytesPerEventWindow();
+	if (fit < count)
+	{
+		TLOG(TLVL_WARNING) << "Buffer of " << bufferSize << " bytes only has room for " << fit << " of " << count << " event windows";
+		return fit;
+	}
+	return count;
+}
+
+size_t DTCLib::DTC_PacketStreamSynthesizer::Fill(uint8_t* buffer, size_t bufferSize, DTC_EventWindowTag firstTag, size_t count, std::vector<PacketTemplate> const& templates,
+												 DTC_EventMode const* modes, size_t modeCount) const
+{
+	count = WindowsThatFit(bufferSize, count);
+
+	auto tag = firstTag.GetEventWindowTag(true);
+	auto ptr = buffer;
+	size_t modeIndex = 0;
+	for (size_t ii = 0; ii < count; ++ii)
+	{
+		// EWT and mode bytes are the same on every link, so encode them once per event window
+		uint8_t tagBytes[6];
+		for (int jj = 0; jj < 6; ++jj)
+		{
+			tagBytes[jj] = static_cast<uint8_t>(tag >> (jj * 8));
+		}
+		uint8_t modeBytes[5];
+		if (modeCount > 0)
+		{
+			modes[modeIndex].GetEventMode(modeBytes);
+			if (++modeIndex == modeCount) modeIndex = 0;
+		}
+
+		for (auto& packet : templates)
+		{
+			memcpy(ptr, packet.data(), PACKET_SIZE);
+			memcpy(ptr + 4, tagBytes, sizeof(tagBytes));
+			if (modeCount > 0) memcpy(ptr + 10, modeBytes, sizeof(modeBytes));
+			ptr += PACKET_SIZE;
+		}
+
+		tag = (tag + 1) & 0x0000FFFFFFFFFFFF;
+	}
+	return count;
+}
@@ -0,0 +1,106 @@
+#ifndef artdaq_core_mu2e_Overlays_DTC_Packets_DTC_PacketStreamSynthesizer_h
+#define artdaq_core_mu2e_Overlays_DTC_Packets_DTC_PacketStreamSynthesizer_h
+
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_DebugType.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_EventMode.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_EventWindowTag.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_Link_ID.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace DTCLib {
+
+/// <summary>
+/// Fills buffers with long runs of DTC_HeartbeatPackets or DTC_DataRequestPackets for consecutive event windows,
+/// for use as CFO/DTC emulator input.
+///
+/// One packet per link is converted with ConvertToDataPacket when the synthesizer is constructed. Each packet written
+/// afterwards is a copy of that template with only the DTC_EventWindowTag and DTC_EventMode bytes patched, so the output
+/// is byte-identical to converting each packet individually.
+/// </summary>
+class DTC_PacketStreamSynthesizer
+{
+public:
+	/// Size of one synthesized packet, in bytes
+	static const size_t PACKET_SIZE = 16;
+
+	/// <summary>
+	/// Construct a DTC_PacketStreamSynthesizer
+	/// </summary>
+	/// <param name="links">Links to generate packets for, in output order (Default: all ROC links)</param>
+	/// <param name="deliveryRingTDC">TDC value from Delivery Ring placed in every Heartbeat (Default: 0)</param>
+	/// <param name="debug">Debug Mode flag placed in every Data Request (Default: true)</param>
+	/// <param name="debugPacketCount">Debug Packet Count placed in every Data Request (Default: 0)</param>
+	/// <param name="type">Debug Type placed in every Data Request (Default: DTC_DebugType_SpecialSequence)</param>
+	explicit DTC_PacketStreamSynthesizer(std::vector<DTC_Link_ID> const& links = DTC_ROC_Links, uint8_t deliveryRingTDC = 0,
+										 bool debug = true, uint16_t debugPacketCount = 0, DTC_DebugType type = DTC_DebugType_SpecialSequence);
+
+	/// <summary>
+	/// Write Heartbeats for count consecutive event windows, one per link for each window, all with the same mode
+	/// </summary>
+	/// <param name="buffer">Destination buffer</param>
+	/// <param name="bufferSize">Size of the destination buffer, in bytes</param>
+	/// <param name="firstTag">DTC_EventWindowTag of the first event window</param>
+	/// <param name="count">Number of event windows to generate</param>
+	/// <param name="mode">DTC_EventMode placed in every Heartbeat</param>
+	/// <returns>Number of event windows written. Only complete windows are written; fewer than count are written if the buffer is too small</returns>
+	size_t FillHeartbeats(uint8_t* buffer, size_t bufferSize, DTC_EventWindowTag firstTag, size_t count, DTC_EventMode const& mode = DTC_EventMode()) const;
+
+	/// <summary>
+	/// Write Heartbeats for count consecutive event windows, one per link for each window. Event window i uses
+	/// modes[i % modes.size()], so a short list of modes is repeated over the run.
+	/// </summary>
+	/// <param name="buffer">Destination buffer</param>
+	/// <param name="bufferSize">Size of the destination buffer, in bytes</param>
+	/// <param name="firstTag">DTC_EventWindowTag of the first event window</param>
+	/// <param name="count">Number of event windows to generate</param>
+	/// <param name="modes">DTC_EventModes to cycle through. If empty, the default DTC_EventMode is used</param>
+	/// <returns>Number of event windows written. Only complete windows are written; fewer than count are written if the buffer is too small</returns>
+	size_t FillHeartbeats(uint8_t* buffer, size_t bufferSize, DTC_EventWindowTag firstTag, size_t count, std::vector<DTC_EventMode> const& modes) const;
+
+	/// <summary>
+	/// Write Data Requests for count consecutive event windows, one per link for each window
+	/// </summary>
+	/// <param name="buffer">Destination buffer</param>
+	/// <param name="bufferSize">Size of the destination buffer, in bytes</param>
+	/// <param name="firstTag">DTC_EventWindowTag of the first event window</param>
+	/// <param name="count">Number of event windows to generate</param>
+	/// <returns>Number of event windows written. Only complete windows are written; fewer than count are written if the buffer is too small</returns>
+	size_t FillDataRequests(uint8_t* buffer, size_t bufferSize, DTC_EventWindowTag firstTag, size_t count) const;
+
+	/// <summary>
+	/// Number of bytes written for each event window
+	/// </summary>
+	/// <returns>Packet size times number of links</returns>
+	size_t BytesPerEventWindow() const { return PACKET_SIZE * heartbeatTemplates_.size(); }
+
+	/// <summary>
+	/// Number of bytes needed to hold count event windows
+	/// </summary>
+	/// <param name="count">Number of event windows</param>
+	/// <returns>Required buffer size, in bytes</returns>
+	size_t BytesRequired(size_t count) const { return count * BytesPerEventWindow(); }
+
+	/// <summary>
+	/// Get the links packets are generated for
+	/// </summary>
+	/// <returns>Links, in output order</returns>
+	std::vector<DTC_Link_ID> const& GetLinks() const { return links_; }
+
+private:
+	typedef std::array<uint8_t, PACKET_SIZE> PacketTemplate;
+
+	size_t WindowsThatFit(size_t bufferSize, size_t count) const;
+	size_t Fill(uint8_t* buffer, size_t bufferSize, DTC_EventWindowTag firstTag, size_t count, std::vector<PacketTemplate> const& templates,
+				DTC_EventMode const* modes, size_t modeCount) const;
+
+	std::vector<DTC_Link_ID> links_;
+	std::vector<PacketTemplate> heartbeatTemplates_;
+	std::vector<PacketTemplate> dataRequestTemplates_;
+};
+
+}  // namespace DTCLib
+
+#endif  // artdaq_core_mu2e_Overlays_DTC_Packets_DTC_PacketStreamSynthesizer_h
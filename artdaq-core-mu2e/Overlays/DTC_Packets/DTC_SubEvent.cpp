@@ -1,9 +1,23 @@
 #include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_SubEvent.h"
 
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_BitExtract.h"
 #include "artdaq-core-mu2e/Overlays/DTC_Types/Exceptions.h"
 
 #include "TRACE/tracemf.h"
 
+namespace {
+// Hex dump of the 32-bit words in [ptr, ptr + bytes), for the debug printouts. Only called inside TLOG statements, so
+// it costs nothing unless the level is enabled.
+std::string WordDump(const uint8_t* ptr, size_t bytes)
+{
+	std::stringstream ss;
+	ss << std::hex << std::setfill('0');
+	for (size_t i = 0; i + 4 <= bytes; i += 4)
+		ss << std::setw(8) << DTCLib::LoadLE<uint32_t>(ptr + i) << ' ';
+	return ss.str();
+}
+}  // namespace
+
 const uint8_t DTCLib::DTC_SubEvent::REQUIRED_SUBEVENT_FORMAT_VERSION = 1;
 
 DTCLib::DTC_SubEvent::DTC_SubEvent(const void* data)
@@ -19,7 +33,7 @@ DTCLib::DTC_SubEvent::DTC_SubEvent(const void* data)
 		TLOG(TLVL_ERROR) << "Subevent header raw data:";
 		for(size_t i = 0; i < sizeof(header_); i += 4) 
 				TLOG(TLVL_ERROR) << std::dec << "#" << i << "/" << sizeof(header_) << ": 0x" << 
-					std::hex << std::setw(8) << std::setfill('0') << *((uint32_t *)(&(ptr[i]))) << std::endl;
+					std::hex << std::setw(8) << std::setfill('0') << LoadLE<uint32_t>(ptr + i) << std::endl;
 
 		TLOG(TLVL_ERROR) << "A DTC_WrongPacketTypeException occurred while setting up a DTC Subevent in the header format version 0x" <<
 			 std::hex << header_.subevent_format_version << " != 0x" << static_cast<uint16_t>(REQUIRED_SUBEVENT_FORMAT_VERSION) << 
@@ -29,7 +43,7 @@ DTCLib::DTC_SubEvent::DTC_SubEvent(const void* data)
 }
 
 DTCLib::DTC_SubEvent::DTC_SubEvent(size_t data_size)
-	: allocBytes(new std::vector<uint8_t>(data_size)), header_(), data_blocks_(), buffer_ptr_(allocBytes->data())
+	: allocBytes(DTC_BufferSource::GetDefault()->Get(data_size)), header_(), data_blocks_(), buffer_ptr_(allocBytes->data())
 {
 	TLOG(TLVL_TRACE) << "Empty DTC_SubEvent created, copy in data and call SetupSubEvent to finalize, data_size = " << data_size;
 }
@@ -86,15 +100,9 @@ void DTCLib::DTC_SubEvent::SetupSubEvent()
 	}
 
 	//printout SubEvent header
-	{
-		std::stringstream testss;
-		testss << "subevent header Tag=" << GetEventWindowTag().GetEventWindowTag(true) << " (0x" << std::hex << 
-			GetEventWindowTag().GetEventWindowTag(true) << ") bytes=" << std::dec << sizeof(header_) << ": 0x ";
-		for(size_t i = 0; i < sizeof(header_); i+=4)
-			testss << std::hex << std::setw(8) << std::setfill('0') << *((uint32_t *)(&(ptr[i]))) << ' ';
-		TLOG(TLVL_DEBUG + 6) <<	testss.str();
-		TLOG(TLVL_DEBUG + 6) << header_.toJson();
-	}
+	TLOG(TLVL_DEBUG + 6) << "subevent header Tag=" << GetEventWindowTag().GetEventWindowTag(true) << " (0x" << std::hex << 
+		GetEventWindowTag().GetEventWindowTag(true) << ") bytes=" << std::dec << sizeof(header_) << ": 0x " << WordDump(ptr, sizeof(header_));
+	TLOG(TLVL_DEBUG + 6) << header_.toJson();
 	ptr += sizeof(header_); //moving ptr past subevent header
 
 
@@ -120,17 +128,9 @@ void DTCLib::DTC_SubEvent::SetupSubEvent()
 
 			//printout ROC fragment data block
 			if (data_block_byte_count > 16*2) //more than 2 packets 			
-				TLOG(TLVL_DEBUG + 6) << "Beginning "
-									<< std::hex << std::setw(8) << std::setfill('0') 
-									<< *((uint32_t *)(&(ptr[0*4]))) << ' ' << *((uint32_t *)(&(ptr[1*4]))) << ' '
-									<< *((uint32_t *)(&(ptr[2*4]))) << ' ' << *((uint32_t *)(&(ptr[3*4]))) << ' '
-									<< *((uint32_t *)(&(ptr[4*4]))) << ' ' << *((uint32_t *)(&(ptr[5*4]))) << ' '
-									<< *((uint32_t *)(&(ptr[6*4]))) << ' ' << *((uint32_t *)(&(ptr[7*4])));
+				TLOG(TLVL_DEBUG + 6) << "Beginning " << WordDump(ptr, 8*4);
 			else
-				TLOG(TLVL_DEBUG + 6) << "Beginning "
-									<< std::hex << std::setw(8) << std::setfill('0') 
-									<< *((uint32_t *)(&(ptr[0*4]))) << ' ' << *((uint32_t *)(&(ptr[1*4]))) << ' '
-									<< *((uint32_t *)(&(ptr[2*4]))) << ' ' << *((uint32_t *)(&(ptr[3*4])));
+				TLOG(TLVL_DEBUG + 6) << "Beginning " << WordDump(ptr, 4*4);
 
 
 			if (data_block_byte_count > 8*4) 
@@ -139,22 +139,17 @@ void DTCLib::DTC_SubEvent::SetupSubEvent()
 				// for(size_t i = 0; i < data_block_byte_count; i += 4) 
 				// {
 				// 	std::cout << std::dec << "#" << i << "/" << data_block_byte_count << 
-				// 		"(" << i/16 << "/" << data_block_byte_count/16 << ")" << std::hex << std::setw(8) << std::setfill('0') << *((uint32_t *)(&(ptr[i]))) << std::endl;
-				// 	if( i/16 > 0 && ((*((uint32_t *)(&(ptr[i]))) >> 4) & 0x0FFF) != (data_block_byte_count/16 - 1 - i/16))
+				// 		"(" << i/16 << "/" << data_block_byte_count/16 << ")" << std::hex << std::setw(8) << std::setfill('0') << LoadLE<uint32_t>(ptr + i) << std::endl;
+				// 	if( i/16 > 0 && ((LoadLE<uint32_t>(ptr + i) >> 4) & 0x0FFF) != (data_block_byte_count/16 - 1 - i/16))
 				// 	{
 				// 		TLOG(TLVL_ERROR) << "A DTC_WrongPacketTypeException occurred while setting up a ROC payload at packet" <<
 				// 			i/16;
-				// 		throw DTC_WrongPacketTypeException((data_block_byte_count/16 - 1 - i/16),((*((uint32_t *)(&(ptr[i]))) >> 4) & 0x0FFF));
+				// 		throw DTC_WrongPacketTypeException((data_block_byte_count/16 - 1 - i/16),((LoadLE<uint32_t>(ptr + i) >> 4) & 0x0FFF));
 				// 	}
 				// }
 
 				size_t i = data_block_byte_count-8*4;
-				TLOG(TLVL_DEBUG + 6) << "End (starting at data block word #" << i << ") "
-									<< std::hex << std::setw(8) << std::setfill('0') 
-									<< *((uint32_t *)(&(ptr[i+0*4]))) << ' ' << *((uint32_t *)(&(ptr[i+1*4]))) << ' '
-									<< *((uint32_t *)(&(ptr[i+2*4]))) << ' ' << *((uint32_t *)(&(ptr[i+3*4]))) << ' '
-									<< *((uint32_t *)(&(ptr[i+4*4]))) << ' ' << *((uint32_t *)(&(ptr[i+5*4]))) << ' '
-									<< *((uint32_t *)(&(ptr[i+6*4]))) << ' ' << *((uint32_t *)(&(ptr[i+7*4])));
+				TLOG(TLVL_DEBUG + 6) << "End (starting at data block word #" << i << ") " << WordDump(ptr + i, 8*4);
             }
 
 			if(data_blocks_.back().GetHeader()->GetLinkID() != roc_fragi)
@@ -180,8 +175,7 @@ void DTCLib::DTC_SubEvent::SetupSubEvent()
 				std::stringstream testss;
 				testss << "ROC Data Header (w/overrun) for tag=" << GetEventWindowTag().GetEventWindowTag(true) << " (0x" << std::hex << 
 					GetEventWindowTag().GetEventWindowTag(true) << ") bytes=" << std::dec << sizeof(header_) << ": 0x ";
-				for(size_t i = 0; i < sizeof(header_); i+=4)
-					testss << std::hex << std::setw(8) << std::setfill('0') << *((uint32_t *)(&(ptr[i]))) << ' ';
+				testss << WordDump(ptr, sizeof(header_));
 				TLOG(TLVL_ERROR) <<	testss.str();
 				TLOG(TLVL_ERROR) << header_.toJson();
 			}
@@ -193,17 +187,15 @@ void DTCLib::DTC_SubEvent::SetupSubEvent()
 					testss << "ROC header #" << roci++ << 
 						" ROC byte count = " << data_block.GetHeader()->GetByteCount() << ": 0x ";
 					ptr = reinterpret_cast<const uint8_t*>(data_block.GetRawBufferPointer());
-					for(size_t i = 0; i < sizeof(header_); i+=4)
-						testss << std::hex << std::setw(8) << std::setfill('0') << *((uint32_t *)(&(ptr[i]))) << ' ';
+					testss << WordDump(ptr, sizeof(header_));
 					testss << "\n End: ";
-					for(size_t i = 0; i < sizeof(header_)*3; i+=4)
-						testss << std::hex << std::setw(8) << std::setfill('0') << *((uint32_t *)(&(ptr[i + data_block.GetHeader()->GetByteCount() - 128]))) << ' ';
+					testss << WordDump(ptr + data_block.GetHeader()->GetByteCount() - 128, sizeof(header_)*3);
 
 					// testss << "\n All: ";
 					// for(size_t i = 0; i < data_block.GetHeader()->GetByteCount(); i+=4)
 					// {
 					// 	if(i%( 24*4) == 0) testss << "\n" << i << "\t";
-					// 	testss << std::hex << std::setw(8) << std::setfill('0') << *((uint32_t *)(&(ptr[i]))) << ' ';
+					// 	testss << std::hex << std::setw(8) << std::setfill('0') << LoadLE<uint32_t>(ptr + i) << ' ';
 					// }
 					
 					std::cout << testss.str() << "\n" << std::flush;
@@ -221,8 +213,7 @@ void DTCLib::DTC_SubEvent::SetupSubEvent()
 				std::stringstream testss;
 				testss << "subevent header Tag=" << GetEventWindowTag().GetEventWindowTag(true) << " (0x" << std::hex << 
 					GetEventWindowTag().GetEventWindowTag(true) << ") bytes=" << std::dec << sizeof(header_) << ": 0x ";
-				for(size_t i = 0; i < sizeof(header_); i+=4)
-					testss << std::hex << std::setw(8) << std::setfill('0') << *((uint32_t *)(&(ptr[i]))) << ' ';
+				testss << WordDump(ptr, sizeof(header_));
 				TLOG(TLVL_ERROR) <<	testss.str();
 				TLOG(TLVL_ERROR) << header_.toJson();
 			}
@@ -23,6 +23,10 @@ public:
 	/// </summary>
 	/// <param name="ptr">Pointer to data</param>
 	explicit DTC_SubEvent(const void* data);
+	/// <summary>
+	/// Construct a DTC_SubEvent owning an uninitialized buffer from the default DTC_BufferSource. Copy the data in, then call SetupSubEvent.
+	/// </summary>
+	/// <param name="data_size">Size of the buffer, in bytes</param>
 	explicit DTC_SubEvent(size_t data_size);
 
 	DTC_SubEvent()
@@ -74,7 +78,7 @@ public:
 	void UpdateHeader();
 
 private:
-	std::shared_ptr<std::vector<uint8_t>> allocBytes{nullptr};  ///< Used if the block owns its memory
+	std::shared_ptr<DTC_Buffer> allocBytes{nullptr};  ///< Used if the block owns its memory
 	DTC_SubEventHeader header_;
 	std::vector<DTC_DataBlock> data_blocks_;
 	const void* buffer_ptr_;
@@ -1,6 +1,8 @@
 #ifndef artdaq_core_mu2e_Overlays_DTC_Packets_DTC_SubEventHeader_h
 #define artdaq_core_mu2e_Overlays_DTC_Packets_DTC_SubEventHeader_h
 
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_TextBuffer.h"
+
 #include <cstdint>
 #include <iomanip>
 #include <sstream>
@@ -77,35 +79,38 @@ struct DTC_SubEventHeader
 
 	inline std::string toJson() const
 	{
-		std::ostringstream oss;
-
-		oss << "\"DTC_SubEventHeader\": {\n";
-		oss << "\t\"inclusive_subevent_byte_count\": " << inclusive_subevent_byte_count;
-		oss << ",\n\t\"event_tag_low\": " << event_tag_low;
-		oss << ",\n\t\"event_tag_high\": " << event_tag_high;
-		oss << ",\n\t\"num_rocs\": " << num_rocs;
-		oss << ",\n\t\"event_mode\": 0x" << std::hex << event_mode << std::dec;
-		oss << ",\n\t\"dtc_mac\": " << dtc_mac;
-		oss << ",\n\t\"partition_id\": " << partition_id;
-		oss << ",\n\t\"evb_mode\": " << evb_mode;
-		oss << ",\n\t\"source_dtc_id\": " << source_dtc_id;
-		oss << ",\n\t\"link0_status\": " << link0_status;
-		oss << ",\n\t\"link1_status\": " << link1_status;
-		oss << ",\n\t\"link2_status\": " << link2_status;
-		oss << ",\n\t\"link3_status\": " << link3_status;
-		oss << ",\n\t\"link4_status\": " << link4_status;
-		oss << ",\n\t\"link5_status\": " << link5_status;
-		oss << ",\n\t\"subevent_format_version\": " << subevent_format_version;
-		oss << ",\n\t\"emtdc\": " << emtdc;
-		oss << ",\n\t\"link0_drp_rx_latency\": " << link0_drp_rx_latency;
-		oss << ",\n\t\"link1_drp_rx_latency\": " << link1_drp_rx_latency;
-		oss << ",\n\t\"link2_drp_rx_latency\": " << link2_drp_rx_latency;
-		oss << ",\n\t\"link3_drp_rx_latency\": " << link3_drp_rx_latency;
-		oss << ",\n\t\"link4_drp_rx_latency\": " << link4_drp_rx_latency;
-		oss << ",\n\t\"link5_drp_rx_latency\": " << link5_drp_rx_latency;
-		oss << "\n}";
+		DTC_TextBuffer buf;
+		AppendJson(buf);
+		return buf.str();
+	}
 
-		return oss.str();
+	inline void AppendJson(DTC_TextBuffer& buf) const
+	{
+		buf.Append("\"DTC_SubEventHeader\": {\n");
+		buf.Append("\t\"inclusive_subevent_byte_count\": ").Dec(inclusive_subevent_byte_count);
+		buf.Append(",\n\t\"event_tag_low\": ").Dec(event_tag_low);
+		buf.Append(",\n\t\"event_tag_high\": ").Dec(event_tag_high);
+		buf.Append(",\n\t\"num_rocs\": ").Dec(num_rocs);
+		buf.Append(",\n\t\"event_mode\": 0x").Hex(event_mode);
+		buf.Append(",\n\t\"dtc_mac\": ").Dec(dtc_mac);
+		buf.Append(",\n\t\"partition_id\": ").Dec(partition_id);
+		buf.Append(",\n\t\"evb_mode\": ").Dec(evb_mode);
+		buf.Append(",\n\t\"source_dtc_id\": ").Dec(source_dtc_id);
+		buf.Append(",\n\t\"link0_status\": ").Dec(link0_status);
+		buf.Append(",\n\t\"link1_status\": ").Dec(link1_status);
+		buf.Append(",\n\t\"link2_status\": ").Dec(link2_status);
+		buf.Append(",\n\t\"link3_status\": ").Dec(link3_status);
+		buf.Append(",\n\t\"link4_status\": ").Dec(link4_status);
+		buf.Append(",\n\t\"link5_status\": ").Dec(link5_status);
+		buf.Append(",\n\t\"subevent_format_version\": ").Dec(subevent_format_version);
+		buf.Append(",\n\t\"emtdc\": ").Dec(emtdc);
+		buf.Append(",\n\t\"link0_drp_rx_latency\": ").Dec(link0_drp_rx_latency);
+		buf.Append(",\n\t\"link1_drp_rx_latency\": ").Dec(link1_drp_rx_latency);
+		buf.Append(",\n\t\"link2_drp_rx_latency\": ").Dec(link2_drp_rx_latency);
+		buf.Append(",\n\t\"link3_drp_rx_latency\": ").Dec(link3_drp_rx_latency);
+		buf.Append(",\n\t\"link4_drp_rx_latency\": ").Dec(link4_drp_rx_latency);
+		buf.Append(",\n\t\"link5_drp_rx_latency\": ").Dec(link5_drp_rx_latency);
+		buf.Append("\n}");
 	}
 };
 
@@ -0,0 +1,389 @@
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_TrackerBlockCodec.h"
+
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_EventHeader.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_SubEventHeader.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Types/Exceptions.h"
+
+#include "TRACE/tracemf.h"
+
+#include <cstring>
+
+namespace {
+
+const size_t PACKET_SIZE = 16;
+const size_t HIT_HEADER_SIZE = 12;     // Bytes of a TrackerDataPacket before its ADC group
+const size_t PAYLOAD_HEADER_SIZE = 5;  // Original byte count, hit count, flags
+const size_t GROUP_SIZE = 32;          // Residuals per bit-packed group
+const unsigned MAX_WIDTH = 11;         // Zigzag-encoded difference of two 10-bit samples
+const uint8_t FLAG_UNUSED_BITS = 0x1;
+const uint8_t TRACKER_VERSION = 1;
+
+uint16_t ReadU16(const uint8_t* ptr) { return static_cast<uint16_t>(ptr[0] | (ptr[1] << 8)); }
+void WriteU16(uint8_t* ptr, size_t value)
+{
+	ptr[0] = static_cast<uint8_t>(value);
+	ptr[1] = static_cast<uint8_t>(value >> 8);
+}
+uint32_t ReadU32(const uint8_t* ptr)
+{
+	uint32_t value;
+	memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+size_t NumADCPackets(const uint8_t* hit) { return hit[10] & 0x3F; }
+// Packet count field of a DTC_DataHeaderPacket: 11 bits, below the subsystem bits of byte 5
+size_t ReadPacketCount(const uint8_t* header) { return ReadU16(header + 4) & 0x7FF; }
+void WritePacketCount(uint8_t* header, size_t byteCount)
+{
+	auto packetCount = byteCount / PACKET_SIZE - 1;
+	header[4] = static_cast<uint8_t>(packetCount);
+	header[5] = static_cast<uint8_t>((header[5] & 0xF8) | ((packetCount >> 8) & 0x7));
+}
+
+// One kernel per bit width, so that the 32-value loops are fully unrolled with constant shifts and no branches on the
+// width; the compiler is free to vectorize them for whatever instruction set the build targets.
+template<unsigned W>
+void Pack(const uint32_t* in, uint8_t* out)
+{
+	uint32_t words[W] = {};
+	for (unsigned ii = 0; ii < GROUP_SIZE; ++ii)
+	{
+		const unsigned bit = ii * W;
+		words[bit / 32] |= in[ii] << (bit % 32);
+		if (bit % 32 + W > 32) words[bit / 32 + 1] |= in[ii] >> (32 - bit % 32);
+	}
+	memcpy(out, words, sizeof(words));
+}
+
+template<unsigned W>
+void Unpack(const uint8_t* in, uint32_t* out)
+{
+	uint32_t words[W];
+	memcpy(words, in, sizeof(words));
+	for (unsigned ii = 0; ii < GROUP_SIZE; ++ii)
+	{
+		const unsigned bit = ii * W;
+		uint32_t value = words[bit / 32] >> (bit % 32);
+		if (bit % 32 + W > 32) value |= words[bit / 32 + 1] << (32 - bit % 32);
+		out[ii] = value & ((1u << W) - 1);
+	}
+}
+
+// A group of zero residuals (flat waveform) takes no space beyond its width byte
+template<>
+void Pack<0>(const uint32_t*, uint8_t*)
+{
+}
+
+template<>
+void Unpack<0>(const uint8_t*, uint32_t* out)
+{
+	memset(out, 0, GROUP_SIZE * sizeof(uint32_t));
+}
+
+typedef void (*PackFunction)(const uint32_t*, uint8_t*);
+typedef void (*UnpackFunction)(const uint8_t*, uint32_t*);
+
+const PackFunction PACK[MAX_WIDTH + 1] = {Pack<0>, Pack<1>, Pack<2>, Pack<3>, Pack<4>, Pack<5>,
+										  Pack<6>, Pack<7>, Pack<8>, Pack<9>, Pack<10>, Pack<11>};
+const UnpackFunction UNPACK[MAX_WIDTH + 1] = {Unpack<0>, Unpack<1>, Unpack<2>, Unpack<3>, Unpack<4>, Unpack<5>,
+											  Unpack<6>, Unpack<7>, Unpack<8>, Unpack<9>, Unpack<10>, Unpack<11>};
+
+size_t PassThrough(const uint8_t* block, size_t blockSize, std::vector<uint8_t>& output)
+{
+	output.insert(output.end(), block, block + blockSize);
+	return blockSize;
+}
+
+void ThrowCorrupt(const char* what)
+{
+	TLOG(TLVL_ERROR) << "Compressed tracker block is corrupt: " << what;
+	throw DTCLib::DTC_DataCorruptionException();
+}
+
+// Copy the event and sub-event headers, pass every DTC_DataBlock through blockFunction, and patch the byte counts
+template<typename BlockFunction>
+size_t TransformEvent(const void* event, std::vector<uint8_t>& output, BlockFunction blockFunction)
+{
+	auto in = static_cast<const uint8_t*>(event);
+	auto start = output.size();
+
+	DTCLib::DTC_EventHeader eventHeader;
+	memcpy(&eventHeader, in, sizeof(eventHeader));
+	output.insert(output.end(), in, in + sizeof(eventHeader));
+
+	size_t offset = sizeof(eventHeader);
+	while (offset < eventHeader.inclusive_event_byte_count)
+	{
+		DTCLib::DTC_SubEventHeader subEventHeader;
+		memcpy(&subEventHeader, in + offset, sizeof(subEventHeader));
+		size_t subEventSize = subEventHeader.inclusive_subevent_byte_count;
+		if (subEventSize < sizeof(subEventHeader) || offset + subEventSize > eventHeader.inclusive_event_byte_count)
+		{
+			TLOG(TLVL_ERROR) << "Invalid sub event byte count " << subEventSize << " at offset " << offset;
+			throw DTCLib::DTC_WrongPacketSizeException(sizeof(subEventHeader), subEventSize);
+		}
+
+		auto subEventStart = output.size();
+		output.insert(output.end(), in + offset, in + offset + sizeof(subEventHeader));
+		size_t subOffset = sizeof(subEventHeader);
+		while (subOffset < subEventSize)
+		{
+			auto block = in + offset + subOffset;
+			size_t blockSize = ReadU16(block);
+			if (blockSize < PACKET_SIZE || subOffset + blockSize > subEventSize)
+			{
+				TLOG(TLVL_ERROR) << "Invalid data block byte count " << blockSize << " at offset " << offset + subOffset;
+				throw DTCLib::DTC_WrongPacketSizeException(PACKET_SIZE, blockSize);
+			}
+			blockFunction(block, blockSize, output);
+			subOffset += blockSize;
+		}
+
+		subEventHeader.inclusive_subevent_byte_count = output.size() - subEventStart;
+		memcpy(&output[subEventStart], &subEventHeader, sizeof(subEventHeader));
+		offset += subEventSize;
+	}
+
+	eventHeader.inclusive_event_byte_count = output.size() - start;
+	memcpy(&output[start], &eventHeader, sizeof(eventHeader));
+	return output.size() - start;
+}
+
+}  // namespace
+
+size_t DTCLib::DTC_TrackerBlockCodec::EncodeBlock(const void* block, size_t blockSize, std::vector<uint8_t>& output)
+{
+	auto in = static_cast<const uint8_t*>(block);
+	if (blockSize <= PACKET_SIZE || blockSize % PACKET_SIZE != 0 || ReadU16(in) != blockSize || (ReadPacketCount(in) + 1) * PACKET_SIZE != blockSize)
+	{
+		return PassThrough(in, blockSize, output);
+	}
+	if (((in[5] >> 5) & 0x7) != DTC_Subsystem_Tracker || in[13] != TRACKER_VERSION) return PassThrough(in, blockSize, output);
+
+	// The payload must be an exact sequence of hits
+	auto payload = in + PACKET_SIZE;
+	auto payloadSize = blockSize - PACKET_SIZE;
+	size_t hits = 0;
+	size_t groups = 0;
+	for (size_t offset = 0; offset < payloadSize; ++hits)
+	{
+		auto numADC = NumADCPackets(payload + offset);
+		offset += (1 + numADC) * PACKET_SIZE;
+		if (offset > payloadSize) return PassThrough(in, blockSize, output);
+		groups += 1 + 4 * numADC;
+	}
+
+	auto samples = 3 * groups;
+	auto residualGroups = (samples + GROUP_SIZE - 1) / GROUP_SIZE;
+	std::vector<uint32_t> residuals(residualGroups * GROUP_SIZE, 0);
+	std::vector<uint8_t> unusedBits((2 * groups + 7) / 8, 0);
+	bool anyUnusedBits = false;
+
+	size_t sample = 0;
+	size_t group = 0;
+	int32_t previous = 0;
+	auto addGroup = [&](const uint8_t* ptr) {
+		auto word = ReadU32(ptr);
+		for (unsigned kk = 0; kk < 3; ++kk)
+		{
+			auto value = static_cast<int32_t>((word >> (10 * kk)) & 0x3FF);
+			auto diff = value - previous;
+			previous = value;
+			residuals[sample++] = (static_cast<uint32_t>(diff) << 1) ^ static_cast<uint32_t>(diff >> 31);
+		}
+		auto unused = word >> 30;
+		if (unused != 0)
+		{
+			anyUnusedBits = true;
+			unusedBits[group / 4] |= static_cast<uint8_t>(unused << (2 * (group % 4)));
+		}
+		++group;
+	};
+
+	for (size_t offset = 0; offset < payloadSize;)
+	{
+		auto hit = payload + offset;
+		auto numADC = NumADCPackets(hit);
+		addGroup(hit + HIT_HEADER_SIZE);
+		for (size_t ii = 0; ii < 4 * numADC; ++ii)
+		{
+			addGroup(hit + PACKET_SIZE + 4 * ii);
+		}
+		offset += (1 + numADC) * PACKET_SIZE;
+	}
+
+	auto start = output.size();
+	output.resize(start + PACKET_SIZE + PAYLOAD_HEADER_SIZE + hits * HIT_HEADER_SIZE + unusedBits.size() +
+				  residualGroups * (1 + MAX_WIDTH * sizeof(uint32_t)) + PACKET_SIZE);
+	auto out = &output[start];
+
+	memcpy(out, in, PACKET_SIZE);
+	out[13] |= COMPRESSED_VERSION_FLAG;
+	auto pos = PACKET_SIZE;
+	WriteU16(out + pos, blockSize);
+	WriteU16(out + pos + 2, hits);
+	out[pos + 4] = anyUnusedBits ? FLAG_UNUSED_BITS : 0;
+	pos += PAYLOAD_HEADER_SIZE;
+
+	for (size_t offset = 0; offset < payloadSize;)
+	{
+		memcpy(out + pos, payload + offset, HIT_HEADER_SIZE);
+		pos += HIT_HEADER_SIZE;
+		offset += (1 + NumADCPackets(payload + offset)) * PACKET_SIZE;
+	}
+	if (anyUnusedBits)
+	{
+		memcpy(out + pos, unusedBits.data(), unusedBits.size());
+		pos += unusedBits.size();
+	}
+
+	for (size_t gg = 0; gg < residualGroups; ++gg)
+	{
+		auto values = &residuals[gg * GROUP_SIZE];
+		uint32_t all = 0;
+		for (size_t ii = 0; ii < GROUP_SIZE; ++ii) all |= values[ii];
+		unsigned width = 0;
+		while (all >> width) ++width;
+
+		out[pos++] = static_cast<uint8_t>(width);
+		PACK[width](values, out + pos);
+		pos += width * sizeof(uint32_t);
+	}
+
+	auto encodedSize = (pos + PACKET_SIZE - 1) / PACKET_SIZE * PACKET_SIZE;
+	if (encodedSize >= blockSize || hits > 0xFFFF)
+	{
+		output.resize(start);
+		return PassThrough(in, blockSize, output);
+	}
+	memset(out + pos, 0, encodedSize - pos);
+	WriteU16(out, encodedSize);
+	WritePacketCount(out, encodedSize);
+	output.resize(start + encodedSize);
+	return encodedSize;
+}
+
+size_t DTCLib::DTC_TrackerBlockCodec::DecodeBlock(const void* block, size_t blockSize, std::vector<uint8_t>& output)
+{
+	auto in = static_cast<const uint8_t*>(block);
+	if (blockSize < PACKET_SIZE || !IsCompressed(in)) return PassThrough(in, blockSize, output);
+	if (blockSize < PACKET_SIZE + PAYLOAD_HEADER_SIZE) ThrowCorrupt("block too small");
+
+	auto end = in + blockSize;
+	auto ptr = in + PACKET_SIZE;
+	size_t originalSize = ReadU16(ptr);
+	size_t hits = ReadU16(ptr + 2);
+	auto flags = ptr[4];
+	ptr += PAYLOAD_HEADER_SIZE;
+
+	if (static_cast<size_t>(end - ptr) < hits * HIT_HEADER_SIZE) ThrowCorrupt("hit headers truncated");
+	auto hitHeaders = ptr;
+	ptr += hits * HIT_HEADER_SIZE;
+	size_t groups = 0;
+	size_t expectedSize = PACKET_SIZE;
+	for (size_t hh = 0; hh < hits; ++hh)
+	{
+		auto numADC = NumADCPackets(hitHeaders + hh * HIT_HEADER_SIZE);
+		groups += 1 + 4 * numADC;
+		expectedSize += (1 + numADC) * PACKET_SIZE;
+	}
+	if (expectedSize != originalSize) ThrowCorrupt("hit headers do not match the original byte count");
+
+	const uint8_t* unusedBits = nullptr;
+	if (flags & FLAG_UNUSED_BITS)
+	{
+		auto unusedSize = (2 * groups + 7) / 8;
+		if (static_cast<size_t>(end - ptr) < unusedSize) ThrowCorrupt("unused bits truncated");
+		unusedBits = ptr;
+		ptr += unusedSize;
+	}
+
+	auto residualGroups = (3 * groups + GROUP_SIZE - 1) / GROUP_SIZE;
+	std::vector<uint32_t> residuals(residualGroups * GROUP_SIZE);
+	for (size_t gg = 0; gg < residualGroups; ++gg)
+	{
+		if (ptr >= end) ThrowCorrupt("residuals truncated");
+		unsigned width = *ptr++;
+		if (width > MAX_WIDTH || static_cast<size_t>(end - ptr) < width * sizeof(uint32_t)) ThrowCorrupt("invalid residual group");
+		UNPACK[width](ptr, &residuals[gg * GROUP_SIZE]);
+		ptr += width * sizeof(uint32_t);
+	}
+
+	auto start = output.size();
+	output.resize(start + originalSize);
+	auto out = &output[start];
+	memcpy(out, in, PACKET_SIZE);
+	out[13] &= ~COMPRESSED_VERSION_FLAG;
+	WriteU16(out, originalSize);
+	WritePacketCount(out, originalSize);
+
+	size_t sample = 0;
+	size_t group = 0;
+	int32_t previous = 0;
+	auto writeGroup = [&](uint8_t* dest) {
+		uint32_t word = 0;
+		for (unsigned kk = 0; kk < 3; ++kk)
+		{
+			auto residual = residuals[sample++];
+			previous += static_cast<int32_t>(residual >> 1) ^ -static_cast<int32_t>(residual & 1);
+			word |= (static_cast<uint32_t>(previous) & 0x3FF) << (10 * kk);
+		}
+		if (unusedBits != nullptr) word |= static_cast<uint32_t>((unusedBits[group / 4] >> (2 * (group % 4))) & 0x3) << 30;
+		memcpy(dest, &word, sizeof(word));
+		++group;
+	};
+
+	auto dest = out + PACKET_SIZE;
+	for (size_t hh = 0; hh < hits; ++hh)
+	{
+		auto hitHeader = hitHeaders + hh * HIT_HEADER_SIZE;
+		auto numADC = NumADCPackets(hitHeader);
+		memcpy(dest, hitHeader, HIT_HEADER_SIZE);
+		writeGroup(dest + HIT_HEADER_SIZE);
+		for (size_t ii = 0; ii < 4 * numADC; ++ii)
+		{
+			writeGroup(dest + PACKET_SIZE + 4 * ii);
+		}
+		dest += (1 + numADC) * PACKET_SIZE;
+	}
+	return originalSize;
+}
+
+size_t DTCLib::DTC_TrackerBlockCodec::EncodeEvent(const void* event, std::vector<uint8_t>& output)
+{
+	return TransformEvent(event, output, &DTC_TrackerBlockCodec::EncodeBlock);
+}
+
+size_t DTCLib::DTC_TrackerBlockCodec::DecodeEvent(const void* event, std::vector<uint8_t>& output)
+{
+	return TransformEvent(event, output, &DTC_TrackerBlockCodec::DecodeBlock);
+}
+
+bool DTCLib::DTC_TrackerBlockCodec::HasCompressedBlocks(const void* event)
+{
+	auto in = static_cast<const uint8_t*>(event);
+	DTC_EventHeader eventHeader;
+	memcpy(&eventHeader, in, sizeof(eventHeader));
+
+	size_t offset = sizeof(eventHeader);
+	while (offset < eventHeader.inclusive_event_byte_count)
+	{
+		DTC_SubEventHeader subEventHeader;
+		memcpy(&subEventHeader, in + offset, sizeof(subEventHeader));
+		size_t subEventSize = subEventHeader.inclusive_subevent_byte_count;
+		if (subEventSize < sizeof(subEventHeader) || offset + subEventSize > eventHeader.inclusive_event_byte_count) return false;
+
+		size_t subOffset = sizeof(subEventHeader);
+		while (subOffset < subEventSize)
+		{
+			auto block = in + offset + subOffset;
+			size_t blockSize = ReadU16(block);
+			if (blockSize < PACKET_SIZE || subOffset + blockSize > subEventSize) return false;
+			if (IsCompressed(block)) return true;
+			subOffset += blockSize;
+		}
+		offset += subEventSize;
+	}
+	return false;
+}
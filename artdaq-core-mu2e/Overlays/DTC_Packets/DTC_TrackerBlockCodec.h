@@ -0,0 +1,85 @@
+#ifndef artdaq_core_mu2e_Overlays_DTC_Packets_DTC_TrackerBlockCodec_h
+#define artdaq_core_mu2e_Overlays_DTC_Packets_DTC_TrackerBlockCodec_h
+
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_Subsystem.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DTCLib {
+
+/// <summary>
+/// Lossless compression of tracker DTC_DataBlocks.
+///
+/// A tracker hit is a TrackerDataPacket followed by NumADCPackets TrackerADCPackets. Apart from the first 12 bytes of the
+/// TrackerDataPacket, a hit is a sequence of 32-bit groups which each hold three 10-bit ADC samples and 2 unused bits.
+/// The codec keeps the 12 hit header bytes as-is, replaces the samples by zigzag-encoded differences from the previous
+/// sample, and bit-packs the differences in groups of 32 using the smallest width which holds the whole group. The unused
+/// bits are only stored if any of them is set.
+///
+/// A compressed block keeps its DTC_DataHeaderPacket, with COMPRESSED_VERSION_FLAG set in the version byte and the
+/// byte and packet counts replaced by those of the (16-byte aligned) compressed size, so that it is still a valid
+/// DTC_DataHeaderPacket and DTC_SubEvent::SetupSubEvent can walk it. The original counts are restored on decoding.
+/// Decoding reproduces the original block byte for byte. Blocks which are not version 1 tracker data, which cannot be
+/// parsed as a sequence of hits, or which would not get smaller, are passed through unchanged.
+/// </summary>
+class DTC_TrackerBlockCodec
+{
+public:
+	/// Bit set in the DTC_DataHeaderPacket version byte of a compressed block
+	static const uint8_t COMPRESSED_VERSION_FLAG = 0x80;
+
+	/// <summary>
+	/// Whether the block starting at the given address is compressed
+	/// </summary>
+	/// <param name="block">Pointer to the DTC_DataHeaderPacket of the block</param>
+	/// <returns>True if the block is tracker data and COMPRESSED_VERSION_FLAG is set in the version byte</returns>
+	static bool IsCompressed(const void* block)
+	{
+		auto ptr = static_cast<const uint8_t*>(block);
+		return ((ptr[5] >> 5) & 0x7) == DTC_Subsystem_Tracker && (ptr[13] & COMPRESSED_VERSION_FLAG) != 0;
+	}
+
+	/// <summary>
+	/// Compress one DTC_DataBlock, or copy it unchanged if it cannot be compressed
+	/// </summary>
+	/// <param name="block">Pointer to the DTC_DataHeaderPacket of the block</param>
+	/// <param name="blockSize">Size of the block, in bytes</param>
+	/// <param name="output">Vector to append the result to</param>
+	/// <returns>Number of bytes appended</returns>
+	static size_t EncodeBlock(const void* block, size_t blockSize, std::vector<uint8_t>& output);
+	/// <summary>
+	/// Decompress one DTC_DataBlock, or copy it unchanged if it is not compressed
+	/// </summary>
+	/// <param name="block">Pointer to the DTC_DataHeaderPacket of the block</param>
+	/// <param name="blockSize">Size of the block (as stored), in bytes</param>
+	/// <param name="output">Vector to append the original block to</param>
+	/// <returns>Number of bytes appended</returns>
+	static size_t DecodeBlock(const void* block, size_t blockSize, std::vector<uint8_t>& output);
+
+	/// <summary>
+	/// Compress all tracker blocks of a DTC_Event, updating the sub-event and event byte counts
+	/// </summary>
+	/// <param name="event">Pointer to the DTC_EventHeader</param>
+	/// <param name="output">Vector to append the compressed event to</param>
+	/// <returns>Number of bytes appended</returns>
+	static size_t EncodeEvent(const void* event, std::vector<uint8_t>& output);
+	/// <summary>
+	/// Decompress all compressed blocks of a DTC_Event, restoring the sub-event and event byte counts
+	/// </summary>
+	/// <param name="event">Pointer to the DTC_EventHeader</param>
+	/// <param name="output">Vector to append the original event to</param>
+	/// <returns>Number of bytes appended</returns>
+	static size_t DecodeEvent(const void* event, std::vector<uint8_t>& output);
+	/// <summary>
+	/// Whether any block of a DTC_Event is compressed
+	/// </summary>
+	/// <param name="event">Pointer to the DTC_EventHeader</param>
+	/// <returns>True if DecodeEvent needs to be called before the event is used</returns>
+	static bool HasCompressedBlocks(const void* event);
+};
+
+}  // namespace DTCLib
+
+#endif  // artdaq_core_mu2e_Overlays_DTC_Packets_DTC_TrackerBlockCodec_h
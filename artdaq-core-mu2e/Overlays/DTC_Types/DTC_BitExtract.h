@@ -0,0 +1,175 @@
+#ifndef artdaq_core_mu2e_Overlays_DTC_Types_DTC_BitExtract_h
+#define artdaq_core_mu2e_Overlays_DTC_Types_DTC_BitExtract_h
+
+#include "artdaq-core-mu2e/Overlays/DTC_Types/Exceptions.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define DTC_BITEXTRACT_NATIVE_LE 1
+#else
+#define DTC_BITEXTRACT_NATIVE_LE 0
+#endif
+
+namespace DTCLib {
+
+/// <summary>
+/// Alignment-safe access to the little-endian fields of raw DTC data.
+///
+/// Fields are read with memcpy on little-endian hosts, which is valid for any alignment and under strict aliasing and
+/// compiles to single (unaligned) loads, so this costs the same as dereferencing a cast pointer. In constant expressions
+/// and on big-endian hosts, bytes are assembled with shifts instead. Only the bytes covering a field are read, never
+/// past it.
+/// </summary>
+
+/// <summary>
+/// Number of bytes from the start of the data to the end of a bit field
+/// </summary>
+/// <typeparam name="BitOffset">Offset of the least significant bit of the field, from bit 0 of byte 0</typeparam>
+/// <typeparam name="BitCount">Width of the field</typeparam>
+template<size_t BitOffset, size_t BitCount>
+constexpr size_t BitFieldEnd = (BitOffset + BitCount + 7) / 8;
+
+/// <summary>
+/// Load an unsigned integer stored little-endian
+/// </summary>
+/// <typeparam name="T">Unsigned integer type to load</typeparam>
+/// <param name="data">Pointer to the first byte, any alignment</param>
+/// <returns>Loaded value</returns>
+template<typename T>
+constexpr T LoadLE(const uint8_t* data)
+{
+	static_assert(std::is_unsigned_v<T>, "LoadLE loads unsigned integers");
+	T value = 0;
+#if DTC_BITEXTRACT_NATIVE_LE
+	if (!__builtin_is_constant_evaluated())
+	{
+		memcpy(&value, data, sizeof(T));
+		return value;
+	}
+#endif
+	for (size_t ii = 0; ii < sizeof(T); ++ii)
+	{
+		value |= static_cast<T>(static_cast<T>(data[ii]) << (8 * ii));
+	}
+	return value;
+}
+
+/// <summary>
+/// Store an unsigned integer little-endian
+/// </summary>
+/// <typeparam name="T">Unsigned integer type to store</typeparam>
+/// <param name="data">Pointer to the first byte, any alignment</param>
+/// <param name="value">Value to store</param>
+template<typename T>
+constexpr void StoreLE(uint8_t* data, T value)
+{
+	static_assert(std::is_unsigned_v<T>, "StoreLE stores unsigned integers");
+#if DTC_BITEXTRACT_NATIVE_LE
+	if (!__builtin_is_constant_evaluated())
+	{
+		memcpy(data, &value, sizeof(T));
+		return;
+	}
+#endif
+	for (size_t ii = 0; ii < sizeof(T); ++ii)
+	{
+		data[ii] = static_cast<uint8_t>(value >> (8 * ii));
+	}
+}
+
+/// <summary>
+/// Load 1 to 8 bytes stored little-endian, as one load per power-of-two piece
+/// </summary>
+/// <typeparam name="N">Number of bytes to load</typeparam>
+/// <param name="data">Pointer to the first byte, any alignment</param>
+/// <returns>Loaded value, zero-extended</returns>
+template<size_t N>
+constexpr uint64_t LoadBytesLE(const uint8_t* data)
+{
+	static_assert(N >= 1 && N <= 8, "LoadBytesLE loads 1 to 8 bytes");
+	if constexpr (N == 8)
+	{
+		return LoadLE<uint64_t>(data);
+	}
+	else if constexpr (N >= 4)
+	{
+		uint64_t value = LoadLE<uint32_t>(data);
+		if constexpr (N > 4) value |= LoadBytesLE<N - 4>(data + 4) << 32;
+		return value;
+	}
+	else if constexpr (N >= 2)
+	{
+		uint64_t value = LoadLE<uint16_t>(data);
+		if constexpr (N > 2) value |= LoadBytesLE<N - 2>(data + 2) << 16;
+		return value;
+	}
+	else
+	{
+		return data[0];
+	}
+}
+
+/// <summary>
+/// Extract a little-endian bit field of up to 64 bits (57 if not byte-aligned)
+/// </summary>
+/// <typeparam name="BitOffset">Offset of the least significant bit of the field, from bit 0 of byte 0</typeparam>
+/// <typeparam name="BitCount">Width of the field</typeparam>
+/// <param name="data">Pointer to byte 0, any alignment. At least BitFieldEnd bytes must be readable.</param>
+/// <returns>Value of the field</returns>
+template<size_t BitOffset, size_t BitCount>
+constexpr uint64_t ExtractBits(const uint8_t* data)
+{
+	static_assert(BitCount > 0 && BitOffset % 8 + BitCount <= 64, "Bit field must fit in 8 bytes");
+	constexpr size_t firstByte = BitOffset / 8;
+	constexpr size_t byteCount = BitFieldEnd<BitOffset, BitCount> - firstByte;
+
+	uint64_t value = LoadBytesLE<byteCount>(data + firstByte) >> BitOffset % 8;
+	if constexpr (BitCount < 64)
+	{
+		value &= (uint64_t(1) << BitCount) - 1;
+	}
+	return value;
+}
+
+/// <summary>
+/// Extract a little-endian bit field, checking that it lies within the data.
+/// Throws DTC_WrongPacketSizeException if size is smaller than BitFieldEnd.
+/// </summary>
+/// <typeparam name="BitOffset">Offset of the least significant bit of the field, from bit 0 of byte 0</typeparam>
+/// <typeparam name="BitCount">Width of the field</typeparam>
+/// <param name="data">Pointer to byte 0, any alignment</param>
+/// <param name="size">Number of readable bytes at data</param>
+/// <returns>Value of the field</returns>
+template<size_t BitOffset, size_t BitCount>
+constexpr uint64_t ExtractBits(const uint8_t* data, size_t size)
+{
+	if (size < BitFieldEnd<BitOffset, BitCount>)
+	{
+		throw DTC_WrongPacketSizeException(static_cast<int>(BitFieldEnd<BitOffset, BitCount>), static_cast<int>(size));
+	}
+	return ExtractBits<BitOffset, BitCount>(data);
+}
+
+/// <summary>
+/// Copy raw bytes into a bit field overlay struct, instead of dereferencing a cast pointer (which may be misaligned
+/// and violates strict aliasing). The copy compiles to plain loads.
+/// </summary>
+/// <typeparam name="T">Trivially copyable overlay type</typeparam>
+/// <param name="data">Pointer to the first byte, any alignment. At least sizeof(T) bytes must be readable.</param>
+/// <returns>Copy of the overlay</returns>
+template<typename T>
+T LoadAs(const void* data)
+{
+	static_assert(std::is_trivially_copyable_v<T>, "LoadAs copies trivially copyable overlays");
+	T value;
+	memcpy(&value, data, sizeof(T));
+	return value;
+}
+
+}  // namespace DTCLib
+
+#endif  // artdaq_core_mu2e_Overlays_DTC_Types_DTC_BitExtract_h
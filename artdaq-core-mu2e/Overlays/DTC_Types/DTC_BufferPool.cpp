@@ -0,0 +1,230 @@
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_BufferPool.h"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "TRACE/tracemf.h"
+
+namespace {
+
+const size_t MIN_CLASS_BYTES = 4096;
+const size_t NUM_CLASSES = 15;  // 4 KB to 64 MB
+const size_t HUGE_PAGE_BYTES = 2 << 20;
+
+std::shared_ptr<DTCLib::DTC_BufferSource>& DefaultSource()
+{
+	static std::shared_ptr<DTCLib::DTC_BufferSource> source = std::make_shared<DTCLib::DTC_PooledBufferSource>();
+	return source;
+}
+
+size_t SizeClass(size_t size)
+{
+	size_t cls = 0;
+	while (cls < NUM_CLASSES && (MIN_CLASS_BYTES << cls) < size) ++cls;
+	return cls;
+}
+
+std::atomic<uint64_t> next_source_id{0};
+
+// Set when the pools of this thread have been destroyed, so that buffers allocated or released later (e.g. by
+// static objects at exit) bypass them
+thread_local bool thread_pools_destroyed = false;
+
+// Written at the start of storage while it is on a return stack
+struct ReturnedNode
+{
+	ReturnedNode* next;
+	size_t capacity;
+};
+
+}  // namespace
+
+// Pool of one thread in one DTC_PooledBufferSource. The free lists are only used by the owning thread; other threads
+// push storage on the returned stack, which only the owning thread pops (all at once), so there is no ABA problem.
+// cached_bytes counts the storage on both, and is reserved before storage is pushed so that the limit holds at all
+// times. Buffers hold a reference to the pool of their storage, so it lives until the last of them is released.
+struct DTCLib::DTC_PooledBufferSource::ThreadPool
+{
+	std::thread::id owner{std::this_thread::get_id()};
+	std::array<std::vector<uint8_t*>, NUM_CLASSES> free_lists;
+	std::atomic<size_t> cached_bytes{0};
+	std::atomic<ReturnedNode*> returned{nullptr};
+	std::atomic<bool> live{true};  // Cleared when the owning thread exits
+
+	// Count capacity bytes against the limit, unless that would exceed it
+	bool Reserve(size_t capacity, size_t limit)
+	{
+		auto cached = cached_bytes.load(std::memory_order_relaxed);
+		do
+		{
+			if (cached + capacity > limit) return false;
+		} while (!cached_bytes.compare_exchange_weak(cached, cached + capacity, std::memory_order_relaxed));
+		return true;
+	}
+
+	~ThreadPool()
+	{
+		for (auto& list : free_lists)
+		{
+			for (auto ptr : list) free(ptr);
+		}
+		auto node = returned.load(std::memory_order_acquire);
+		while (node != nullptr)
+		{
+			auto next = node->next;
+			free(node);
+			node = next;
+		}
+	}
+};
+
+DTCLib::DTC_Buffer::~DTC_Buffer()
+{
+	source_->Release(data_, capacity_, owner_);
+}
+
+std::shared_ptr<DTCLib::DTC_Buffer> DTCLib::DTC_BufferSource::Get(size_t size)
+{
+	size_t capacity = 0;
+	std::shared_ptr<void> owner;
+	auto data = Acquire(size, capacity, owner);
+	return std::make_shared<DTC_Buffer>(data, size, capacity, shared_from_this(), std::move(owner));
+}
+
+std::shared_ptr<DTCLib::DTC_BufferSource> DTCLib::DTC_BufferSource::GetDefault()
+{
+	return std::atomic_load(&DefaultSource());
+}
+
+void DTCLib::DTC_BufferSource::SetDefault(std::shared_ptr<DTC_BufferSource> source)
+{
+	std::atomic_store(&DefaultSource(), std::move(source));
+}
+
+DTCLib::DTC_PooledBufferSource::DTC_PooledBufferSource(Options const& options)
+	: options_(options), id_(next_source_id.fetch_add(1, std::memory_order_relaxed)) {}
+
+std::shared_ptr<DTCLib::DTC_PooledBufferSource::ThreadPool> const* DTCLib::DTC_PooledBufferSource::LocalPool() const
+{
+	// Pools of the calling thread, one per source it has allocated from
+	struct Registry
+	{
+		std::vector<std::pair<uint64_t, std::shared_ptr<ThreadPool>>> pools;
+
+		~Registry()
+		{
+			thread_pools_destroyed = true;
+			for (auto& entry : pools)
+			{
+				entry.second->live.store(false, std::memory_order_release);
+			}
+		}
+	};
+
+	if (thread_pools_destroyed) return nullptr;
+	thread_local Registry registry;
+	for (auto& entry : registry.pools)
+	{
+		if (entry.first == id_) return &entry.second;
+	}
+	registry.pools.emplace_back(id_, std::make_shared<ThreadPool>());
+	return &registry.pools.back().second;
+}
+
+void DTCLib::DTC_PooledBufferSource::Drain(ThreadPool& pool) const
+{
+	auto node = pool.returned.exchange(nullptr, std::memory_order_acquire);
+	while (node != nullptr)
+	{
+		auto next = node->next;
+		pool.free_lists[SizeClass(node->capacity)].push_back(reinterpret_cast<uint8_t*>(node));
+		node = next;
+	}
+}
+
+uint8_t* DTCLib::DTC_PooledBufferSource::Acquire(size_t size, size_t& capacity, std::shared_ptr<void>& owner)
+{
+	auto cls = SizeClass(size);
+	if (cls >= NUM_CLASSES)
+	{
+		capacity = (size + MIN_CLASS_BYTES - 1) & ~(MIN_CLASS_BYTES - 1);
+		if (options_.hugePages && capacity >= HUGE_PAGE_BYTES) capacity = (capacity + HUGE_PAGE_BYTES - 1) & ~(HUGE_PAGE_BYTES - 1);
+		return Allocate(capacity);
+	}
+
+	capacity = MIN_CLASS_BYTES << cls;
+	auto pool = LocalPool();
+	if (pool == nullptr) return Allocate(capacity);
+	owner = *pool;
+
+	auto& list = (*pool)->free_lists[cls];
+	if (list.empty()) Drain(**pool);
+	if (!list.empty())
+	{
+		auto ptr = list.back();
+		list.pop_back();
+		(*pool)->cached_bytes.fetch_sub(capacity, std::memory_order_relaxed);
+		return ptr;
+	}
+	return Allocate(capacity);
+}
+
+uint8_t* DTCLib::DTC_PooledBufferSource::Allocate(size_t capacity) const
+{
+	bool huge = options_.hugePages && capacity >= HUGE_PAGE_BYTES;
+	auto ptr = static_cast<uint8_t*>(aligned_alloc(huge ? HUGE_PAGE_BYTES : MIN_CLASS_BYTES, capacity));
+	if (ptr == nullptr)
+	{
+		TLOG(TLVL_ERROR) << "Unable to allocate DTC buffer of " << capacity << " bytes";
+		throw std::bad_alloc();
+	}
+#ifdef MADV_HUGEPAGE
+	if (huge && madvise(ptr, capacity, MADV_HUGEPAGE) != 0)
+	{
+		TLOG(TLVL_DEBUG + 5) << "madvise(MADV_HUGEPAGE) failed for DTC buffer of " << capacity << " bytes";
+	}
+#endif
+	if (options_.firstTouch)
+	{
+		static const size_t page_size = sysconf(_SC_PAGESIZE);
+		for (size_t offset = 0; offset < capacity; offset += page_size)
+		{
+			ptr[offset] = 0;
+		}
+	}
+	return ptr;
+}
+
+void DTCLib::DTC_PooledBufferSource::Release(uint8_t* data, size_t capacity, std::shared_ptr<void> const& owner)
+{
+	auto pool = static_cast<ThreadPool*>(owner.get());
+	auto cls = SizeClass(capacity);
+	if (pool == nullptr || cls >= NUM_CLASSES || (MIN_CLASS_BYTES << cls) != capacity || !pool->live.load(std::memory_order_acquire) ||
+		!pool->Reserve(capacity, options_.maxCachedBytesPerThread))
+	{
+		free(data);
+		return;
+	}
+
+	if (pool->owner == std::this_thread::get_id())
+	{
+		pool->free_lists[cls].push_back(data);
+		return;
+	}
+
+	// Hand the storage back to the owning thread, which moves it to its free lists when they run empty
+	auto node = new (data) ReturnedNode{nullptr, capacity};
+	auto head = pool->returned.load(std::memory_order_relaxed);
+	do
+	{
+		node->next = head;
+	} while (!pool->returned.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+}
@@ -0,0 +1,182 @@
+#ifndef artdaq_core_mu2e_Overlays_DTC_Types_DTC_BufferPool_h
+#define artdaq_core_mu2e_Overlays_DTC_Types_DTC_BufferPool_h
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace DTCLib {
+
+class DTC_BufferSource;
+
+/// <summary>
+/// Uninitialized byte buffer owned by a DTC_Event, DTC_SubEvent or DTC_DataBlock. The storage is handed back to
+/// the DTC_BufferSource it came from when the buffer is destroyed.
+/// </summary>
+class DTC_Buffer
+{
+public:
+	/// <summary>
+	/// Construct a DTC_Buffer. Used by DTC_BufferSource::Get.
+	/// </summary>
+	/// <param name="data">Storage of the buffer</param>
+	/// <param name="size">Requested size, in bytes</param>
+	/// <param name="capacity">Size of the storage, in bytes</param>
+	/// <param name="source">Source to return the storage to</param>
+	/// <param name="owner">Token from DTC_BufferSource::Acquire, passed back to Release</param>
+	DTC_Buffer(uint8_t* data, size_t size, size_t capacity, std::shared_ptr<DTC_BufferSource> source, std::shared_ptr<void> owner = nullptr)
+		: data_(data), size_(size), capacity_(capacity), source_(std::move(source)), owner_(std::move(owner)) {}
+	~DTC_Buffer();
+
+	DTC_Buffer(DTC_Buffer const&) = delete;
+	DTC_Buffer& operator=(DTC_Buffer const&) = delete;
+
+	/// <summary>
+	/// Pointer to the storage
+	/// </summary>
+	/// <returns>Pointer to the first byte</returns>
+	uint8_t* data() { return data_; }
+	/// <summary>
+	/// Pointer to the storage
+	/// </summary>
+	/// <returns>Pointer to the first byte</returns>
+	const uint8_t* data() const { return data_; }
+	/// <summary>
+	/// Size of the buffer
+	/// </summary>
+	/// <returns>Requested size, in bytes</returns>
+	size_t size() const { return size_; }
+	/// <summary>
+	/// Iterator to the first byte, for code written against the byte vectors this replaces
+	/// </summary>
+	/// <returns>Pointer to the first byte</returns>
+	uint8_t* begin() { return data_; }
+	/// <summary>
+	/// Iterator to the first byte
+	/// </summary>
+	/// <returns>Pointer to the first byte</returns>
+	const uint8_t* begin() const { return data_; }
+	/// <summary>
+	/// Iterator past the last byte
+	/// </summary>
+	/// <returns>Pointer past the last byte</returns>
+	uint8_t* end() { return data_ + size_; }
+	/// <summary>
+	/// Iterator past the last byte
+	/// </summary>
+	/// <returns>Pointer past the last byte</returns>
+	const uint8_t* end() const { return data_ + size_; }
+
+private:
+	uint8_t* data_;
+	size_t size_;
+	size_t capacity_;
+	std::shared_ptr<DTC_BufferSource> source_;
+	std::shared_ptr<void> owner_;
+};
+
+/// <summary>
+/// Pluggable source of uninitialized storage for the size-constructors of DTC_Event, DTC_SubEvent and DTC_DataBlock.
+/// The default source is a DTC_PooledBufferSource with default options; SetDefault replaces it.
+/// </summary>
+class DTC_BufferSource : public std::enable_shared_from_this<DTC_BufferSource>
+{
+public:
+	virtual ~DTC_BufferSource() = default;
+
+	/// <summary>
+	/// Get an uninitialized buffer of the given size
+	/// </summary>
+	/// <param name="size">Size of the buffer, in bytes</param>
+	/// <returns>Shared pointer to the buffer</returns>
+	std::shared_ptr<DTC_Buffer> Get(size_t size);
+
+	/// <summary>
+	/// Get the source used by the size-constructors
+	/// </summary>
+	/// <returns>The default DTC_BufferSource</returns>
+	static std::shared_ptr<DTC_BufferSource> GetDefault();
+	/// <summary>
+	/// Replace the source used by the size-constructors. Buffers from the previous source stay valid.
+	/// </summary>
+	/// <param name="source">New default source</param>
+	static void SetDefault(std::shared_ptr<DTC_BufferSource> source);
+
+protected:
+	/// <summary>
+	/// Allocate storage for at least size bytes
+	/// </summary>
+	/// <param name="size">Number of bytes needed</param>
+	/// <param name="capacity">Receives the size of the storage, in bytes</param>
+	/// <param name="owner">Receives an optional token identifying where the storage came from, kept alive by the
+	/// DTC_Buffer and passed back to Release</param>
+	/// <returns>Pointer to the storage</returns>
+	virtual uint8_t* Acquire(size_t size, size_t& capacity, std::shared_ptr<void>& owner) = 0;
+	/// <summary>
+	/// Return storage obtained from Acquire. May be called from any thread.
+	/// </summary>
+	/// <param name="data">Pointer to the storage</param>
+	/// <param name="capacity">Capacity returned by Acquire</param>
+	/// <param name="owner">Token returned by Acquire</param>
+	virtual void Release(uint8_t* data, size_t capacity, std::shared_ptr<void> const& owner) = 0;
+
+	friend class DTC_Buffer;
+};
+
+/// <summary>
+/// DTC_BufferSource with per-thread pools of power-of-two size classes (4 KB to 64 MB). Each thread has its own pool
+/// in each source, so sources with different Options never share storage. Released storage goes back to the pool of
+/// the thread which allocated it, up to a per-thread limit, and is reused without going back to malloc: the owning
+/// thread puts it on its free lists directly, other threads (e.g. consumers of events built by a readout thread) push
+/// it on a lock-free return stack which the owner drains when a free list runs empty. Buffers larger than the largest
+/// class, and storage released after its owning thread has exited, are freed directly.
+///
+/// Storage of 2 MB and above can be aligned and advised for transparent huge pages. With firstTouch, newly allocated
+/// storage is touched once per page by the allocating thread, so that under the default local NUMA policy it is placed
+/// on the node of the (pinned) readout thread; since storage returns to the pool it came from, recycled storage stays
+/// on that node.
+/// </summary>
+class DTC_PooledBufferSource : public DTC_BufferSource
+{
+public:
+	/// <summary>
+	/// Options of a DTC_PooledBufferSource
+	/// </summary>
+	struct Options
+	{
+		bool hugePages{false};                       ///< Align storage of 2 MB and above to 2 MB and advise MADV_HUGEPAGE
+		bool firstTouch{false};                      ///< Touch newly allocated storage from the allocating thread
+		size_t maxCachedBytesPerThread{256 << 20};   ///< Maximum storage kept in each thread's pool
+	};
+
+	/// <summary>
+	/// Construct a DTC_PooledBufferSource with default Options
+	/// </summary>
+	DTC_PooledBufferSource()
+		: DTC_PooledBufferSource(Options()) {}
+	/// <summary>
+	/// Construct a DTC_PooledBufferSource
+	/// </summary>
+	/// <param name="options">Options to use</param>
+	explicit DTC_PooledBufferSource(Options const& options);
+
+protected:
+	uint8_t* Acquire(size_t size, size_t& capacity, std::shared_ptr<void>& owner) override;
+	void Release(uint8_t* data, size_t capacity, std::shared_ptr<void> const& owner) override;
+
+private:
+	struct ThreadPool;
+
+	// Pool of the calling thread in this source, created on first use; nullptr once the thread is exiting
+	std::shared_ptr<ThreadPool> const* LocalPool() const;
+	// Move the storage other threads returned to pool onto its free lists
+	void Drain(ThreadPool& pool) const;
+	uint8_t* Allocate(size_t capacity) const;
+
+	Options options_;
+	uint64_t id_;  // Unique for the process lifetime; identifies the pools of this source in each thread
+};
+
+}  // namespace DTCLib
+
+#endif  // artdaq_core_mu2e_Overlays_DTC_Types_DTC_BufferPool_h
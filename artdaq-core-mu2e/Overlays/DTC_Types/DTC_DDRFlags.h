@@ -2,6 +2,7 @@
 #define artdaq_core_mu2e_Overlays_DTC_Types_DTC_DDRFlags_h
 
 #include <ostream>
+#include <type_traits>
 
 namespace DTCLib {
 
@@ -20,7 +21,7 @@ struct DTC_DDRFlags
 	/// <summary>
 	/// Default Constructor, sets all flags to false
 	/// </summary>
-	DTC_DDRFlags()
+	constexpr DTC_DDRFlags()
 		: InputFragmentBufferFull(false)
 		, InputFragmentBufferEmpty(false)
 		, InputFragmentBufferHalfFull(false)
@@ -37,7 +38,7 @@ struct DTC_DDRFlags
 	/// <param name="ofbf">OutputEventBufferFull</param>
 	/// <param name="ofbe">OutputEventBufferEmpty</param>
 	/// <param name="ofbhf">OutputEventBufferHalfFull</param>
-	DTC_DDRFlags(bool ifbf, bool ifbe, bool ifbhf, bool ofbf, bool ofbe, bool ofbhf)
+	constexpr DTC_DDRFlags(bool ifbf, bool ifbe, bool ifbhf, bool ofbf, bool ofbe, bool ofbhf)
 		: InputFragmentBufferFull(ifbf)
 		, InputFragmentBufferEmpty(ifbe)
 		, InputFragmentBufferHalfFull(ifbhf)
@@ -67,6 +68,9 @@ struct DTC_DDRFlags
 	}
 };
 
+static_assert(std::is_trivially_copyable_v<DTC_DDRFlags> && std::is_standard_layout_v<DTC_DDRFlags>,
+			  "DTC_DDRFlags must stay a plain value type");
+
 }  // namespace DTCLib
 
 #endif  // artdaq_core_mu2e_Overlays_DTC_Types_DTC_DDRFlags_h
@@ -3,6 +3,7 @@
 
 #include <bitset>   // std::bitset
 #include <cstdint>  // uint8_t, uint16_t
+#include <type_traits>  // std::is_trivially_copyable_v, std::is_standard_layout_v
 
 namespace DTCLib {
 
@@ -23,15 +24,19 @@ struct DTC_EVBStatus
 		kInvalid
 	};
 
-	DTC_EVBStatus()
+	constexpr DTC_EVBStatus()
 		: error(false), flags(0) {}
-	DTC_EVBStatus(uint8_t word)
-	{
-		error = (word & 0x80) != 0;
-		flags = std::bitset<7>(word);
-	}
+	constexpr DTC_EVBStatus(uint8_t word)
+		: error((word & 0x80) != 0), flags(word) {}
+
+	// std::bitset comparison is not constexpr before C++20
+	friend bool operator==(const DTC_EVBStatus& left, const DTC_EVBStatus& right) { return left.error == right.error && left.flags == right.flags; }
+	friend bool operator!=(const DTC_EVBStatus& left, const DTC_EVBStatus& right) { return !(left == right); }
 };
 
+static_assert(std::is_trivially_copyable_v<DTC_EVBStatus> && std::is_standard_layout_v<DTC_EVBStatus>,
+			  "DTC_EVBStatus must stay a plain value type");
+
 }  // namespace DTCLib
 
 #endif  // artdaq_core_mu2e_Overlays_DTC_Types_DTC_EVBStatus_h
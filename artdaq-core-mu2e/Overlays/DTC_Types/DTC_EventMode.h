@@ -1,10 +1,16 @@
 #ifndef artdaq_core_mu2e_Overlays_DTC_Types_DTC_EventMode_h
 #define artdaq_core_mu2e_Overlays_DTC_Types_DTC_EventMode_h
 
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
 
 namespace DTCLib {
 
+/// <summary>
+/// The five Event Mode bytes of a Heartbeat packet. DTC_EventMode is a trivially copyable, standard-layout aggregate
+/// laid out in packet byte order.
+/// </summary>
 struct DTC_EventMode
 {
 	uint8_t mode0{0};
@@ -22,11 +28,21 @@ struct DTC_EventMode
 		const_cast<uint8_t*>(arr)[start + 4] = mode4;
 	}
 	
-	bool isOnSpillFlagSet() const 			{return mode4 & 1;}
-	bool isSubRunBitSet() const 			{return mode4 & 2;}
-	bool isPredictiveSubRunBitSet() const 	{return mode4 & 4;}
+	constexpr bool isOnSpillFlagSet() const 			{return mode4 & 1;}
+	constexpr bool isSubRunBitSet() const 			{return mode4 & 2;}
+	constexpr bool isPredictiveSubRunBitSet() const 	{return mode4 & 4;}
+
+	constexpr bool operator==(const DTC_EventMode& r) const
+	{
+		return mode0 == r.mode0 && mode1 == r.mode1 && mode2 == r.mode2 && mode3 == r.mode3 && mode4 == r.mode4;
+	}
+	constexpr bool operator!=(const DTC_EventMode& r) const { return !(*this == r); }
 };
 
+static_assert(std::is_trivially_copyable_v<DTC_EventMode> && std::is_standard_layout_v<DTC_EventMode>,
+			  "DTC_EventMode must stay a plain value type");
+static_assert(sizeof(DTC_EventMode) == 5, "DTC_EventMode must match the five Event Mode bytes");
+
 }  // namespace DTCLib
 
 #endif  // artdaq_core_mu2e_Overlays_DTC_Types_DTC_EventMode_h
@@ -1,14 +1,20 @@
 #ifndef artdaq_core_mu2e_Overlays_DTC_Types_DTC_EventWindowTag_h
 #define artdaq_core_mu2e_Overlays_DTC_Types_DTC_EventWindowTag_h
 
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_BitExtract.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_TextBuffer.h"
+
 #include <bitset>
 #include <cstdint>
 #include <string>
+#include <type_traits>
 
 namespace DTCLib {
 
 /// <summary>
 /// The mu2e event_tag is a 48-bit quantity. This class manages all the different ways it could be accessed.
+/// DTC_EventWindowTag is a trivially copyable, standard-layout 8-byte value, so it can be copied with memcpy, stored
+/// in arrays and passed through lock-free queues.
 /// </summary>
 class DTC_EventWindowTag
 {
@@ -18,117 +24,112 @@ public:
 	/// <summary>
 	/// Default Constructor. Initializes Event Window Tag to value 0
 	/// </summary>
-	DTC_EventWindowTag();
+	constexpr DTC_EventWindowTag()
+		: event_tag_(0) {}
 	/// <summary>
 	/// Construct a Event Window Tag using the given quad word
 	/// </summary>
 	/// <param name="event_tag">64-bit unsigned integer representing Event Window Tag. Top 16 bits will be discarded</param>
-	explicit DTC_EventWindowTag(const uint64_t event_tag);
+	constexpr explicit DTC_EventWindowTag(const uint64_t event_tag)
+		: event_tag_(event_tag & 0x0000FFFFFFFFFFFF) {}
 	/// <summary>
 	/// Construct a Event Window Tag using the given low and high words
 	/// </summary>
 	/// <param name="event_tag_low">Lower 32 bits of Event Window Tag</param>
 	/// <param name="event_tag_high">Upper 16 bits of Event Window Tag</param>
-	DTC_EventWindowTag(const uint32_t event_tag_low, const uint16_t event_tag_high);
+	constexpr DTC_EventWindowTag(const uint32_t event_tag_low, const uint16_t event_tag_high)
+		: event_tag_((static_cast<uint64_t>(event_tag_high) << 32) + event_tag_low) {}
 	/// <summary>
 	/// Construct a DTC_EventWindowTag using the given byte array. Length of the array must be greater than 6 + offset!
 	/// </summary>
 	/// <param name="timeArr">Byte array to read event_tag from (i.e. DTC_DataPacket::GetData())</param>
 	/// <param name="offset">Location of event_tag byte 0 in array (Default 0)</param>
-	explicit DTC_EventWindowTag(const uint8_t* timeArr, int offset = 0);
+	constexpr explicit DTC_EventWindowTag(const uint8_t* timeArr, int offset = 0)
+		: event_tag_(ExtractBits<0, 48>(timeArr + offset)) {}
 	/// <summary>
 	/// Construct a DTC_EventWindowTag using a std::bitset of the 48-bit event_tag
 	/// </summary>
 	/// <param name="event_tag">std::bitset containing event_tag</param>
-	explicit DTC_EventWindowTag(const std::bitset<48> event_tag);
-	/// <summary>
-	/// Default copy constructor
-	/// </summary>
-	/// <param name="r">DTC_EventWindowTag to copy</param>
-	DTC_EventWindowTag(const DTC_EventWindowTag& r) = default;
-	/// <summary>
-	/// Default move constructor
-	/// </summary>
-	/// <param name="r">DTC_EventWindowTag rvalue</param>
-	DTC_EventWindowTag(DTC_EventWindowTag&& r) = default;
+	explicit DTC_EventWindowTag(const std::bitset<48> event_tag)
+		: event_tag_(event_tag.to_ullong()) {}
 
 	/// <summary>
-	/// DTC_EventWindowTag Default Destructor
-	/// </summary>
-	virtual ~DTC_EventWindowTag() = default;
-	/// <summary>
-	/// Default move assignment operator
+	/// Compare two DTC_EventWindowTag instances
 	/// </summary>
-	/// <param name="r">DTC_EventWindowTag rvalue</param>
-	/// <returns>DTC_EventWindowTag reference</returns>
-	DTC_EventWindowTag& operator=(DTC_EventWindowTag&& r) = default;
+	/// <param name="r">Other event_tag</param>
+	/// <returns>Result of comparison</returns>
+	constexpr bool operator==(const DTC_EventWindowTag r) const { return r.event_tag_ == event_tag_; }
+
 	/// <summary>
-	/// Default copy assignment operator
+	/// Compare two DTC_EventWindowTag instances
 	/// </summary>
-	/// <param name="r">DTC_EventWindowTag to copy</param>
-	/// <returns>DTC_EventWindowTag reference</returns>
-	DTC_EventWindowTag& operator=(const DTC_EventWindowTag& r) = default;
+	/// <param name="r">Other event_tag</param>
+	/// <returns>Result of comparison</returns>
+	constexpr bool operator!=(const DTC_EventWindowTag r) const { return r.event_tag_ != event_tag_; }
 
 	/// <summary>
 	/// Compare two DTC_EventWindowTag instances
 	/// </summary>
 	/// <param name="r">Other event_tag</param>
 	/// <returns>Result of comparison</returns>
-	bool operator==(const DTC_EventWindowTag r) const { return r.GetEventWindowTag(true) == event_tag_; }
+	constexpr bool operator<(const DTC_EventWindowTag r) const { return event_tag_ < r.event_tag_; }
 
 	/// <summary>
 	/// Compare two DTC_EventWindowTag instances
 	/// </summary>
 	/// <param name="r">Other event_tag</param>
 	/// <returns>Result of comparison</returns>
-	bool operator!=(const DTC_EventWindowTag r) const { return r.GetEventWindowTag(true) != event_tag_; }
+	constexpr bool operator<=(const DTC_EventWindowTag r) const { return event_tag_ <= r.event_tag_; }
 
 	/// <summary>
 	/// Compare two DTC_EventWindowTag instances
 	/// </summary>
 	/// <param name="r">Other event_tag</param>
 	/// <returns>Result of comparison</returns>
-	bool operator<(const DTC_EventWindowTag r) { return r.GetEventWindowTag(true) > event_tag_; }
+	constexpr bool operator>(const DTC_EventWindowTag r) const { return event_tag_ > r.event_tag_; }
 
 	/// <summary>
 	/// Compare two DTC_EventWindowTag instances
 	/// </summary>
 	/// <param name="r">Other event_tag</param>
 	/// <returns>Result of comparison</returns>
-	bool operator<(const DTC_EventWindowTag r) const { return r.GetEventWindowTag(true) > event_tag_; }
+	constexpr bool operator>=(const DTC_EventWindowTag r) const { return event_tag_ >= r.event_tag_; }
 
 	/// <summary>
 	/// Add an integer to a event_tag instance
 	/// </summary>
 	/// <param name="r">Integer to add to event_tag</param>
 	/// <returns>New event_tag with result</returns>
-	DTC_EventWindowTag operator+(const int r) const { return DTC_EventWindowTag(r + event_tag_); }
+	constexpr DTC_EventWindowTag operator+(const int r) const { return DTC_EventWindowTag(r + event_tag_); }
 
 	/// <summary>
 	/// Set the Event Window Tag using the given quad word
 	/// </summary>
 	/// <param name="event_tag">64-bit unsigned integer representing event_tag. Top 16 bits will be discarded</param>
-	void SetEventWindowTag(uint64_t event_tag) { event_tag_ = event_tag & 0x0000FFFFFFFFFFFF; }
+	constexpr void SetEventWindowTag(uint64_t event_tag) { event_tag_ = event_tag & 0x0000FFFFFFFFFFFF; }
 
 	/// <summary>
 	/// Set the Event Window Tag using the given low and high words
 	/// </summary>
 	/// <param name="event_tag_low">Lower 32 bits of the Event Window Tag</param>
 	/// <param name="event_tag_high">Upper 16 bits of the timstamp</param>
-	void SetEventWindowTag(uint32_t event_tag_low, uint16_t event_tag_high);
+	constexpr void SetEventWindowTag(uint32_t event_tag_low, uint16_t event_tag_high)
+	{
+		event_tag_ = (static_cast<uint64_t>(event_tag_high) << 32) + event_tag_low;
+	}
 
 	/// <summary>
 	/// Returns the timstamp as a 48-bit std::bitset
 	/// </summary>
 	/// <returns>the Event Window Tag as a 48-bit std::bitset</returns>
-	std::bitset<48> GetEventWindowTag() const { return event_tag_; }
+	constexpr std::bitset<48> GetEventWindowTag() const { return event_tag_; }
 
 	/// <summary>
 	/// Returns the Event Window Tag as a 64-bit unsigned integer
 	/// </summary>
 	/// <param name="dummy">Whether to return a event_tag (used to distinguish signature)</param>
 	/// <returns>event_tag as a 64-bit unsigned integer</returns>
-	uint64_t GetEventWindowTag(bool dummy) const
+	constexpr uint64_t GetEventWindowTag(bool dummy) const
 	{
 		if (dummy)
 		{
@@ -160,8 +161,25 @@ public:
 	/// </summary>
 	/// <returns>String representing event_tag in "packet format"</returns>
 	std::string toPacketFormat() const;
+
+	/// <summary>
+	/// Append the JSON representation of the Event Window Tag to the given buffer (See toJSON())
+	/// </summary>
+	/// <param name="buf">Buffer to append to</param>
+	/// <param name="arrayMode">(Default: false) If true, will create a JSON array of the 6 bytes</param>
+	void AppendJSON(DTC_TextBuffer& buf, bool arrayMode = false) const;
+
+	/// <summary>
+	/// Append the "packet format" representation of the Event Window Tag to the given buffer (See toPacketFormat())
+	/// </summary>
+	/// <param name="buf">Buffer to append to</param>
+	void AppendPacketFormat(DTC_TextBuffer& buf) const;
 };
 
+static_assert(std::is_trivially_copyable_v<DTC_EventWindowTag> && std::is_standard_layout_v<DTC_EventWindowTag>,
+			  "DTC_EventWindowTag must stay a plain value type");
+static_assert(sizeof(DTC_EventWindowTag) == sizeof(uint64_t), "DTC_EventWindowTag must fit in a quad word");
+
 }  // namespace DTCLib
 
 #endif  // artdaq_core_mu2e_Overlays_DTC_Types_DTC_EventWindowTag_h
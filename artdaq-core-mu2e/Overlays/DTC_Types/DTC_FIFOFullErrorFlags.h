@@ -3,6 +3,7 @@
 
 #include <iomanip>
 #include <ostream>
+#include <type_traits>
 
 namespace DTCLib {
 
@@ -24,7 +25,7 @@ struct DTC_FIFOFullErrorFlags
 	/// <summary>
 	/// Default Constructor, sets all flags to false
 	/// </summary>
-	DTC_FIFOFullErrorFlags()
+	constexpr DTC_FIFOFullErrorFlags()
 		: OutputData(false), CFOLinkInput(false), ReadoutRequestOutput(false), DataRequestOutput(false), OtherOutput(false), OutputDCS(false), OutputDCSStage2(false), DataInput(false), DCSStatusInput(false) {}
 
 	/// <summary>
@@ -39,7 +40,7 @@ struct DTC_FIFOFullErrorFlags
 	/// <param name="outputDCS2">Output DCS Stage 2 FIFO Full</param>
 	/// <param name="dataInput">Data Input FIFO Full</param>
 	/// <param name="dcsInput">DCS Status Input FIFO Full</param>
-	DTC_FIFOFullErrorFlags(bool outputData, bool cfoLinkInput, bool readoutRequest, bool dataRequest, bool otherOutput,
+	constexpr DTC_FIFOFullErrorFlags(bool outputData, bool cfoLinkInput, bool readoutRequest, bool dataRequest, bool otherOutput,
 						   bool outputDCS, bool outputDCS2, bool dataInput, bool dcsInput)
 		: OutputData(outputData), CFOLinkInput(cfoLinkInput), ReadoutRequestOutput(readoutRequest), DataRequestOutput(dataRequest), OtherOutput(otherOutput), OutputDCS(outputDCS), OutputDCSStage2(outputDCS2), DataInput(dataInput), DCSStatusInput(dcsInput) {}
 
@@ -64,6 +65,9 @@ struct DTC_FIFOFullErrorFlags
 	}
 };
 
+static_assert(std::is_trivially_copyable_v<DTC_FIFOFullErrorFlags> && std::is_standard_layout_v<DTC_FIFOFullErrorFlags>,
+			  "DTC_FIFOFullErrorFlags must stay a plain value type");
+
 }  // namespace DTCLib
 
 #endif  // artdaq_core_mu2e_Overlays_DTC_Types_DTC_FIFOFullErrorFlags_h
@@ -3,6 +3,7 @@
 
 #include <iomanip>
 #include <ostream>
+#include <type_traits>
 
 namespace DTCLib {
 
@@ -17,7 +18,7 @@ struct DTC_LinkEnableMode
 	/// <summary>
 	/// Default constructor. Sets all enable bits to true.
 	/// </summary>
-	DTC_LinkEnableMode()
+	constexpr DTC_LinkEnableMode()
 		: TransmitEnable(true), ReceiveEnable(true) {}
 
 	/// <summary>
@@ -26,7 +27,7 @@ struct DTC_LinkEnableMode
 	/// <param name="transmit">Enable TX</param>
 	/// <param name="receive">Enable RX</param>
 	/// <param name="timing">Enable CFO</param>
-	DTC_LinkEnableMode(bool transmit, bool receive)
+	constexpr DTC_LinkEnableMode(bool transmit, bool receive)
 		: TransmitEnable(transmit), ReceiveEnable(receive) {}
 
 	/// <summary>
@@ -52,7 +53,7 @@ struct DTC_LinkEnableMode
 	/// <param name="left">LHS of compare</param>
 	/// <param name="right">RHS of compare</param>
 	/// <returns>Whether all three bits of both sides are equal</returns>
-	friend bool operator==(const DTC_LinkEnableMode& left, const DTC_LinkEnableMode& right)
+	friend constexpr bool operator==(const DTC_LinkEnableMode& left, const DTC_LinkEnableMode& right)
 	{
 		return left.TransmitEnable == right.TransmitEnable && left.ReceiveEnable == right.ReceiveEnable;
 	}
@@ -63,9 +64,12 @@ struct DTC_LinkEnableMode
 	/// <param name="left">LHS of compare</param>
 	/// <param name="right">RHS of compare</param>
 	/// <returns>!(left == right)</returns>
-	friend bool operator!=(const DTC_LinkEnableMode& left, const DTC_LinkEnableMode& right) { return !(left == right); }
+	friend constexpr bool operator!=(const DTC_LinkEnableMode& left, const DTC_LinkEnableMode& right) { return !(left == right); }
 };
 
+static_assert(std::is_trivially_copyable_v<DTC_LinkEnableMode> && std::is_standard_layout_v<DTC_LinkEnableMode>,
+			  "DTC_LinkEnableMode must stay a plain value type");
+
 }  // namespace DTCLib
 
 #endif  // artdaq_core_mu2e_Overlays_DTC_Types_DTC_LinkEnableMode_h
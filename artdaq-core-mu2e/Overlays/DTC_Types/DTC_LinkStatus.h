@@ -3,6 +3,7 @@
 
 #include <bitset>
 #include <cstdint>
+#include <type_traits>
 
 namespace DTCLib {
 
@@ -22,15 +23,19 @@ struct DTC_LinkStatus
 		kFatalError = 6,
 		kInvalid
 	};
-	DTC_LinkStatus()
+	constexpr DTC_LinkStatus()
 		: error(false), flags(0) {}
-	DTC_LinkStatus(uint8_t word)
-	{
-		error = (word & 0x80) != 0;
-		flags = std::bitset<7>(word);
-	}
+	constexpr DTC_LinkStatus(uint8_t word)
+		: error((word & 0x80) != 0), flags(word) {}
+
+	// std::bitset comparison is not constexpr before C++20
+	friend bool operator==(const DTC_LinkStatus& left, const DTC_LinkStatus& right) { return left.error == right.error && left.flags == right.flags; }
+	friend bool operator!=(const DTC_LinkStatus& left, const DTC_LinkStatus& right) { return !(left == right); }
 };
 
+static_assert(std::is_trivially_copyable_v<DTC_LinkStatus> && std::is_standard_layout_v<DTC_LinkStatus>,
+			  "DTC_LinkStatus must stay a plain value type");
+
 }  // namespace DTCLib
 
 #endif  // artdaq_core_mu2e_Overlays_DTC_Types_DTC_LinkStatus_h
@@ -0,0 +1,176 @@
+#ifndef artdaq_core_mu2e_Overlays_DTC_Types_DTC_TextBuffer_h
+#define artdaq_core_mu2e_Overlays_DTC_Types_DTC_TextBuffer_h
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+namespace DTCLib {
+
+/// <summary>
+/// Append-only text buffer used to format packets and headers without going through iostreams.
+/// Integers are written with std::to_chars (decimal) or a precomputed byte-to-hex table (lowercase hex),
+/// optionally left-padded to a minimum width, which reproduces the output of std::dec/std::hex with
+/// std::setw and std::setfill. Clear() keeps the allocated storage, so one buffer can be reused for
+/// many packets.
+/// </summary>
+class DTC_TextBuffer
+{
+public:
+	/// <summary>
+	/// Construct a DTC_TextBuffer
+	/// </summary>
+	/// <param name="capacity">Number of characters to reserve (Default: 1024)</param>
+	explicit DTC_TextBuffer(size_t capacity = 1024) { buf_.reserve(capacity); }
+
+	/// <summary>
+	/// Append a null-terminated string
+	/// </summary>
+	/// <param name="str">String to append</param>
+	/// <returns>Reference to this buffer</returns>
+	DTC_TextBuffer& Append(const char* str) { return Append(str, strlen(str)); }
+	/// <summary>
+	/// Append len characters
+	/// </summary>
+	/// <param name="str">Characters to append</param>
+	/// <param name="len">Number of characters</param>
+	/// <returns>Reference to this buffer</returns>
+	DTC_TextBuffer& Append(const char* str, size_t len)
+	{
+		buf_.append(str, len);
+		return *this;
+	}
+	/// <summary>
+	/// Append a string
+	/// </summary>
+	/// <param name="str">String to append</param>
+	/// <returns>Reference to this buffer</returns>
+	DTC_TextBuffer& Append(std::string const& str) { return Append(str.data(), str.size()); }
+	/// <summary>
+	/// Append the contents of another DTC_TextBuffer
+	/// </summary>
+	/// <param name="other">Buffer to append</param>
+	/// <returns>Reference to this buffer</returns>
+	DTC_TextBuffer& Append(DTC_TextBuffer const& other) { return Append(other.data(), other.size()); }
+	/// <summary>
+	/// Append a single character, optionally left-padded
+	/// </summary>
+	/// <param name="c">Character to append</param>
+	/// <param name="width">Minimum field width (Default: 0)</param>
+	/// <param name="fill">Padding character (Default: '0')</param>
+	/// <returns>Reference to this buffer</returns>
+	DTC_TextBuffer& Append(char c, int width = 0, char fill = '0')
+	{
+		Pad(width, 1, fill);
+		buf_.push_back(c);
+		return *this;
+	}
+
+	/// <summary>
+	/// Append an unsigned integer in decimal
+	/// </summary>
+	/// <param name="value">Value to append</param>
+	/// <param name="width">Minimum field width (Default: 0)</param>
+	/// <param name="fill">Padding character (Default: '0')</param>
+	/// <returns>Reference to this buffer</returns>
+	DTC_TextBuffer& Dec(uint64_t value, int width = 0, char fill = '0')
+	{
+		char tmp[20];
+		auto res = std::to_chars(tmp, tmp + sizeof(tmp), value);
+		Pad(width, res.ptr - tmp, fill);
+		return Append(tmp, res.ptr - tmp);
+	}
+
+	/// <summary>
+	/// Append an unsigned integer in lowercase hexadecimal, without prefix
+	/// </summary>
+	/// <param name="value">Value to append</param>
+	/// <param name="width">Minimum field width (Default: 0)</param>
+	/// <param name="fill">Padding character (Default: '0')</param>
+	/// <returns>Reference to this buffer</returns>
+	DTC_TextBuffer& Hex(uint64_t value, int width = 0, char fill = '0');
+
+	/// <summary>
+	/// Discard the contents of the buffer, keeping its storage
+	/// </summary>
+	void Clear() { buf_.clear(); }
+	/// <summary>
+	/// Discard everything after the first size characters, keeping the storage. Used to roll back partial output.
+	/// </summary>
+	/// <param name="size">Number of characters to keep</param>
+	void Truncate(size_t size)
+	{
+		if (size < buf_.size()) buf_.resize(size);
+	}
+
+	/// <summary>
+	/// Number of characters in the buffer
+	/// </summary>
+	/// <returns>Size of the buffer contents</returns>
+	size_t size() const { return buf_.size(); }
+	/// <summary>
+	/// Pointer to the buffer contents. Not null-terminated.
+	/// </summary>
+	/// <returns>Pointer to the first character</returns>
+	const char* data() const { return buf_.data(); }
+	/// <summary>
+	/// Access the buffer contents as a string
+	/// </summary>
+	/// <returns>Reference to the underlying string</returns>
+	std::string const& str() const { return buf_; }
+
+	/// <summary>
+	/// Write the contents of a DTC_TextBuffer to a stream
+	/// </summary>
+	/// <param name="stream">Stream to write</param>
+	/// <param name="buf">DTC_TextBuffer to write</param>
+	/// <returns>Stream reference for continued streaming</returns>
+	friend std::ostream& operator<<(std::ostream& stream, const DTC_TextBuffer& buf)
+	{
+		return stream.write(buf.data(), buf.size());
+	}
+
+private:
+	static constexpr std::array<char, 512> MakeHexTable()
+	{
+		std::array<char, 512> table{};
+		const char digits[] = "0123456789abcdef";
+		for (size_t ii = 0; ii < 256; ++ii)
+		{
+			table[ii * 2] = digits[ii >> 4];
+			table[ii * 2 + 1] = digits[ii & 0xF];
+		}
+		return table;
+	}
+
+	void Pad(int width, ptrdiff_t len, char fill)
+	{
+		if (width > len) buf_.append(width - len, fill);
+	}
+
+	std::string buf_;
+};
+
+inline DTC_TextBuffer& DTC_TextBuffer::Hex(uint64_t value, int width, char fill)
+{
+	static constexpr auto table = MakeHexTable();
+	char tmp[16];
+	auto end = tmp + sizeof(tmp);
+	auto ptr = end;
+	do
+	{
+		ptr -= 2;
+		memcpy(ptr, &table[(value & 0xFF) * 2], 2);
+		value >>= 8;
+	} while (value != 0);
+	if (*ptr == '0' && ptr + 1 != end) ++ptr;
+	Pad(width, end - ptr, fill);
+	return Append(ptr, end - ptr);
+}
+
+}  // namespace DTCLib
+
+#endif  // artdaq_core_mu2e_Overlays_DTC_Types_DTC_TextBuffer_h
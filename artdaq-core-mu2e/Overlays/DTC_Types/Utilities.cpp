@@ -1,5 +1,8 @@
 #include "artdaq-core-mu2e/Overlays/DTC_Types/Utilities.h"
 
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_BitExtract.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_TextBuffer.h"
+
 #include "TRACE/tracemf.h"
 
 #include <cmath>
@@ -149,22 +152,28 @@ std::pair<double, std::string> DTCLib::Utilities::FormatTime(double seconds)
 	return std::make_pair(val, unit);
 }
 
+static void AppendBufferLine(DTCLib::DTC_TextBuffer& buf, const void* ptr, size_t sz, unsigned line)
+{
+	buf.Append("0x").Hex(line, 5).Append("0: ");
+	for (unsigned byte = 0; byte < 8; ++byte)
+	{
+		if (line * 16 + 2 * byte < sz)
+		{
+			auto thisWord = DTCLib::LoadLE<uint16_t>(static_cast<const uint8_t*>(ptr) + 2 * (line * 8 + byte));
+			buf.Hex(thisWord, 4).Append(' ');
+		}
+	}
+}
+
 void DTCLib::Utilities::PrintBuffer(const void* ptr, size_t sz, size_t quietCount, int tlvl)
 {
 	auto maxLine = static_cast<unsigned>(ceil((sz) / 16.0));
+	DTC_TextBuffer buf(64);
 	for (unsigned line = 0; line < maxLine; ++line)
 	{
-		std::stringstream ostr;
-		ostr << "0x" << std::hex << std::setw(5) << std::setfill('0') << line << "0: ";
-		for (unsigned byte = 0; byte < 8; ++byte)
-		{
-			if (line * 16 + 2 * byte < sz)
-			{
-				auto thisWord = reinterpret_cast<const uint16_t*>(ptr)[line * 8 + byte];
-				ostr << std::setw(4) << static_cast<int>(thisWord) << " ";
-			}
-		}
-		TLOG(tlvl) << ostr.str();
+		buf.Clear();
+		AppendBufferLine(buf, ptr, sz, line);
+		TLOG(tlvl) << buf.str();
 		if (quietCount > 0 && maxLine > quietCount * 2 && line == (quietCount - 1))
 		{
 			line = static_cast<unsigned>(ceil((sz) / 16.0)) - (1 + quietCount);
@@ -172,6 +181,17 @@ void DTCLib::Utilities::PrintBuffer(const void* ptr, size_t sz, size_t quietCoun
 	}
 }
 
+void DTCLib::Utilities::AppendBuffer(DTC_TextBuffer& buf, const void* ptr, size_t sz, const char* indent)
+{
+	auto maxLine = static_cast<unsigned>((sz + 15) / 16);
+	for (unsigned line = 0; line < maxLine; ++line)
+	{
+		buf.Append(indent);
+		AppendBufferLine(buf, ptr, sz, line);
+		buf.Append('\n');
+	}
+}
+
 unsigned DTCLib::Utilities::getOptionValue(int* index, char** argv[])
 {
 	auto arg = (*argv)[*index];
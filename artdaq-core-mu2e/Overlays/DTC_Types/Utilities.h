@@ -7,6 +7,8 @@
 
 namespace DTCLib {
 
+class DTC_TextBuffer;
+
 /// <summary>
 /// Several useful data manipulation utilities
 /// </summary>
@@ -49,6 +51,14 @@ struct Utilities
 	/// <param name="quietCount">Number of lines to print at the begin/end. Default is 0, which prints entire buffer</param>
 	/// <param name="tlvl">TLVL to use for printing (Default 2, or TLVL_INFO)</param>
 	static void PrintBuffer(const void* ptr, size_t sz, size_t quietCount = 0, int tlvl = 2 /*TLVL_INFO*/);
+	/// <summary>
+	/// Append the buffer in the same format as PrintBuffer to a DTC_TextBuffer, one newline-terminated line per 16 bytes
+	/// </summary>
+	/// <param name="buf">DTC_TextBuffer to append to</param>
+	/// <param name="ptr">Pointer to the buffer</param>
+	/// <param name="sz">Size of the buffer</param>
+	/// <param name="indent">String to place at the start of each line (Default: none)</param>
+	static void AppendBuffer(DTC_TextBuffer& buf, const void* ptr, size_t sz, const char* indent = "");
 
 	static unsigned getOptionValue(int* index, char** argv[]);
 	static unsigned long long getOptionValueLong(int* index, char** argv[]);
@@ -0,0 +1,745 @@
+// mu2eDTCEventDump: Read DTC_Events from DMA-framed event files (as written by DTC_Event::WriteEvent) or from raw
+// fragment dumps (back-to-back DTC_Events), select them by Event Window Tag, DTC ID, subsystem and link, and print
+// them as hexdump, decoded packets or decoded hits.
+//
+// The main thread only reads and frames events; formatting is done by a pool of worker threads on batches of events,
+// and a writer thread emits the formatted batches in input order, so the output is identical for any thread count.
+
+#include "artdaq-core-mu2e/Data/CRVDataDecoder.hh"
+#include "artdaq-core-mu2e/Data/CalorimeterDataDecoder.hh"
+#include "artdaq-core-mu2e/Data/TrackerDataDecoder.hh"
+
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_DataPacket.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Packets/DTC_Event.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Types/DTC_TextBuffer.h"
+#include "artdaq-core-mu2e/Overlays/DTC_Types/Utilities.h"
+
+#include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+enum class InputFormat
+{
+	Auto,
+	DMA,               ///< DMA Size word before each buffer
+	DMAWithWriteSize,  ///< DMA Write Size and DMA Size words before each buffer (Detector Emulator files)
+	Raw,               ///< DTC_Events back-to-back, no DMA framing
+};
+
+enum class OutputMode
+{
+	Hex,
+	Packets,
+	Hits,
+};
+
+const size_t BATCH_BYTES = 4 * 1024 * 1024;
+const size_t READ_BUFFER_BYTES = 16 * 1024 * 1024;
+
+struct DumpOptions
+{
+	std::vector<std::string> files;
+	std::string outputFile;
+	InputFormat format{InputFormat::Auto};
+	OutputMode mode{OutputMode::Packets};
+	uint64_t ewtMin{0};
+	uint64_t ewtMax{std::numeric_limits<uint64_t>::max()};
+	std::bitset<256> dtcs;  // None set: accept all
+	uint16_t subsystems{0};  // Bit mask, 0: accept all
+	uint8_t links{0};        // Bit mask, 0: accept all
+	size_t threads{std::max(1u, std::thread::hardware_concurrency())};
+	size_t batchSize{256};
+
+	bool AcceptDTC(uint8_t id) const { return dtcs.none() || dtcs.test(id); }
+	bool AcceptSubsystem(DTCLib::DTC_Subsystem subsystem) const { return subsystems == 0 || (subsystems & (1 << (subsystem & 0xF))); }
+	bool AcceptLink(DTCLib::DTC_Link_ID link) const { return links == 0 || (links & (1 << (link & 0x7))); }
+	bool FiltersSubEvents() const { return dtcs.any() || subsystems != 0 || links != 0; }
+};
+
+struct EventBatch
+{
+	size_t sequence{0};
+	std::vector<uint8_t> data;
+	std::vector<size_t> offsets;  // Start of each DTC_Event in data
+};
+
+/// <summary>
+/// Reads one file and hands out complete DTC_Events, reassembling events that WriteEvent split across DMA buffers.
+/// Events outside of the Event Window Tag range are dropped here, before they are copied into a batch.
+/// </summary>
+class EventReader
+{
+public:
+	EventReader(std::string const& fileName, DumpOptions const& opts)
+		: streamBuffer_(READ_BUFFER_BYTES), fileName_(fileName), format_(opts.format), ewtMin_(opts.ewtMin), ewtMax_(opts.ewtMax)
+	{
+		file_.rdbuf()->pubsetbuf(streamBuffer_.data(), streamBuffer_.size());
+		file_.open(fileName, std::ios::in | std::ios::binary);
+		if (file_.is_open() && format_ == InputFormat::Auto) format_ = DetectFormat();
+	}
+
+	bool IsOpen() const { return file_.is_open(); }
+	InputFormat GetFormat() const { return format_; }
+	uint64_t EventsRead() const { return eventsRead_; }
+	uint64_t EventsSkipped() const { return eventsSkipped_; }
+
+	/// Append the next DTC_Event in the Event Window Tag range to data. Returns false at the end of the file.
+	bool ReadEvent(std::vector<uint8_t>& data)
+	{
+		while (true)
+		{
+			auto start = data.size();
+			auto ok = format_ == InputFormat::Raw ? ReadRaw(data) : ReadDMA(data);
+			if (!ok) return false;
+			++eventsRead_;
+
+			// ReadRaw skips out-of-range events without reading them and leaves data untouched
+			if (data.size() == start) continue;
+			if (InRange(&data[start])) return true;
+			data.resize(start);
+			++eventsSkipped_;
+		}
+	}
+
+private:
+	InputFormat DetectFormat()
+	{
+		uint64_t words[3] = {0, 0, 0};
+		file_.read(reinterpret_cast<char*>(words), sizeof(words));
+		auto got = static_cast<size_t>(file_.gcount());
+		file_.clear();
+		file_.seekg(0);
+		if (got < sizeof(words)) return InputFormat::Raw;
+
+		const uint64_t minBuffer = sizeof(uint64_t) + sizeof(DTCLib::DTC_EventHeader);
+		if (words[0] == words[1] + sizeof(uint64_t) && words[1] >= minBuffer) return InputFormat::DMAWithWriteSize;
+		// The first buffer of an event holds at most the whole event, whose size is in the first word of the DTC_EventHeader
+		if (words[0] >= minBuffer && words[0] <= static_cast<uint64_t>(DTCLib::DTC_Event::MAX_DMA_SIZE) && (words[1] & 0xFFFFFF) >= words[0] - sizeof(uint64_t)) return InputFormat::DMA;
+		return InputFormat::Raw;
+	}
+
+	bool InRange(const uint8_t* ptr) const
+	{
+		DTCLib::DTC_EventHeader header;
+		memcpy(&header, ptr, sizeof(header));
+		auto ewt = static_cast<uint64_t>(header.event_tag_low) + (static_cast<uint64_t>(header.event_tag_high) << 32);
+		return ewt >= ewtMin_ && ewt <= ewtMax_;
+	}
+
+	bool Read(void* ptr, size_t size)
+	{
+		file_.read(static_cast<char*>(ptr), size);
+		return static_cast<size_t>(file_.gcount()) == size;
+	}
+
+	bool ReadRaw(std::vector<uint8_t>& data)
+	{
+		DTCLib::DTC_EventHeader header;
+		if (!Read(&header, sizeof(header))) return false;
+		size_t eventSize = header.inclusive_event_byte_count;
+		if (eventSize < sizeof(header))
+		{
+			std::cerr << fileName_ << ": invalid DTC_EventHeader byte count " << eventSize << " at offset " << (static_cast<size_t>(file_.tellg()) - sizeof(header)) << ", stopping" << std::endl;
+			return false;
+		}
+
+		auto ewt = static_cast<uint64_t>(header.event_tag_low) + (static_cast<uint64_t>(header.event_tag_high) << 32);
+		if (ewt < ewtMin_ || ewt > ewtMax_)
+		{
+			file_.seekg(eventSize - sizeof(header), std::ios::cur);
+			++eventsSkipped_;
+			return file_.good();
+		}
+
+		auto start = data.size();
+		data.resize(start + eventSize);
+		memcpy(&data[start], &header, sizeof(header));
+		if (!Read(data.data() + start + sizeof(header), eventSize - sizeof(header)))
+		{
+			std::cerr << fileName_ << ": truncated event at end of file" << std::endl;
+			data.resize(start);
+			return false;
+		}
+		return true;
+	}
+
+	// Append the payload of one DMA buffer to data
+	bool ReadDMABuffer(std::vector<uint8_t>& data)
+	{
+		uint64_t dmaSize = 0;
+		if (format_ == InputFormat::DMAWithWriteSize && !Read(&dmaSize, sizeof(dmaSize))) return false;
+		if (!Read(&dmaSize, sizeof(dmaSize))) return false;
+		if (dmaSize < sizeof(uint64_t))
+		{
+			std::cerr << fileName_ << ": invalid DMA size " << dmaSize << ", stopping" << std::endl;
+			return false;
+		}
+
+		auto payload = dmaSize - sizeof(uint64_t);
+		auto start = data.size();
+		data.resize(start + payload);
+		if (!Read(data.data() + start, payload))
+		{
+			data.resize(start);
+			return false;
+		}
+		return true;
+	}
+
+	bool ReadDMA(std::vector<uint8_t>& data)
+	{
+		auto start = data.size();
+		if (!ReadDMABuffer(data)) return false;
+		if (data.size() - start < sizeof(DTCLib::DTC_EventHeader))
+		{
+			std::cerr << fileName_ << ": DMA buffer of " << (data.size() - start) << " bytes is too small for a DTC_EventHeader, stopping" << std::endl;
+			data.resize(start);
+			return false;
+		}
+
+		DTCLib::DTC_EventHeader header;
+		memcpy(&header, &data[start], sizeof(header));
+		size_t eventSize = header.inclusive_event_byte_count;
+		while (data.size() - start < eventSize)
+		{
+			if (!ReadDMABuffer(data))
+			{
+				std::cerr << fileName_ << ": truncated event at end of file" << std::endl;
+				data.resize(start);
+				return false;
+			}
+		}
+		data.resize(start + eventSize);
+		return true;
+	}
+
+	std::vector<char> streamBuffer_;
+	std::ifstream file_;
+	std::string fileName_;
+	InputFormat format_;
+	uint64_t ewtMin_;
+	uint64_t ewtMax_;
+	uint64_t eventsRead_{0};
+	uint64_t eventsSkipped_{0};
+};
+
+/// <summary>
+/// Formats the selected parts of DTC_Events into a DTC_TextBuffer. One instance per worker thread.
+/// </summary>
+class EventFormatter
+{
+public:
+	explicit EventFormatter(DumpOptions const& opts)
+		: opts_(opts) {}
+
+	/// Returns true if anything in the event passed the filters
+	bool Format(const uint8_t* ptr, DTCLib::DTC_TextBuffer& out)
+	{
+		auto eventStart = out.size();
+		DTCLib::DTC_Event evt(ptr);
+		evt.SetupEvent();
+
+		out.Append("Event ").Dec(evt.GetEventWindowTag().GetEventWindowTag(true));
+		out.Append(" (").Dec(evt.GetEventByteCount()).Append(" bytes, ").Dec(evt.GetSubEventCount()).Append(" sub-events)\n");
+		if (opts_.mode == OutputMode::Hex)
+		{
+			DTCLib::Utilities::AppendBuffer(out, ptr, sizeof(DTCLib::DTC_EventHeader), "  ");
+		}
+		else if (opts_.mode == OutputMode::Packets)
+		{
+			evt.GetHeader()->AppendJson(out);
+			out.Append('\n');
+		}
+
+		auto matched = !opts_.FiltersSubEvents();
+		for (auto& subEvt : evt.GetSubEvents())
+		{
+			if (!opts_.AcceptDTC(subEvt.GetDTCID()) || !opts_.AcceptSubsystem(subEvt.GetSubsystem())) continue;
+			matched |= FormatSubEvent(subEvt, out);
+		}
+
+		if (!matched) out.Truncate(eventStart);
+		return matched;
+	}
+
+private:
+	bool FormatSubEvent(DTCLib::DTC_SubEvent const& subEvt, DTCLib::DTC_TextBuffer& out)
+	{
+		auto subEventStart = out.size();
+		out.Append("  DTC ").Dec(subEvt.GetDTCID()).Append(" subsystem ").Dec(subEvt.GetSubsystem());
+		out.Append(" (").Dec(subEvt.GetSubEventByteCount()).Append(" bytes, ").Dec(subEvt.GetDataBlockCount()).Append(" data blocks)\n");
+		if (opts_.mode == OutputMode::Hex)
+		{
+			DTCLib::Utilities::AppendBuffer(out, subEvt.GetHeader(), sizeof(DTCLib::DTC_SubEventHeader), "    ");
+		}
+		else if (opts_.mode == OutputMode::Packets)
+		{
+			subEvt.GetHeader()->AppendJson(out);
+			out.Append('\n');
+		}
+
+		std::vector<size_t> blocks;
+		auto& dataBlocks = subEvt.GetDataBlocks();
+		for (size_t ii = 0; ii < dataBlocks.size(); ++ii)
+		{
+			if (dataBlocks[ii].byteSize < 16 || !opts_.AcceptLink(dataBlocks[ii].GetHeader()->GetLinkID())) continue;
+			blocks.push_back(ii);
+		}
+		if (blocks.empty() && opts_.links != 0)
+		{
+			out.Truncate(subEventStart);
+			return false;
+		}
+
+		if (opts_.mode == OutputMode::Hits)
+		{
+			FormatHits(subEvt, blocks, out);
+			return true;
+		}
+
+		for (auto ii : blocks)
+		{
+			auto& blk = dataBlocks[ii];
+			auto hdr = blk.GetHeader();
+			out.Append("    Link ").Dec(hdr->GetLinkID()).Append(" (").Dec(blk.byteSize).Append(" bytes, ").Dec(hdr->GetPacketCount()).Append(" packets)\n");
+			if (opts_.mode == OutputMode::Hex)
+			{
+				DTCLib::Utilities::AppendBuffer(out, blk.blockPointer, blk.byteSize, "      ");
+				continue;
+			}
+
+			hdr->AppendJSON(out);
+			out.Append('\n');
+			auto ptr = static_cast<const uint8_t*>(blk.blockPointer);
+			for (size_t offset = 16; offset + 16 <= blk.byteSize; offset += 16)
+			{
+				out.Append("    ");
+				DTCLib::DTC_DataPacket(ptr + offset).AppendJSON(out);
+				out.Append('\n');
+			}
+		}
+		return true;
+	}
+
+	static void AppendSigned(DTCLib::DTC_TextBuffer& out, int64_t value)
+	{
+		if (value < 0)
+		{
+			out.Append('-');
+			out.Dec(static_cast<uint64_t>(-value));
+			return;
+		}
+		out.Dec(static_cast<uint64_t>(value));
+	}
+
+	template<typename T>
+	static void AppendWaveform(DTCLib::DTC_TextBuffer& out, std::vector<T> const& waveform)
+	{
+		out.Append(" adc=[");
+		for (size_t ii = 0; ii < waveform.size(); ++ii)
+		{
+			if (ii > 0) out.Append(',');
+			out.Dec(waveform[ii]);
+		}
+		out.Append(']');
+	}
+
+	void FormatHits(DTCLib::DTC_SubEvent const& subEvt, std::vector<size_t> const& blocks, DTCLib::DTC_TextBuffer& out)
+	{
+		if (blocks.empty()) return;
+		auto& dataBlocks = subEvt.GetDataBlocks();
+
+		switch (subEvt.GetSubsystem())
+		{
+			case DTCLib::DTC_Subsystem_Tracker: {
+				mu2e::TrackerDataDecoder decoder(subEvt);
+				for (auto ii : blocks)
+				{
+					auto hits = decoder.GetTrackerData(ii);
+					out.Append("    Link ").Dec(dataBlocks[ii].GetHeader()->GetLinkID()).Append(": ").Dec(hits.size()).Append(" tracker hits\n");
+					for (auto& hit : hits)
+					{
+						out.Append("      straw=").Dec(hit.first->StrawIndex).Append(" tdc0=").Dec(hit.first->TDC0()).Append(" tdc1=").Dec(hit.first->TDC1());
+						out.Append(" tot0=").Dec(hit.first->TOT0).Append(" tot1=").Dec(hit.first->TOT1).Append(" pmp=").Dec(hit.first->PMP);
+						AppendWaveform(out, hit.second);
+						out.Append('\n');
+					}
+				}
+			}
+			break;
+			case DTCLib::DTC_Subsystem_Calorimeter: {
+				mu2e::CalorimeterDataDecoder decoder(subEvt);
+				for (auto ii : blocks)
+				{
+					std::unique_ptr<std::vector<std::pair<mu2e::CalorimeterDataDecoder::CalorimeterHitDataPacket, std::vector<uint16_t>>>> hits(decoder.GetCalorimeterHitData(ii));
+					out.Append("    Link ").Dec(dataBlocks[ii].GetHeader()->GetLinkID()).Append(": ").Dec(hits->size()).Append(" calorimeter hits\n");
+					for (auto& hit : *hits)
+					{
+						out.Append("      board=").Dec(hit.first.BoardID).Append(" channel=").Dec(hit.first.ChannelNumber).Append(" time=").Dec(hit.first.Time);
+						out.Append(" samples=").Dec(hit.first.NumberOfSamples).Append(" max=").Dec(hit.first.IndexOfMaxDigitizerSample);
+						AppendWaveform(out, hit.second);
+						out.Append('\n');
+					}
+				}
+			}
+			break;
+			case DTCLib::DTC_Subsystem_CRV: {
+				mu2e::CRVDataDecoder decoder(subEvt);
+				for (auto ii : blocks)
+				{
+					auto hits = decoder.GetCRVHits(ii);
+					out.Append("    Link ").Dec(dataBlocks[ii].GetHeader()->GetLinkID()).Append(": ").Dec(hits.size()).Append(" CRV hits\n");
+					for (auto& hit : hits)
+					{
+						out.Append("      controller=").Dec(hit.first.controllerNumber).Append(" port=").Dec(hit.first.portNumber);
+						out.Append(" channel=").Dec(hit.first.febChannel).Append(" time=").Dec(hit.first.HitTime).Append(" adc=[");
+						for (size_t jj = 0; jj < hit.second.size(); ++jj)
+						{
+							if (jj > 0) out.Append(',');
+							AppendSigned(out, hit.second[jj].ADC);
+						}
+						out.Append("]\n");
+					}
+				}
+			}
+			break;
+			default:
+				out.Append("    No hit decoder for subsystem ").Dec(subEvt.GetSubsystem()).Append('\n');
+				break;
+		}
+	}
+
+	DumpOptions const& opts_;
+};
+
+/// <summary>
+/// Worker pool which formats EventBatches and writes the results in submission order
+/// </summary>
+class DumpPipeline
+{
+public:
+	DumpPipeline(DumpOptions const& opts, std::ostream& output)
+		: opts_(opts), output_(output), maxInFlight_(4 * opts.threads)
+	{
+		for (size_t ii = 0; ii < opts.threads; ++ii)
+		{
+			workers_.emplace_back(&DumpPipeline::WorkerLoop, this);
+		}
+		writer_ = std::thread(&DumpPipeline::WriterLoop, this);
+	}
+
+	/// Queue a batch for formatting. Blocks while too many batches are waiting to be written.
+	void Submit(EventBatch&& batch)
+	{
+		std::unique_lock<std::mutex> lk(mutex_);
+		spaceAvailable_.wait(lk, [&] { return nextSequence_ - nextToWrite_ < maxInFlight_; });
+		batch.sequence = nextSequence_++;
+		work_.push_back(std::move(batch));
+		workAvailable_.notify_one();
+	}
+
+	/// Wait for all submitted batches to be written
+	void Finish()
+	{
+		{
+			std::unique_lock<std::mutex> lk(mutex_);
+			done_ = true;
+		}
+		workAvailable_.notify_all();
+		for (auto& worker : workers_) worker.join();
+		resultAvailable_.notify_all();
+		writer_.join();
+		output_.flush();
+	}
+
+	uint64_t EventsSelected() const { return eventsSelected_; }
+	uint64_t EventErrors() const { return eventErrors_; }
+
+private:
+	void WorkerLoop()
+	{
+		EventFormatter formatter(opts_);
+		while (true)
+		{
+			EventBatch batch;
+			{
+				std::unique_lock<std::mutex> lk(mutex_);
+				workAvailable_.wait(lk, [&] { return !work_.empty() || done_; });
+				if (work_.empty()) return;
+				batch = std::move(work_.front());
+				work_.pop_front();
+			}
+
+			DTCLib::DTC_TextBuffer out(opts_.mode == OutputMode::Hits ? batch.data.size() : 4 * batch.data.size());
+			uint64_t selected = 0;
+			uint64_t errors = 0;
+			for (auto offset : batch.offsets)
+			{
+				auto eventStart = out.size();
+				try
+				{
+					if (formatter.Format(&batch.data[offset], out)) ++selected;
+				}
+				catch (std::exception const& ex)
+				{
+					out.Truncate(eventStart);
+					out.Append("Error formatting event at batch offset ").Dec(offset).Append(": ").Append(ex.what()).Append('\n');
+					++errors;
+				}
+			}
+
+			std::unique_lock<std::mutex> lk(mutex_);
+			eventsSelected_ += selected;
+			eventErrors_ += errors;
+			results_.emplace(batch.sequence, std::move(out));
+			resultAvailable_.notify_one();
+		}
+	}
+
+	void WriterLoop()
+	{
+		while (true)
+		{
+			DTCLib::DTC_TextBuffer out(0);
+			{
+				std::unique_lock<std::mutex> lk(mutex_);
+				resultAvailable_.wait(lk, [&] { return results_.count(nextToWrite_) || (done_ && nextToWrite_ == nextSequence_); });
+				auto it = results_.find(nextToWrite_);
+				if (it == results_.end()) return;
+				out = std::move(it->second);
+				results_.erase(it);
+			}
+
+			output_ << out;
+
+			std::unique_lock<std::mutex> lk(mutex_);
+			++nextToWrite_;
+			spaceAvailable_.notify_all();
+		}
+	}
+
+	DumpOptions const& opts_;
+	std::ostream& output_;
+	size_t maxInFlight_;
+
+	std::mutex mutex_;
+	std::condition_variable workAvailable_;
+	std::condition_variable resultAvailable_;
+	std::condition_variable spaceAvailable_;
+	std::deque<EventBatch> work_;
+	std::map<size_t, DTCLib::DTC_TextBuffer> results_;
+	size_t nextSequence_{0};
+	size_t nextToWrite_{0};
+	bool done_{false};
+	uint64_t eventsSelected_{0};
+	uint64_t eventErrors_{0};
+
+	std::vector<std::thread> workers_;
+	std::thread writer_;
+};
+
+void printHelpMsg()
+{
+	std::cout << "Usage: mu2eDTCEventDump [options] file..." << std::endl;
+	std::cout << "Read DTC_Events from DMA-framed event files or raw fragment dumps, and print the selected data." << std::endl;
+	std::cout << "Options are:" << std::endl
+			  << "    -f: Input format: auto, dma, dmaw (DMA Write Size and DMA Size words, as written for the Detector Emulator) or raw (Default: auto)" << std::endl
+			  << "    -m: Output mode: hex, packets or hits (Default: packets)" << std::endl
+			  << "    -e: Event Window Tag range, first[:last] (Default: all)" << std::endl
+			  << "    -d: Select DTC ID. May be given more than once (Default: all)" << std::endl
+			  << "    -s: Select subsystem (0: Tracker, 1: Calorimeter, 2: CRV, ...). May be given more than once (Default: all)" << std::endl
+			  << "    -l: Select link (0-5). May be given more than once (Default: all)" << std::endl
+			  << "    -j: Number of formatting threads (Default: number of cores)" << std::endl
+			  << "    -b: Maximum number of events per batch (Default: 256)" << std::endl
+			  << "    -o: Write output to this file instead of stdout" << std::endl
+			  << "    -h: This message." << std::endl;
+}
+
+bool ParseFormat(std::string const& str, InputFormat& format)
+{
+	if (str == "auto") format = InputFormat::Auto;
+	else if (str == "dma") format = InputFormat::DMA;
+	else if (str == "dmaw") format = InputFormat::DMAWithWriteSize;
+	else if (str == "raw") format = InputFormat::Raw;
+	else return false;
+	return true;
+}
+
+bool ParseMode(std::string const& str, OutputMode& mode)
+{
+	if (str == "hex") mode = OutputMode::Hex;
+	else if (str == "packets") mode = OutputMode::Packets;
+	else if (str == "hits") mode = OutputMode::Hits;
+	else return false;
+	return true;
+}
+
+void ParseEWTRange(std::string const& str, DumpOptions& opts)
+{
+	char* end = nullptr;
+	opts.ewtMin = strtoull(str.c_str(), &end, 0);
+	opts.ewtMax = *end == ':' ? strtoull(end + 1, nullptr, 0) : opts.ewtMin;
+}
+
+const char* FormatName(InputFormat format)
+{
+	switch (format)
+	{
+		case InputFormat::DMA:
+			return "dma";
+		case InputFormat::DMAWithWriteSize:
+			return "dmaw";
+		case InputFormat::Raw:
+			return "raw";
+		default:
+			return "auto";
+	}
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+	DumpOptions opts;
+
+	for (auto optind = 1; optind < argc; ++optind)
+	{
+		if (argv[optind][0] == '-')
+		{
+			switch (argv[optind][1])
+			{
+				case 'f':
+					if (!ParseFormat(DTCLib::Utilities::getOptionString(&optind, &argv), opts.format))
+					{
+						std::cerr << "Unknown input format " << argv[optind] << std::endl;
+						return 1;
+					}
+					break;
+				case 'm':
+					if (!ParseMode(DTCLib::Utilities::getOptionString(&optind, &argv), opts.mode))
+					{
+						std::cerr << "Unknown output mode " << argv[optind] << std::endl;
+						return 1;
+					}
+					break;
+				case 'e':
+					ParseEWTRange(DTCLib::Utilities::getOptionString(&optind, &argv), opts);
+					break;
+				case 'd':
+					opts.dtcs.set(DTCLib::Utilities::getOptionValue(&optind, &argv) & 0xFF);
+					break;
+				case 's':
+					opts.subsystems |= 1 << (DTCLib::Utilities::getOptionValue(&optind, &argv) & 0xF);
+					break;
+				case 'l':
+					opts.links |= 1 << (DTCLib::Utilities::getOptionValue(&optind, &argv) & 0x7);
+					break;
+				case 'j':
+					opts.threads = std::max(1u, DTCLib::Utilities::getOptionValue(&optind, &argv));
+					break;
+				case 'b':
+					opts.batchSize = std::max(1u, DTCLib::Utilities::getOptionValue(&optind, &argv));
+					break;
+				case 'o':
+					opts.outputFile = DTCLib::Utilities::getOptionString(&optind, &argv);
+					break;
+				case 'h':
+					printHelpMsg();
+					return 0;
+				default:
+					std::cout << "Unknown option: " << argv[optind] << std::endl;
+					printHelpMsg();
+					return 1;
+			}
+		}
+		else
+		{
+			opts.files.push_back(argv[optind]);
+		}
+	}
+
+	if (opts.files.empty())
+	{
+		printHelpMsg();
+		return 1;
+	}
+
+	std::ios::sync_with_stdio(false);
+	std::ofstream outputFile;
+	if (!opts.outputFile.empty())
+	{
+		outputFile.open(opts.outputFile, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!outputFile.is_open())
+		{
+			std::cerr << "Cannot open output file " << opts.outputFile << std::endl;
+			return 1;
+		}
+	}
+	std::ostream& output = opts.outputFile.empty() ? std::cout : outputFile;
+
+	auto startTime = std::chrono::steady_clock::now();
+	auto status = 0;
+	uint64_t eventsRead = 0;
+	uint64_t eventsSkipped = 0;
+	uint64_t bytesSubmitted = 0;
+
+	DumpPipeline pipeline(opts, output);
+	for (auto& fileName : opts.files)
+	{
+		EventReader reader(fileName, opts);
+		if (!reader.IsOpen())
+		{
+			std::cerr << "Cannot open input file " << fileName << std::endl;
+			status = 1;
+			continue;
+		}
+		std::cerr << "Reading " << fileName << " (format " << FormatName(reader.GetFormat()) << ")" << std::endl;
+
+		EventBatch batch;
+		batch.data.reserve(2 * BATCH_BYTES);
+		while (true)
+		{
+			auto offset = batch.data.size();
+			if (!reader.ReadEvent(batch.data)) break;
+			batch.offsets.push_back(offset);
+			if (batch.offsets.size() >= opts.batchSize || batch.data.size() >= BATCH_BYTES)
+			{
+				bytesSubmitted += batch.data.size();
+				pipeline.Submit(std::move(batch));
+				batch = EventBatch();
+				batch.data.reserve(2 * BATCH_BYTES);
+			}
+		}
+		if (!batch.offsets.empty())
+		{
+			bytesSubmitted += batch.data.size();
+			pipeline.Submit(std::move(batch));
+		}
+		eventsRead += reader.EventsRead();
+		eventsSkipped += reader.EventsSkipped();
+	}
+	pipeline.Finish();
+
+	auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	std::cerr << "Read " << eventsRead << " events, " << eventsSkipped << " outside of Event Window Tag range, "
+			  << pipeline.EventsSelected() << " selected, " << pipeline.EventErrors() << " could not be decoded" << std::endl;
+	std::cerr << "Formatted " << DTCLib::Utilities::FormatByteString(static_cast<double>(bytesSubmitted), "")
+			  << " in " << DTCLib::Utilities::FormatTimeString(seconds) << " ("
+			  << DTCLib::Utilities::FormatByteString(seconds > 0 ? bytesSubmitted / seconds : 0, "/s") << ")" << std::endl;
+
+	if (pipeline.EventErrors() > 0) status = 1;
+	return status;
+}